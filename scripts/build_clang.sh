@@ -3,7 +3,7 @@
 mkdir -p build
 
 arguments="-I."
-libraries="-lm -lSDL2"
+libraries="-lm -lpthread -lSDL2"
 errors="-Werror -Wall -Wextra -pedantic"
 exclude_errors="-Wno-unused-parameter -Wno-unused-variable -Wno-unused-function -Wno-unused-but-set-variable -Wno-extra-semi -Wno-gnu-zero-variadic-macro-arguments -Wno-initializer-overrides"
 
@@ -156,18 +156,43 @@
 #if COMPILER_CL
 #  include <string.h>
 #  define memory_zero(destination, count)         memset((destination), 0, (count))
+#  define memory_set(destination, value, count)   memset((destination), (value), (count))
 #  define memory_zero_struct(structure)           memory_zero(structure, sizeof(*structure));
 #  define memory_move(destination, source, count) memmove((destination), (source), (count))
 #  define memory_copy(destination, source, count) memcpy((destination), (source), (count))
 #  define memory_equal(a, b, count)               (memcmp((a), (b), (count)) == 0)
 #else
 #  define memory_zero(destination, count)         __builtin_memset((destination), 0, (count))
+#  define memory_set(destination, value, count)   __builtin_memset((destination), (value), (count))
 #  define memory_zero_struct(structure)           memory_zero(structure, sizeof(*structure));
 #  define memory_move(destination, source, count) __builtin_memmove((destination), (source), (count))
 #  define memory_copy(destination, source, count) __builtin_memcpy((destination), (source), (count))
 #  define memory_equal(a, b, count)               (__builtin_memcmp((a), (b), (count)) == 0)
 #endif
 
+// NOTE(simon): All atomic operations are sequentially consistent. `add`
+// returns the new value and `compare_exchange` returns the old value.
+#if COMPILER_CL
+#  include <intrin.h>
+#  define atomic_u32_load(pointer)                              ((U32) _InterlockedOr((volatile long *) (pointer), 0))
+#  define atomic_u32_store(pointer, value)                      ((Void) _InterlockedExchange((volatile long *) (pointer), (long) (value)))
+#  define atomic_u32_add(pointer, value)                        ((U32) _InterlockedExchangeAdd((volatile long *) (pointer), (long) (value)) + (U32) (value))
+#  define atomic_u32_compare_exchange(pointer, expected, value) ((U32) _InterlockedCompareExchange((volatile long *) (pointer), (long) (value), (long) (expected)))
+#  define atomic_u64_load(pointer)                              ((U64) _InterlockedOr64((volatile __int64 *) (pointer), 0))
+#  define atomic_u64_store(pointer, value)                      ((Void) _InterlockedExchange64((volatile __int64 *) (pointer), (__int64) (value)))
+#  define atomic_u64_add(pointer, value)                        ((U64) _InterlockedExchangeAdd64((volatile __int64 *) (pointer), (__int64) (value)) + (U64) (value))
+#  define atomic_u64_compare_exchange(pointer, expected, value) ((U64) _InterlockedCompareExchange64((volatile __int64 *) (pointer), (__int64) (value), (__int64) (expected)))
+#else
+#  define atomic_u32_load(pointer)                              __atomic_load_n((pointer), __ATOMIC_SEQ_CST)
+#  define atomic_u32_store(pointer, value)                      __atomic_store_n((pointer), (value), __ATOMIC_SEQ_CST)
+#  define atomic_u32_add(pointer, value)                        __atomic_add_fetch((pointer), (value), __ATOMIC_SEQ_CST)
+#  define atomic_u32_compare_exchange(pointer, expected, value) __sync_val_compare_and_swap((pointer), (expected), (value))
+#  define atomic_u64_load(pointer)                              __atomic_load_n((pointer), __ATOMIC_SEQ_CST)
+#  define atomic_u64_store(pointer, value)                      __atomic_store_n((pointer), (value), __ATOMIC_SEQ_CST)
+#  define atomic_u64_add(pointer, value)                        __atomic_add_fetch((pointer), (value), __ATOMIC_SEQ_CST)
+#  define atomic_u64_compare_exchange(pointer, expected, value) __sync_val_compare_and_swap((pointer), (expected), (value))
+#endif
+
 #define dll_insert_next_previous(first, last, p, n, next, previous)                                                      \
     ((first) == 0 ? (((first) = (last) = (n)), (n)->next = (n)->previous = 0) :                                          \
     (p) == 0 ? ((n)->previous = 0, (n)->next = (first), ((first) == 0 ? 0 : ((first)->previous = (n))), (first) = (n)) : \
@@ -6,3 +6,5 @@
 #include "hash.c"
 #include "error.c"
 #include "os_include.c"
+#include "thread_pool.c"
+#include "cache.c"
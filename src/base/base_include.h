@@ -10,5 +10,7 @@
 #include "hash.h"
 #include "error.h"
 #include "os_include.h"
+#include "thread_pool.h"
+#include "cache.h"
 
 #endif // BASE_INCLUDE_H
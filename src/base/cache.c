@@ -0,0 +1,116 @@
+internal Cache *cache_create(Arena *arena, U32 capacity) {
+    U32 shard_capacity = u32_max(capacity / CACHE_SHARD_COUNT, 16);
+    shard_capacity = 1u << (32 - u32_leading_zeros(shard_capacity - 1));
+
+    Cache *cache = arena_push_struct_zero(arena, Cache);
+    for (U32 i = 0; i < CACHE_SHARD_COUNT; ++i) {
+        Cache_Shard *shard = &cache->shards[i];
+        shard->capacity = shard_capacity;
+        shard->slots    = arena_push_array_zero(arena, Cache_Slot, shard_capacity);
+    }
+
+    return cache;
+}
+
+// NOTE(simon): Returns the slot holding key, or the empty slot ending its
+// probe sequence. Keys are written before their slot leaves the empty state
+// and never change afterwards, so this is safe to call without the lock.
+// Without the lock an empty slot can be claimed for another key at any
+// moment, so callers have to go by the state observed here rather than
+// reading it again.
+internal Cache_Slot *cache_shard_find(Cache_Shard *shard, U64 hash, U64 key, U32 *observed_state) {
+    U32 mask  = shard->capacity - 1;
+    U32 index = (U32) hash & mask;
+
+    for (;;) {
+        Cache_Slot *slot = &shard->slots[index];
+        U32 state = atomic_u32_load(&slot->state);
+        if (state == Cache_SlotState_Empty || slot->key == key) {
+            *observed_state = state;
+            return slot;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+internal Void *cache_slot_wait(Cache_Slot *slot) {
+    while (atomic_u32_load(&slot->state) != Cache_SlotState_Ready) {
+        os_thread_yield();
+    }
+
+    return slot->value;
+}
+
+// NOTE(simon): Takes the value of a slot that was found holding the key,
+// unless it is still in flight and the caller doesn't want to wait for it.
+internal B32 cache_slot_take(Cache_Slot *slot, U32 state, B32 wait, Void **result) {
+    B32 taken = state == Cache_SlotState_Ready || (state == Cache_SlotState_InFlight && wait);
+    if (taken) {
+        *result = cache_slot_wait(slot);
+    }
+
+    return taken;
+}
+
+internal B32 cache_lookup(Cache *cache, U64 key, Void **result) {
+    U64 hash = u64_hash(key);
+    Cache_Shard *shard = &cache->shards[(hash >> 60) % CACHE_SHARD_COUNT];
+
+    U32 state = Cache_SlotState_Empty;
+    Cache_Slot *slot = cache_shard_find(shard, hash, key, &state);
+    B32 found = state != Cache_SlotState_Empty;
+    if (found) {
+        *result = cache_slot_wait(slot);
+    }
+
+    return found;
+}
+
+internal B32 cache_acquire_internal(Cache *cache, U64 key, Void **result, Cache_Ticket *ticket, B32 wait) {
+    U64 hash = u64_hash(key);
+    // NOTE(simon): Use the top bits for the shard and the bottom bits for the
+    // slot so the two are independent.
+    Cache_Shard *shard = &cache->shards[(hash >> 60) % CACHE_SHARD_COUNT];
+    ticket->slot = 0;
+
+    U32 state = Cache_SlotState_Empty;
+    Cache_Slot *slot = cache_shard_find(shard, hash, key, &state);
+    if (state != Cache_SlotState_Empty) {
+        return cache_slot_take(slot, state, wait, result);
+    }
+
+    while (atomic_u32_compare_exchange(&shard->lock, 0, 1) != 0) {
+        os_thread_yield();
+    }
+
+    // NOTE(simon): Someone might have inserted the key while we were waiting
+    // for the lock, so search again now that the shard can't change.
+    slot = cache_shard_find(shard, hash, key, &state);
+    B32 found = state != Cache_SlotState_Empty;
+    if (!found && 4 * (shard->count + 1) <= 3 * shard->capacity) {
+        slot->key = key;
+        slot->value = 0;
+        atomic_u32_store(&slot->state, Cache_SlotState_InFlight);
+        ++shard->count;
+        ticket->slot = slot;
+    }
+
+    atomic_u32_store(&shard->lock, 0);
+
+    return found && cache_slot_take(slot, state, wait, result);
+}
+
+internal B32 cache_acquire(Cache *cache, U64 key, Void **result, Cache_Ticket *ticket) {
+    return cache_acquire_internal(cache, key, result, ticket, true);
+}
+
+internal B32 cache_try_acquire(Cache *cache, U64 key, Void **result, Cache_Ticket *ticket) {
+    return cache_acquire_internal(cache, key, result, ticket, false);
+}
+
+internal Void cache_publish(Cache_Ticket ticket, Void *value) {
+    if (ticket.slot) {
+        ticket.slot->value = value;
+        atomic_u32_store(&ticket.slot->state, Cache_SlotState_Ready);
+    }
+}
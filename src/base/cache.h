@@ -0,0 +1,64 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+// NOTE(simon): A fixed capacity open-addressing hash table that can be shared
+// between threads. Lookups never take a lock. Insertions lock only the shard
+// that the key hashes into, and a key is inserted in the in-flight state so
+// that every other thread asking for the same key waits for the first one to
+// produce the value instead of producing it again. Values are never removed,
+// and the memory they point to is owned by the caller.
+
+#define CACHE_SHARD_COUNT 16
+
+typedef enum {
+    Cache_SlotState_Empty,
+    Cache_SlotState_InFlight,
+    Cache_SlotState_Ready,
+} Cache_SlotState;
+
+typedef struct {
+    U32  state;
+    U64  key;
+    Void *value;
+} Cache_Slot;
+
+typedef struct {
+    U32         lock;
+    U32         count;
+    U32         capacity;
+    Cache_Slot *slots;
+} Cache_Shard;
+
+typedef struct {
+    Cache_Shard shards[CACHE_SHARD_COUNT];
+} Cache;
+
+// NOTE(simon): Returned by cache_acquire when the caller has to produce the
+// value. Pass it to cache_publish once the value is done, even if producing
+// it failed, as other threads might be waiting on it. The slot is null when
+// the shard is full, in which case the value won't be cached.
+typedef struct {
+    Cache_Slot *slot;
+} Cache_Ticket;
+
+// NOTE(simon): The capacity is rounded up to a power of 2 per shard. Shards
+// only accept new keys while they are less than 3/4 full to keep probe
+// sequences short.
+internal Cache *cache_create(Arena *arena, U32 capacity);
+
+// NOTE(simon): Both return true and store the value in result if the key is
+// present, waiting for it if it is still in flight. Otherwise cache_lookup
+// leaves the cache untouched, while cache_acquire inserts the key and the
+// caller has to produce the value and hand it to cache_publish with the
+// ticket.
+internal B32  cache_lookup(Cache *cache, U64 key, Void **result);
+internal B32  cache_acquire(Cache *cache, U64 key, Void **result, Cache_Ticket *ticket);
+internal Void cache_publish(Cache_Ticket ticket, Void *value);
+
+// NOTE(simon): Same as cache_acquire, but never waits. A key that is still in
+// flight is treated like a full shard: nothing is returned and the ticket is
+// empty, so the caller produces the value without caching it. Use this when
+// the caller might itself be holding a ticket the other producer waits on.
+internal B32  cache_try_acquire(Cache *cache, U64 key, Void **result, Cache_Ticket *ticket);
+
+#endif // CACHE_H
@@ -12,6 +12,11 @@ internal U64 s64_hash(S64 x) {
     return result;
 }
 
+internal U64 u64_hash_combine(U64 seed, U64 value) {
+    U64 result = u64_hash(seed ^ (value + 0x9E3779B97F4A7C15UL + (seed << 6) + (seed >> 2)));
+    return result;
+}
+
 // TODO: SipHash
 internal U64 str8_hash(Str8 string) {
     U64 hash = 0;
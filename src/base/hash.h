@@ -4,6 +4,9 @@
 internal U64 u64_hash(U64 x);
 internal U64 s64_hash(S64 x);
 
+// NOTE(simon): Folds value into seed, for building keys out of several fields.
+internal U64 u64_hash_combine(U64 seed, U64 value);
+
 internal U64 str8_hash(Str8 string);
 
 #endif // HASH_H
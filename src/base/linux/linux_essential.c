@@ -2,7 +2,10 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <pthread.h>
 #include <pwd.h>
+#include <sched.h>
+#include <semaphore.h>
 #include <stdio.h>
 #include <time.h>
 #include <unistd.h>
@@ -15,6 +18,9 @@
 
 global Arena *linux_permanent_arena;
 global Str8List linux_argument_list;
+global pthread_mutex_t linux_permanent_arena_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static_assert(sizeof(sem_t) <= sizeof(OS_Semaphore));
 
 internal DateTime linux_date_time_from_tm_and_milliseconds(struct tm *time, U16 milliseconds) {
     DateTime result = { 0 };
@@ -156,6 +162,44 @@ internal B32 os_file_write(Str8 file_name, Str8List data) {
     return result;
 }
 
+internal B32 os_file_open_for_writing(Str8 file_name, OS_File *result) {
+    Arena_Temporary scratch = arena_get_scratch(0, 0);
+    CStr file_name_c = cstr_from_str8(scratch.arena, file_name);
+    S32 file_descriptor = creat(file_name_c, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    arena_end_temporary(scratch);
+
+    B32 success = file_descriptor != -1;
+    if (success) {
+        result->u64[0] = (U64) file_descriptor;
+    }
+
+    return success;
+}
+
+internal B32 os_file_write_block(OS_File file, Void *data, U64 size) {
+    S32 file_descriptor = (S32) file.u64[0];
+    U8 *ptr = (U8 *) data;
+    U8 *opl = (U8 *) data + size;
+
+    B32 success = true;
+    while (ptr < opl) {
+        U64 to_write = u64_min((U64) (opl - ptr), SSIZE_MAX);
+        S64 actual_write = write(file_descriptor, ptr, to_write);
+        if (actual_write == -1) {
+            success = false;
+            break;
+        }
+
+        ptr += actual_write;
+    }
+
+    return success;
+}
+
+internal Void os_file_close(OS_File file) {
+    close((S32) file.u64[0]);
+}
+
 internal FileProperties os_file_properties(Str8 file_name) {
     FileProperties result = { 0 };
 
@@ -480,6 +524,68 @@ internal Void os_get_entropy(Void *data, U64 size) {
     }
 }
 
+internal Void *linux_thread_entry(Void *start) {
+    Linux_ThreadStart *thread_start = (Linux_ThreadStart *) start;
+
+    arena_init_scratch();
+    thread_start->function(thread_start->data);
+    arena_destroy_scratch();
+
+    return 0;
+}
+
+internal OS_Thread os_thread_create(OS_ThreadFunction *function, Void *data) {
+    OS_Thread result = { 0 };
+
+    pthread_mutex_lock(&linux_permanent_arena_mutex);
+    Linux_ThreadStart *start = arena_push_struct(linux_permanent_arena, Linux_ThreadStart);
+    pthread_mutex_unlock(&linux_permanent_arena_mutex);
+
+    start->function = function;
+    start->data     = data;
+
+    pthread_t thread = { 0 };
+    if (pthread_create(&thread, 0, linux_thread_entry, start) == 0) {
+        result.u64[0] = (U64) thread;
+    } else {
+        error_emit(str8_literal("Could not create thread."));
+    }
+
+    return result;
+}
+
+internal Void os_thread_join(OS_Thread thread) {
+    if (thread.u64[0]) {
+        pthread_join((pthread_t) thread.u64[0], 0);
+    }
+}
+
+internal Void os_thread_yield(Void) {
+    sched_yield();
+}
+
+internal U32 os_get_processor_count(Void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    U32 result = (count > 0 ? (U32) count : 1);
+    return result;
+}
+
+internal Void os_semaphore_create(OS_Semaphore *semaphore, U32 initial_count) {
+    sem_init((sem_t *) semaphore, 0, initial_count);
+}
+
+internal Void os_semaphore_destroy(OS_Semaphore *semaphore) {
+    sem_destroy((sem_t *) semaphore);
+}
+
+internal Void os_semaphore_signal(OS_Semaphore *semaphore) {
+    sem_post((sem_t *) semaphore);
+}
+
+internal Void os_semaphore_wait(OS_Semaphore *semaphore) {
+    while (sem_wait((sem_t *) semaphore) == -1 && errno == EINTR);
+}
+
 internal B32 os_console_run(Str8 program, Str8List arguments) {
     B32 success = false;
 
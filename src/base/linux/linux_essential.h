@@ -18,6 +18,11 @@ typedef packed_struct({
     char          name[];
 }) Linux_DirentHeader;
 
+typedef struct {
+    OS_ThreadFunction *function;
+    Void              *data;
+} Linux_ThreadStart;
+
 struct tm;
 internal DateTime  linux_date_time_from_tm_and_milliseconds(struct tm *time, U16 milliseconds);
 internal struct tm linux_tm_from_date_time(DateTime *date_time);
@@ -25,4 +30,6 @@ internal struct tm linux_tm_from_date_time(DateTime *date_time);
 struct stat;
 internal Void linux_file_properties_from_stat(FileProperties *properties, struct stat *metadata);
 
+internal Void *linux_thread_entry(Void *start);
+
 #endif // LINUX_ESSENTIAL_H
@@ -5,6 +5,20 @@ typedef struct {
     U8 data[512];
 } OS_FileIterator;
 
+typedef struct {
+    U64 u64[1];
+} OS_File;
+
+typedef struct {
+    U64 u64[1];
+} OS_Thread;
+
+typedef struct {
+    U64 u64[4];
+} OS_Semaphore;
+
+typedef Void OS_ThreadFunction(Void *data);
+
 typedef enum {
     OS_SYSTEM_PATH_CURRENT_DIRECTORY,
     OS_SYSTEM_PATH_BINARY,
@@ -21,6 +35,11 @@ internal Void  os_memory_release(Void *pointer, U64 size);
 internal B32 os_file_read(Arena *arena, Str8 file_name, Str8 *result);
 internal B32 os_file_write(Str8 file_name, Str8List data);
 
+// NOTE(simon): Streaming writes. The file is created or truncated.
+internal B32  os_file_open_for_writing(Str8 file_name, OS_File *result);
+internal B32  os_file_write_block(OS_File file, Void *data, U64 size);
+internal Void os_file_close(OS_File file);
+
 internal FileProperties os_file_properties(Str8 file_name);
 
 internal B32 os_file_delete(Str8 file_name);
@@ -45,6 +64,18 @@ internal Void os_sleep_milliseconds(U64 time);
 
 internal Void os_get_entropy(Void *data, U64 size);
 
+// NOTE(simon): Threads get their own scratch arenas for their lifetime. On
+// failure the returned thread is zeroed and an error is emitted.
+internal OS_Thread os_thread_create(OS_ThreadFunction *function, Void *data);
+internal Void      os_thread_join(OS_Thread thread);
+internal Void      os_thread_yield(Void);
+internal U32       os_get_processor_count(Void);
+
+internal Void os_semaphore_create(OS_Semaphore *semaphore, U32 initial_count);
+internal Void os_semaphore_destroy(OS_Semaphore *semaphore);
+internal Void os_semaphore_signal(OS_Semaphore *semaphore);
+internal Void os_semaphore_wait(OS_Semaphore *semaphore);
+
 internal B32  os_console_run(Str8 program, Str8List arguments);
 internal Void os_console_print(Str8 string);
 
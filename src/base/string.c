@@ -1,3 +1,5 @@
+#include <stdio.h>
+
 internal Str8 str8(U8 *data, U64 size) {
     Str8 result;
     result.data = data;
@@ -50,6 +52,34 @@ internal Str8 str8_copy_cstr(Arena *arena, U8 *data) {
     return result;
 }
 
+internal Str8 str8_format_list(Arena *arena, CStr format, va_list arguments) {
+    va_list size_arguments;
+    va_copy(size_arguments, arguments);
+    S32 size = vsnprintf(0, 0, format, size_arguments);
+    va_end(size_arguments);
+
+    Str8 result = { 0 };
+    if (size > 0) {
+        // NOTE(simon): vsnprintf always writes a null terminator, which we
+        // pop once it has been written.
+        result.data = arena_push_array(arena, U8, (U64) size + 1);
+        result.size = (U64) size;
+        vsnprintf((char *) result.data, (size_t) size + 1, format, arguments);
+        arena_pop_amount(arena, 1);
+    }
+
+    return result;
+}
+
+internal Str8 str8_format(Arena *arena, CStr format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    Str8 result = str8_format_list(arena, format, arguments);
+    va_end(arguments);
+
+    return result;
+}
+
 internal Str8 str8_prefix(Str8 string, U64 size) {
     U64 clamped_size = u64_min(size, string.size);
 
@@ -167,6 +197,63 @@ internal B32 str8_last_index_of(Str8 string, U32 codepoint, U64 *result_index) {
     return found;
 }
 
+internal B32 u64_from_str8(Str8 string, U64 *result) {
+    B32 success = string.size != 0;
+    U64 value   = 0;
+
+    for (U64 i = 0; success && i < string.size; ++i) {
+        U8 digit = string.data[i];
+        if ('0' <= digit && digit <= '9' && value <= (U64_MAX - (U64) (digit - '0')) / 10) {
+            value = value * 10 + (U64) (digit - '0');
+        } else {
+            success = false;
+        }
+    }
+
+    if (success) {
+        *result = value;
+    }
+
+    return success;
+}
+
+internal B32 f64_from_str8(Str8 string, F64 *result) {
+    F64 sign = 1.0;
+    if (string.size && (string.data[0] == '-' || string.data[0] == '+')) {
+        sign   = (string.data[0] == '-' ? -1.0 : 1.0);
+        string = str8_skip(string, 1);
+    }
+
+    B32 success     = string.size != 0;
+    B32 has_digits  = false;
+    B32 is_fraction = false;
+    F64 value       = 0.0;
+    F64 scale       = 1.0;
+
+    for (U64 i = 0; success && i < string.size; ++i) {
+        U8 digit = string.data[i];
+        if ('0' <= digit && digit <= '9') {
+            if (is_fraction) {
+                scale *= 0.1;
+                value += scale * (F64) (digit - '0');
+            } else {
+                value = value * 10.0 + (F64) (digit - '0');
+            }
+            has_digits = true;
+        } else if (digit == '.' && !is_fraction) {
+            is_fraction = true;
+        } else {
+            success = false;
+        }
+    }
+
+    if (success && has_digits) {
+        *result = sign * value;
+    }
+
+    return success && has_digits;
+}
+
 internal Void str8_list_push_explicit(Str8List *list, Str8 string, Str8Node *node) {
     node->string = string;
     dll_push_back(list->first, list->last, node);
@@ -200,7 +287,7 @@ internal Str8List str8_split_by_codepoints(Arena *arena, Str8 string, Str8 codep
     U8 *string_opl       = string.data + string.size;
 
     while (string_ptr < string_opl) {
-        StringDecode string_decode = string_decode_utf8(string_ptr, (U64) (string_ptr - string_opl));
+        StringDecode string_decode = string_decode_utf8(string_ptr, (U64) (string_opl - string_ptr));
 
         U8 *codepoint_ptr       = codepoints.data;
         U8 *codepoint_opl       = codepoints.data + codepoints.size;
@@ -219,6 +306,8 @@ internal Str8List str8_split_by_codepoints(Arena *arena, Str8 string, Str8 codep
         string_ptr += string_decode.size;
     }
 
+    str8_list_push(arena, &result, str8_range(last_split_point, string_opl));
+
     return result;
 }
 
@@ -237,13 +326,12 @@ internal StringDecode string_decode_utf8(U8 *string, U64 size) {
         3,                                              // 11110xxx: 3 bytes needed
         4,                                              // 11111xxx: Invalid
     };
-    local U8 masks[4]            = { 0x7F, 0x1F, 0x0F, 0x07, };
-    local U8 lower_boundaries[4] = { 0x80, 0x80, 0xA0, 0x90, };
-    local U8 upper_boundaries[4] = { 0xBF, 0xBF, 0x9F, 0x8F, };
+    local U8 masks[4] = { 0x7F, 0x1F, 0x0F, 0x07, };
 
     StringDecode result;
     result.codepoint = 0xFFFD;
     result.size      = 0;
+    result.is_valid  = false;
 
     if (size == 0) {
         return result;
@@ -257,9 +345,24 @@ internal StringDecode string_decode_utf8(U8 *string, U64 size) {
         return result;
     }
 
-    U8  lower_boundary = lower_boundaries[bytes_needed];
-    U8  upper_boundary = upper_boundaries[bytes_needed];
-    U32 codepoint      = byte & masks[bytes_needed];
+    // NOTE(simon): Only some lead bytes restrict their first continuation
+    // byte. This rejects overlong encodings, surrogates and codepoints above
+    // U+10FFFF.
+    U8 lower_boundary = 0x80;
+    U8 upper_boundary = 0xBF;
+    if (byte == 0xC0 || byte == 0xC1 || byte > 0xF4) {
+        return result;
+    } else if (byte == 0xE0) {
+        lower_boundary = 0xA0;
+    } else if (byte == 0xED) {
+        upper_boundary = 0x9F;
+    } else if (byte == 0xF0) {
+        lower_boundary = 0x90;
+    } else if (byte == 0xF4) {
+        upper_boundary = 0x8F;
+    }
+
+    U32 codepoint = byte & masks[bytes_needed];
 
     if (size < result.size + bytes_needed) {
         result.size = size;
@@ -281,6 +384,7 @@ internal StringDecode string_decode_utf8(U8 *string, U64 size) {
     }
 
     result.codepoint = codepoint;
+    result.is_valid  = true;
     return result;
 }
 
@@ -295,19 +399,19 @@ internal U64 string_encode_utf8(U8 *destination, U32 codepoint) {
         destination[1] = 0x80 | (codepoint & 0x3F);
         size = 2;
     } else if (codepoint <= 0xFFFF) {
-        destination[0] = 0xC0 | (codepoint >> 12);
+        destination[0] = 0xE0 | (codepoint >> 12);
         destination[1] = 0x80 | ((codepoint >> 6) & 0x3F);
         destination[2] = 0x80 | (codepoint & 0x3F);
         size = 3;
     } else if (codepoint <= 0x10FFFF) {
-        destination[0] = 0xC0 | (codepoint >> 18);
+        destination[0] = 0xF0 | (codepoint >> 18);
         destination[1] = 0x80 | ((codepoint >> 12) & 0x3F);
         destination[2] = 0x80 | ((codepoint >> 6) & 0x3F);
         destination[3] = 0x80 | (codepoint & 0x3F);
         size = 4;
     } else {
         U32 missing_codepoint = 0xFFFD;
-        destination[0] = 0xC0 | (missing_codepoint >> 12);
+        destination[0] = 0xE0 | (missing_codepoint >> 12);
         destination[1] = 0x80 | ((missing_codepoint >> 6) & 0x3F);
         destination[2] = 0x80 | (missing_codepoint & 0x3F);
         size = 3;
@@ -320,6 +424,7 @@ internal StringDecode string_decode_utf16(U16 *string, U64 size) {
     StringDecode result;
     result.codepoint = 0xFFFD;
     result.size = 0;
+    result.is_valid = false;
 
     if (size == 0) {
         return result;
@@ -330,12 +435,14 @@ internal StringDecode string_decode_utf16(U16 *string, U64 size) {
 
     if (code_unit < 0xD800 || 0xDFFF < code_unit) {
         result.codepoint = code_unit;
+        result.is_valid = true;
     } else if (size >= 2) {
         U16 lead_surrogate = code_unit;
         code_unit = *string++;
 
         if (0xD800 <= lead_surrogate && lead_surrogate <= 0xDBFF && 0xDC00 <= code_unit && code_unit <= 0xDFFF) {
             result.codepoint = 0x10000 + ((lead_surrogate - 0xD800) << 10) + (code_unit - 0xDC00);
+            result.is_valid = true;
             ++result.size;
         }
     }
@@ -1,6 +1,8 @@
 #ifndef STRING_H
 #define STRING_H
 
+#include <stdarg.h>
+
 typedef struct {
     U8 *data;
     U64 size;
@@ -30,9 +32,12 @@ typedef struct {
     U64 total_size;
 } Str8List;
 
+// NOTE(simon): Invalid sequences decode to U+FFFD with is_valid cleared,
+// while a correctly encoded U+FFFD sets it.
 typedef struct {
     U32 codepoint;
     U64 size;
+    B32 is_valid;
 } StringDecode;
 
 internal Str8 str8(U8 *data, U64 size);
@@ -40,6 +45,8 @@ internal Str8 str8_range(U8 *start, U8 *opl);
 internal Str8 str8_copy(Arena *arena, Str8 string);
 internal Str8 str8_cstr(CStr data);
 internal Str8 str8_copy_cstr(Arena *arena, U8 *data);
+internal Str8 str8_format_list(Arena *arena, CStr format, va_list arguments);
+internal Str8 str8_format(Arena *arena, CStr format, ...);
 
 #define str8_literal(literal) ((Str8) { .data = (U8 *) (literal), .size = sizeof(literal) - 1})
 #define str8_expand(string) (int) (string).size, (char *) (string).data
@@ -54,6 +61,14 @@ internal B32 str8_equal(Str8 a, Str8 b);
 internal B32 str8_first_index_of(Str8 string, U32 codepoint, U64 *result_index);
 internal B32 str8_last_index_of(Str8 string, U32 codepoint, U64 *result_index);
 
+// NOTE(simon): Parses the whole string as a decimal number. Fails on empty
+// strings, anything besides digits, and values that don't fit.
+internal B32 u64_from_str8(Str8 string, U64 *result);
+
+// NOTE(simon): Parses the whole string as a decimal number with an optional
+// sign and fraction, such as "-12.5". Exponents are not supported.
+internal B32 f64_from_str8(Str8 string, F64 *result);
+
 internal Void str8_list_push_explicit(Str8List *list, Str8 string, Str8Node *node);
 internal Void str8_list_push(Arena *arena, Str8List *list, Str8 string);
 internal Str8 str8_join(Arena *arena, Str8List *list);
@@ -0,0 +1,96 @@
+internal Void thread_pool_execute_tasks(ThreadPool *pool) {
+    for (;;) {
+        U32 task_index = atomic_u32_add(&pool->next_task, 1) - 1;
+        if (task_index >= pool->task_count) {
+            break;
+        }
+
+        pool->function(pool->data, task_index);
+    }
+}
+
+internal Void thread_pool_worker(Void *data) {
+    ThreadPool *pool = (ThreadPool *) data;
+
+    for (;;) {
+        os_semaphore_wait(&pool->work_semaphore);
+        if (!atomic_u32_load(&pool->running)) {
+            break;
+        }
+
+        thread_pool_execute_tasks(pool);
+
+        if (atomic_u32_add(&pool->workers_remaining, (U32) -1) == 0) {
+            os_semaphore_signal(&pool->done_semaphore);
+        }
+    }
+}
+
+internal ThreadPool *thread_pool_create(Arena *arena, U32 worker_count) {
+    if (worker_count == 0) {
+        worker_count = u32_max(1, os_get_processor_count()) - 1;
+    }
+
+    ThreadPool *pool = arena_push_struct_zero(arena, ThreadPool);
+    pool->threads = arena_push_array_zero(arena, OS_Thread, worker_count);
+    pool->running = true;
+    os_semaphore_create(&pool->work_semaphore, 0);
+    os_semaphore_create(&pool->done_semaphore, 0);
+
+    // NOTE(simon): Only count the workers that exist, as work handed to a
+    // missing one would never be signaled as done.
+    for (U32 i = 0; i < worker_count; ++i) {
+        OS_Thread thread = os_thread_create(thread_pool_worker, pool);
+        if (!thread.u64[0]) {
+            break;
+        }
+        pool->threads[pool->thread_count++] = thread;
+    }
+
+    return pool;
+}
+
+internal Void thread_pool_destroy(ThreadPool *pool) {
+    atomic_u32_store(&pool->running, false);
+    for (U32 i = 0; i < pool->thread_count; ++i) {
+        os_semaphore_signal(&pool->work_semaphore);
+    }
+    for (U32 i = 0; i < pool->thread_count; ++i) {
+        os_thread_join(pool->threads[i]);
+    }
+
+    os_semaphore_destroy(&pool->work_semaphore);
+    os_semaphore_destroy(&pool->done_semaphore);
+}
+
+internal Void thread_pool_run(ThreadPool *pool, ThreadPool_TaskFunction *function, Void *data, U32 task_count) {
+    B32 run_serially = !pool || pool->thread_count == 0 || task_count <= 1;
+    if (!run_serially) {
+        run_serially = atomic_u32_compare_exchange(&pool->is_busy, 0, 1) != 0;
+    }
+
+    if (run_serially) {
+        for (U32 i = 0; i < task_count; ++i) {
+            function(data, i);
+        }
+        return;
+    }
+
+    // NOTE(simon): Don't wake more workers than there is work for.
+    U32 worker_count = u32_min(pool->thread_count, task_count - 1);
+
+    pool->function   = function;
+    pool->data       = data;
+    pool->task_count = task_count;
+    atomic_u32_store(&pool->next_task, 0);
+    atomic_u32_store(&pool->workers_remaining, worker_count);
+
+    for (U32 i = 0; i < worker_count; ++i) {
+        os_semaphore_signal(&pool->work_semaphore);
+    }
+
+    thread_pool_execute_tasks(pool);
+    os_semaphore_wait(&pool->done_semaphore);
+
+    atomic_u32_store(&pool->is_busy, 0);
+}
@@ -0,0 +1,37 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+typedef Void ThreadPool_TaskFunction(Void *data, U32 task_index);
+
+typedef struct ThreadPool ThreadPool;
+struct ThreadPool {
+    OS_Thread   *threads;
+    U32          thread_count;
+    OS_Semaphore work_semaphore;
+    OS_Semaphore done_semaphore;
+    B32          running;
+
+    // NOTE(simon): State for the work currently being run. Only written while
+    // holding is_busy, and published to the workers by the semaphores.
+    ThreadPool_TaskFunction *function;
+    Void                    *data;
+    U32                      task_count;
+    U32                      next_task;
+    U32                      workers_remaining;
+    U32                      is_busy;
+};
+
+// NOTE(simon): A worker_count of 0 creates one worker per processor besides
+// the calling thread. If a worker can't be created, the pool keeps the ones
+// that were, and thread_count says how many that is.
+internal ThreadPool *thread_pool_create(Arena *arena, U32 worker_count);
+internal Void        thread_pool_destroy(ThreadPool *pool);
+
+// NOTE(simon): Runs function once for every task index in [0, task_count) and
+// returns when all of them have completed. The calling thread takes part in
+// the work. Calls made while the pool is busy, including nested calls from
+// within a task, run all tasks on the calling thread instead. A null pool is
+// allowed and runs everything on the calling thread.
+internal Void thread_pool_run(ThreadPool *pool, ThreadPool_TaskFunction *function, Void *data, U32 task_count);
+
+#endif // THREAD_POOL_H
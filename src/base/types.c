@@ -185,6 +185,22 @@ internal U32 u32_big_to_local_endian(U32 x) {
 #endif
 }
 
+internal U32 u32_leading_zeros(U32 x) {
+    if (x == 0) {
+        return 32;
+    }
+
+#if COMPILER_CL
+    unsigned long index = 0;
+    _BitScanReverse(&index, x);
+    return 31 - index;
+#elif COMPILER_CLANG || COMPILER_GCC
+    return (U32) __builtin_clz(x);
+#else
+# error Your compiler does not have an implementation of u32_leading_zeros.
+#endif
+}
+
 internal U64 u64_min(U64 a, U64 b) {
     U64 result = (a < b ? a : b);
     return result;
@@ -255,6 +271,19 @@ internal U64 u64_big_to_local_endian(U64 x) {
 #endif
 }
 
+internal U32 u64_pop_count(U64 x) {
+#if COMPILER_CLANG || COMPILER_GCC
+    return (U32) __builtin_popcountll(x);
+#else
+    // NOTE(simon): __popcnt64 requires the POPCNT instruction, so count the
+    // bits in parallel instead.
+    x = x - ((x >> 1) & 0x5555555555555555);
+    x = (x & 0x3333333333333333) + ((x >> 2) & 0x3333333333333333);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0F;
+    return (U32) ((x * 0x0101010101010101) >> 56);
+#endif
+}
+
 internal S8 s8_min(S8 a, S8 b) {
     S8 result = (a < b ? a : b);
     return result;
@@ -623,6 +652,77 @@ internal U32 f32_solve_cubic(F32 a, F32 b, F32 c, F32 d, F32 *result_xs) {
     return n;
 }
 
+// NOTE(simon): Rounds to nearest even, overflows to infinity and keeps NaNs.
+internal F16 f16_from_f32(F32 x) {
+    union { F32 f; U32 u; } value;
+    value.f = x;
+
+    U32 sign     = (value.u >> 16) & 0x8000;
+    U32 exponent = (value.u >> 23) & 0xFF;
+    U32 mantissa = value.u & 0x007FFFFF;
+    S32 half_exponent = (S32) exponent - 127 + 15;
+
+    U32 result = 0;
+    if (exponent == 0xFF) {
+        result = sign | 0x7C00 | (mantissa ? 0x0200 : 0);
+    } else if (half_exponent >= 0x1F) {
+        result = sign | 0x7C00;
+    } else if (half_exponent <= 0) {
+        if (half_exponent < -10) {
+            result = sign;
+        } else {
+            // NOTE(simon): Subnormal, shift in the implicit bit.
+            mantissa |= 0x00800000;
+            U32 shift     = (U32) (14 - half_exponent);
+            U32 remainder = mantissa & ((1u << shift) - 1);
+            U32 halfway   = 1u << (shift - 1);
+            result = mantissa >> shift;
+            if (remainder > halfway || (remainder == halfway && (result & 1))) {
+                ++result;
+            }
+            result |= sign;
+        }
+    } else {
+        // NOTE(simon): Rounding may carry into the exponent, which is what
+        // we want.
+        U32 remainder = mantissa & 0x1FFF;
+        result = ((U32) half_exponent << 10) | (mantissa >> 13);
+        if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1))) {
+            ++result;
+        }
+        result |= sign;
+    }
+
+    return (F16) result;
+}
+
+internal F32 f32_from_f16(F16 x) {
+    U32 sign     = (U32) (x & 0x8000) << 16;
+    U32 exponent = (x >> 10) & 0x1F;
+    U32 mantissa = x & 0x03FF;
+
+    union { F32 f; U32 u; } result;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            result.u = sign;
+        } else {
+            // NOTE(simon): Subnormal, normalize it.
+            U32 f32_exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x0400)) {
+                mantissa <<= 1;
+                --f32_exponent;
+            }
+            result.u = sign | f32_exponent << 23 | (mantissa & 0x03FF) << 13;
+        }
+    } else if (exponent == 0x1F) {
+        result.u = sign | 0x7F800000 | mantissa << 13;
+    } else {
+        result.u = sign | (exponent + 127 - 15) << 23 | mantissa << 13;
+    }
+
+    return result.f;
+}
+
 internal F64 f64_min(F64 a, F64 b) {
     F64 result = (a < b ? a : b);
     return result;
@@ -21,6 +21,10 @@ typedef U64 B64;
 typedef float  F32;
 typedef double F64;
 
+// NOTE(simon): Half precision floats are only used for storage, convert them
+// to F32 for any arithmetic.
+typedef U16 F16;
+
 typedef void Void;
 typedef char *CStr;
 typedef U16  *CStr16;
@@ -119,12 +123,14 @@ global F32 F32_EPSILON = 1.1920929e-7f;
 global F32 F32_PI      = 3.14159265359f;
 global F32 F32_TAU     = 6.28318530718f;
 global F32 F32_E       = 2.71828182846f;
+global F32 F32_SQRT2   = 1.41421356237f;
 global U32 F32_BIAS    = 127;
 
 global F64 F64_EPSILON = 2.220446e-16;
 global F64 F64_PI      = 3.14159265359;
 global F64 F64_TAU     = 6.28318530718;
 global F64 F64_E       = 2.71828182846;
+global F64 F64_SQRT2   = 1.41421356237;
 global U32 F64_BIAS    = 1023;
 
 #define false 0
@@ -161,6 +167,8 @@ internal U32 u32_rotate_left(U32 x, U32 amount);
 internal U32 u32_ceil_to_power_of_2(U32 x);
 internal U32 u32_reverse(U32 x);
 internal U32 u32_big_to_local_endian(U32 x);
+// NOTE(simon): Returns 32 for 0.
+internal U32 u32_leading_zeros(U32 x);
 
 internal U64 u64_min(U64 a, U64 b);
 internal U64 u64_max(U64 a, U64 b);
@@ -172,6 +180,7 @@ internal U64 u64_rotate_left(U64 x, U64 amount);
 internal U64 u64_ceil_to_power_of_2(U64 x);
 internal U64 u64_reverse(U64 x);
 internal U64 u64_big_to_local_endian(U64 x);
+internal U32 u64_pop_count(U64 x);
 
 internal S8 s8_min(S8 a, S8 B);
 internal S8 s8_max(S8 a, S8 B);
@@ -222,6 +231,9 @@ internal U32 f32_round_to_u32(F32 x);
 internal S32 f32_round_to_s32(F32 x);
 internal U32 f32_solve_cubic(F32 a, F32 b, F32 c, F32 d, F32 *result_ts);
 
+internal F16 f16_from_f32(F32 x);
+internal F32 f32_from_f16(F16 x);
+
 internal F64 f64_min(F64 a, F64 b);
 internal F64 f64_max(F64 a, F64 b);
 internal F64 f64_abs(F64 x);
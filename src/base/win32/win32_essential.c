@@ -1,6 +1,7 @@
 global Arena    *win32_permanent_arena;
 global Str8List win32_argument_list;
 global HANDLE   win32_standard_output = INVALID_HANDLE_VALUE;
+global SRWLOCK  win32_permanent_arena_lock = SRWLOCK_INIT;
 
 internal Void *os_memory_reserve(U64 size) {
     Void *result = VirtualAlloc(0, size, MEM_RESERVE, PAGE_READWRITE);
@@ -80,6 +81,54 @@ internal B32 os_file_write(Str8 file_name, Str8List data) {
     return false;
 }
 
+internal B32 os_file_open_for_writing(Str8 file_name, OS_File *result) {
+    Arena_Temporary scratch = arena_get_scratch(0, 0);
+
+    CStr16 cstr16_file_name = cstr16_from_str8(scratch.arena, file_name);
+    HANDLE file = CreateFile(
+        cstr16_file_name,
+        GENERIC_WRITE,
+        0,
+        0,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        0
+    );
+
+    arena_end_temporary(scratch);
+
+    B32 success = file != INVALID_HANDLE_VALUE;
+    if (success) {
+        result->u64[0] = (U64) file;
+    }
+
+    return success;
+}
+
+internal B32 os_file_write_block(OS_File file, Void *data, U64 size) {
+    HANDLE handle = (HANDLE) file.u64[0];
+    U8 *ptr = (U8 *) data;
+    U8 *opl = (U8 *) data + size;
+
+    B32 success = true;
+    while (ptr < opl) {
+        DWORD to_write = (DWORD) u64_min((U64) (opl - ptr), 0xFFFFFFFF);
+        DWORD actual_write = 0;
+        if (!WriteFile(handle, ptr, to_write, &actual_write, 0)) {
+            success = false;
+            break;
+        }
+
+        ptr += actual_write;
+    }
+
+    return success;
+}
+
+internal Void os_file_close(OS_File file) {
+    CloseHandle((HANDLE) file.u64[0]);
+}
+
 
 internal FileProperties os_file_properties(Str8 file_name) {
     // TODO: Implement
@@ -163,6 +212,70 @@ internal Void os_get_entropy(Void *data, U64 size) {
 }
 
 
+internal DWORD WINAPI win32_thread_entry(LPVOID start) {
+    Win32_ThreadStart *thread_start = (Win32_ThreadStart *) start;
+
+    arena_init_scratch();
+    thread_start->function(thread_start->data);
+    arena_destroy_scratch();
+
+    return 0;
+}
+
+internal OS_Thread os_thread_create(OS_ThreadFunction *function, Void *data) {
+    OS_Thread result = { 0 };
+
+    AcquireSRWLockExclusive(&win32_permanent_arena_lock);
+    Win32_ThreadStart *start = arena_push_struct(win32_permanent_arena, Win32_ThreadStart);
+    ReleaseSRWLockExclusive(&win32_permanent_arena_lock);
+
+    start->function = function;
+    start->data     = data;
+
+    HANDLE thread = CreateThread(0, 0, win32_thread_entry, start, 0, 0);
+    if (thread) {
+        result.u64[0] = (U64) thread;
+    } else {
+        error_emit(str8_literal("Could not create thread."));
+    }
+
+    return result;
+}
+
+internal Void os_thread_join(OS_Thread thread) {
+    HANDLE handle = (HANDLE) thread.u64[0];
+    if (handle) {
+        WaitForSingleObject(handle, INFINITE);
+        CloseHandle(handle);
+    }
+}
+
+internal Void os_thread_yield(Void) {
+    SwitchToThread();
+}
+
+internal U32 os_get_processor_count(Void) {
+    SYSTEM_INFO system_info = { 0 };
+    GetSystemInfo(&system_info);
+    return system_info.dwNumberOfProcessors;
+}
+
+internal Void os_semaphore_create(OS_Semaphore *semaphore, U32 initial_count) {
+    semaphore->u64[0] = (U64) CreateSemaphore(0, (LONG) initial_count, 0x7FFFFFFF, 0);
+}
+
+internal Void os_semaphore_destroy(OS_Semaphore *semaphore) {
+    CloseHandle((HANDLE) semaphore->u64[0]);
+}
+
+internal Void os_semaphore_signal(OS_Semaphore *semaphore) {
+    ReleaseSemaphore((HANDLE) semaphore->u64[0], 1, 0);
+}
+
+internal Void os_semaphore_wait(OS_Semaphore *semaphore) {
+    WaitForSingleObject((HANDLE) semaphore->u64[0], INFINITE);
+}
+
 internal B32 os_console_run(Str8 program, Str8List arguments) {
     return false;
 }
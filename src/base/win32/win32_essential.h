@@ -8,4 +8,11 @@
 #include <Windows.h>
 #pragma warning(pop)
 
+typedef struct {
+    OS_ThreadFunction *function;
+    Void              *data;
+} Win32_ThreadStart;
+
+internal DWORD WINAPI win32_thread_entry(LPVOID start);
+
 #endif // WIN32_ESSENTIAL_H
@@ -0,0 +1,801 @@
+internal U32 cff_read_offset(U8 *data, U32 offset_size) {
+    U32 result = 0;
+    for (U32 i = 0; i < offset_size; ++i) {
+        result = result << 8 | data[i];
+    }
+    return result;
+}
+
+internal B32 cff_read_index(TTF_Reader *reader, B32 is_cff2, CFF_Index *result) {
+    B32 success = true;
+
+    CFF_Index index = { 0 };
+    index.count = (is_cff2 ? ttf_read_u32(reader) : ttf_read_u16(reader));
+
+    // NOTE(simon): Empty indices consist of only the count.
+    if (index.count && !reader->error) {
+        index.offset_size = ttf_read_u8(reader);
+        if (!(1 <= index.offset_size && index.offset_size <= 4)) {
+            error_emit(str8_literal("ERROR(font/cff): Invalid offset size in INDEX."));
+            success = false;
+        }
+
+        if (success) {
+            index.offsets = ttf_read_bytes(reader, ((U64) index.count + 1) * index.offset_size);
+        }
+
+        if (success && !reader->error) {
+            U32 last_offset = cff_read_offset(&index.offsets.data[index.count * index.offset_size], index.offset_size);
+            if (last_offset == 0) {
+                error_emit(str8_literal("ERROR(font/cff): Invalid offset in INDEX."));
+                success = false;
+            } else {
+                index.data = ttf_read_bytes(reader, last_offset - 1);
+            }
+        }
+    }
+
+    if (success && reader->error) {
+        error_emit(str8_literal("ERROR(font/cff): Not enough data for INDEX."));
+        success = false;
+    }
+
+    if (success) {
+        *result = index;
+    }
+
+    return success;
+}
+
+internal Str8 cff_index_get(CFF_Index index, U32 i) {
+    Str8 result = { 0 };
+    if (i < index.count) {
+        U32 start = cff_read_offset(&index.offsets.data[(U64) i * index.offset_size],       index.offset_size);
+        U32 end   = cff_read_offset(&index.offsets.data[((U64) i + 1) * index.offset_size], index.offset_size);
+        if (1 <= start && start <= end && end - 1 <= index.data.size) {
+            result = str8_substring(index.data, start - 1, end - start);
+        }
+    }
+    return result;
+}
+
+internal B32 cff_dict_next(TTF_Reader *reader, CFF_DictEntry *result) {
+    B32 success = true;
+    B32 is_done = false;
+
+    result->operand_count = 0;
+    while (success && !is_done) {
+        U8  b0      = ttf_read_u8(reader);
+        S32 operand = 0;
+
+        if (reader->error) {
+            success = false;
+        } else if (b0 == CFF_OPERATOR_ESCAPE) {
+            result->operator = CFF_ESCAPED(ttf_read_u8(reader));
+            success = !reader->error;
+            is_done = true;
+        } else if (b0 < 28) {
+            result->operator = b0;
+            is_done = true;
+        } else if (b0 == 28) {
+            operand = ttf_read_s16(reader);
+        } else if (b0 == 29) {
+            operand = (S32) ttf_read_u32(reader);
+        } else if (b0 == 30) {
+            // NOTE(simon): Reals are stored as nibbles and end with 0xF.
+            for (U8 byte = 0; (byte & 0x0F) != 0x0F && (byte & 0xF0) != 0xF0 && !reader->error; ) {
+                byte = ttf_read_u8(reader);
+            }
+        } else if (32 <= b0 && b0 <= 246) {
+            operand = (S32) b0 - 139;
+        } else if (247 <= b0 && b0 <= 250) {
+            operand = ((S32) b0 - 247) * 256 + (S32) ttf_read_u8(reader) + 108;
+        } else if (251 <= b0 && b0 <= 254) {
+            operand = -((S32) b0 - 251) * 256 - (S32) ttf_read_u8(reader) - 108;
+        } else {
+            success = false;
+        }
+
+        if (success && !is_done) {
+            if (result->operand_count < CFF_MAX_STACK_SIZE && !reader->error) {
+                result->operands[result->operand_count++] = operand;
+            } else {
+                success = false;
+            }
+        }
+    }
+
+    return success;
+}
+
+internal B32 cff_parse_font_dict(Arena *arena, Str8 data, Str8 dict_data, B32 is_cff2, CFF_FontDict *result) {
+    B32 success = true;
+
+    Arena_Temporary scratch = arena_get_scratch(&arena, 1);
+    CFF_DictEntry *entry = arena_push_struct(scratch.arena, CFF_DictEntry);
+
+    S32 private_size   = 0;
+    S32 private_offset = 0;
+    TTF_Reader reader = ttf_reader_from_str8(dict_data);
+    while (ttf_reader_remaining(&reader) && cff_dict_next(&reader, entry)) {
+        if (entry->operator == CFF_DictOp_Private && entry->operand_count >= 2) {
+            private_size   = entry->operands[entry->operand_count - 2];
+            private_offset = entry->operands[entry->operand_count - 1];
+        }
+    }
+
+    if (private_size < 0 || private_offset < 0 || (U64) private_offset + (U64) private_size > data.size) {
+        error_emit(str8_literal("ERROR(font/cff): Private DICT is outside of the table."));
+        success = false;
+    }
+
+    S32 subroutines_offset = 0;
+    if (success) {
+        reader = ttf_reader_from_str8(str8_substring(data, (U64) private_offset, (U64) private_size));
+        while (ttf_reader_remaining(&reader) && cff_dict_next(&reader, entry)) {
+            if (entry->operator == CFF_DictOp_Subrs && entry->operand_count >= 1) {
+                subroutines_offset = entry->operands[entry->operand_count - 1];
+            } else if (entry->operator == CFF_DictOp_VSIndex && entry->operand_count >= 1) {
+                result->vsindex = (U32) s32_max(0, entry->operands[entry->operand_count - 1]);
+            }
+        }
+    }
+
+    // NOTE(simon): Local subroutines are relative to the start of the Private DICT.
+    if (success && subroutines_offset > 0) {
+        reader = ttf_reader_from_str8(data);
+        ttf_reader_seek(&reader, (U64) private_offset + (U64) subroutines_offset);
+        success = cff_read_index(&reader, is_cff2, &result->subroutines);
+    }
+
+    arena_end_temporary(scratch);
+    return success;
+}
+
+internal B32 cff_parse(Arena *arena, Str8 data, B32 is_cff2, U32 glyph_count, CFF_Font *font) {
+    B32 success = true;
+
+    Arena_Temporary scratch = arena_get_scratch(&arena, 1);
+    CFF_DictEntry *entry = arena_push_struct(scratch.arena, CFF_DictEntry);
+
+    font->is_cff2 = is_cff2;
+
+    TTF_Reader reader = ttf_reader_from_str8(data);
+    U8 major_version = ttf_read_u8(&reader);
+    ttf_reader_skip(&reader, sizeof(U8)); // NOTE: minor_version
+    U8 header_size   = ttf_read_u8(&reader);
+
+    Str8 top_dict = { 0 };
+    if (is_cff2) {
+        U16 top_dict_size = ttf_read_u16(&reader);
+        ttf_reader_seek(&reader, header_size);
+        top_dict = ttf_read_bytes(&reader, top_dict_size);
+    } else {
+        // NOTE(simon): OpenType requires exactly one font in the table, so we
+        // only look at the first Top DICT.
+        CFF_Index names     = { 0 };
+        CFF_Index top_dicts = { 0 };
+        CFF_Index strings   = { 0 };
+        ttf_reader_seek(&reader, header_size);
+        success =
+            cff_read_index(&reader, is_cff2, &names) &&
+            cff_read_index(&reader, is_cff2, &top_dicts) &&
+            cff_read_index(&reader, is_cff2, &strings);
+        top_dict = cff_index_get(top_dicts, 0);
+    }
+
+    if (success) {
+        success = cff_read_index(&reader, is_cff2, &font->global_subroutines);
+    }
+
+    if (success && reader.error) {
+        error_emit(str8_literal("ERROR(font/cff): Not enough data for CFF header."));
+        success = false;
+    }
+
+    if (success && major_version != (is_cff2 ? 2 : 1)) {
+        error_emit(str8_literal("ERROR(font/cff): Unsupported version of CFF table."));
+        success = false;
+    }
+
+    S32 char_strings_offset = 0;
+    S32 char_string_type    = 2;
+    S32 fd_array_offset     = 0;
+    S32 fd_select_offset    = 0;
+    S32 vstore_offset       = 0;
+    if (success) {
+        TTF_Reader dict_reader = ttf_reader_from_str8(top_dict);
+        while (ttf_reader_remaining(&dict_reader) && cff_dict_next(&dict_reader, entry)) {
+            S32 last_operand = (entry->operand_count ? entry->operands[entry->operand_count - 1] : 0);
+            switch (entry->operator) {
+                case CFF_DictOp_CharStrings:    char_strings_offset = last_operand; break;
+                case CFF_DictOp_CharStringType: char_string_type    = last_operand; break;
+                case CFF_DictOp_FDArray:        fd_array_offset     = last_operand; break;
+                case CFF_DictOp_FDSelect:       fd_select_offset    = last_operand; break;
+                case CFF_DictOp_VStore:         vstore_offset       = last_operand; break;
+            }
+        }
+    }
+
+    if (success && char_string_type != 2) {
+        error_emit(str8_literal("ERROR(font/cff): Only Type 2 charstrings are supported."));
+        success = false;
+    }
+
+    if (success && !(0 < char_strings_offset && (U64) char_strings_offset < data.size)) {
+        error_emit(str8_literal("ERROR(font/cff): Missing or invalid CharStrings offset."));
+        success = false;
+    }
+
+    if (success) {
+        reader = ttf_reader_from_str8(data);
+        ttf_reader_seek(&reader, (U64) char_strings_offset);
+        success = cff_read_index(&reader, is_cff2, &font->char_strings);
+    }
+
+    if (success && font->char_strings.count < glyph_count) {
+        error_emit(str8_literal("ERROR(font/cff): There are fewer charstrings than glyphs."));
+        success = false;
+    }
+
+    // NOTE(simon): CID-keyed fonts and all CFF2 fonts have an array of font
+    // dicts, each with their own Private DICT. Other fonts have their
+    // Private DICT in the Top DICT.
+    if (success && fd_array_offset > 0) {
+        CFF_Index fd_array = { 0 };
+        reader = ttf_reader_from_str8(data);
+        ttf_reader_seek(&reader, (U64) fd_array_offset);
+        success = cff_read_index(&reader, is_cff2, &fd_array);
+
+        if (success && fd_array.count == 0) {
+            error_emit(str8_literal("ERROR(font/cff): Empty FDArray."));
+            success = false;
+        }
+
+        if (success) {
+            font->font_dict_count = fd_array.count;
+            font->font_dicts      = arena_push_array_zero(arena, CFF_FontDict, fd_array.count);
+            for (U32 i = 0; i < fd_array.count && success; ++i) {
+                success = cff_parse_font_dict(arena, data, cff_index_get(fd_array, i), is_cff2, &font->font_dicts[i]);
+            }
+        }
+    } else if (success && !is_cff2) {
+        font->font_dict_count = 1;
+        font->font_dicts      = arena_push_array_zero(arena, CFF_FontDict, 1);
+        success = cff_parse_font_dict(arena, data, top_dict, is_cff2, &font->font_dicts[0]);
+    } else if (success) {
+        error_emit(str8_literal("ERROR(font/cff): CFF2 table is missing the FDArray."));
+        success = false;
+    }
+
+    if (success && fd_select_offset > 0) {
+        font->fd_select = str8_skip(data, (U64) fd_select_offset);
+    }
+
+    // NOTE(simon): Only the number of regions of each item variation data is
+    // needed, see CFF_Font.
+    if (success && vstore_offset > 0) {
+        Str8 store = str8_skip(data, (U64) vstore_offset + sizeof(U16)); // NOTE: length
+        reader = ttf_reader_from_str8(store);
+        ttf_reader_skip(&reader, sizeof(U16) + sizeof(U32)); // NOTE: format, region_list_offset
+        U16 data_count = ttf_read_u16(&reader);
+
+        font->region_count_count = data_count;
+        font->region_counts      = arena_push_array_zero(arena, U16, data_count);
+        for (U32 i = 0; i < data_count && !reader.error; ++i) {
+            U32 data_offset = ttf_read_u32(&reader);
+            font->region_counts[i] = ttf_u16_at(store, (U64) data_offset + 2 * sizeof(U16)); // NOTE: Skip item_count and word_delta_count
+        }
+
+        if (reader.error) {
+            error_emit(str8_literal("ERROR(font/cff): Not enough data for variation store."));
+            success = false;
+        }
+    }
+
+    arena_end_temporary(scratch);
+    return success;
+}
+
+internal U32 cff_font_dict_index(CFF_Font *font, U32 glyph_index) {
+    U32  result    = 0;
+    Str8 fd_select = font->fd_select;
+
+    if (fd_select.size) {
+        U8 format = fd_select.data[0];
+        if (format == 0) {
+            if (1 + (U64) glyph_index < fd_select.size) {
+                result = fd_select.data[1 + glyph_index];
+            }
+        } else if (format == 3) {
+            // NOTE(simon): Ranges of U16 first and U8 font dict, followed by
+            // a sentinel glyph index.
+            U32 range_count = ttf_u16_at(fd_select, 1);
+            for (U32 i = 0; i < range_count; ++i) {
+                U64 range_offset = 3 + (U64) i * 3;
+                U32 first        = ttf_u16_at(fd_select, range_offset);
+                U32 next_first   = ttf_u16_at(fd_select, range_offset + 3);
+                if (first <= glyph_index && glyph_index < next_first && range_offset + 2 < fd_select.size) {
+                    result = fd_select.data[range_offset + 2];
+                    break;
+                }
+            }
+        } else if (format == 4) {
+            // NOTE(simon): Same as format 3, but with U32 first and U16 font
+            // dict.
+            U32 range_count = ttf_u32_at(fd_select, 1);
+            for (U32 i = 0; i < range_count; ++i) {
+                U64 range_offset = 5 + (U64) i * 6;
+                U32 first        = ttf_u32_at(fd_select, range_offset);
+                U32 next_first   = ttf_u32_at(fd_select, range_offset + 6);
+                if (first <= glyph_index && glyph_index < next_first) {
+                    result = ttf_u16_at(fd_select, range_offset + 4);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (result >= font->font_dict_count) {
+        result = 0;
+    }
+
+    return result;
+}
+
+typedef struct {
+    Arena     *arena;
+    CFF_Font  *font;
+    CFF_Index  local_subroutines;
+
+    F32 stack[CFF_MAX_STACK_SIZE];
+    U32 stack_count;
+    U32 stem_count;
+    U32 vsindex;
+    B32 is_width_parsed;
+    B32 is_done;
+
+    MSDF_Glyph    glyph;
+    MSDF_Contour *contour;
+    V2F32 point;
+    V2F32 contour_start;
+    V2F32 min;
+    V2F32 max;
+} CFF_CharStringState;
+
+internal S32 cff_subroutine_bias(U32 count) {
+    S32 result = 32768;
+    if (count < 1240) {
+        result = 107;
+    } else if (count < 33900) {
+        result = 1131;
+    }
+    return result;
+}
+
+// NOTE(simon): Extends the bounds with the extrema of one coordinate of a
+// cubic bezier, where its derivative is 0.
+internal Void cff_extend_cubic_bounds(F32 p0, F32 p1, F32 p2, F32 p3, F32 *min, F32 *max) {
+    *min = f32_min(*min, f32_min(p0, p3));
+    *max = f32_max(*max, f32_max(p0, p3));
+
+    F32 a = -p0 + 3.0f * p1 - 3.0f * p2 + p3;
+    F32 b = 2.0f * (p0 - 2.0f * p1 + p2);
+    F32 c = p1 - p0;
+
+    F32 ts[2] = { 0 };
+    U32 t_count = 0;
+    if (f32_abs(a) < F32_EPSILON) {
+        if (f32_abs(b) > F32_EPSILON) {
+            ts[t_count++] = -c / b;
+        }
+    } else {
+        F32 discriminant = b * b - 4.0f * a * c;
+        if (discriminant >= 0.0f) {
+            ts[t_count++] = (-b - f32_sqrt(discriminant)) / (2.0f * a);
+            ts[t_count++] = (-b + f32_sqrt(discriminant)) / (2.0f * a);
+        }
+    }
+
+    for (U32 i = 0; i < t_count; ++i) {
+        F32 t  = ts[i];
+        F32 mt = 1.0f - t;
+        if (0.0f < t && t < 1.0f) {
+            F32 value = mt * mt * mt * p0 + 3.0f * mt * mt * t * p1 + 3.0f * mt * t * t * p2 + t * t * t * p3;
+            *min = f32_min(*min, value);
+            *max = f32_max(*max, value);
+        }
+    }
+}
+
+internal Void cff_begin_contour(CFF_CharStringState *state) {
+    if (!state->contour) {
+        state->contour       = arena_push_struct_zero(state->arena, MSDF_Contour);
+        state->contour_start = state->point;
+    }
+}
+
+internal Void cff_line_to(CFF_CharStringState *state, V2F32 point) {
+    cff_begin_contour(state);
+
+    if (point.x != state->point.x || point.y != state->point.y) {
+        MSDF_Segment *line = arena_push_struct_zero(state->arena, MSDF_Segment);
+        line->kind  = MSDF_SEGMENT_LINE;
+        line->p0    = state->point;
+        line->p1    = point;
+        line->flags = 0;
+        dll_push_back(state->contour->first_segment, state->contour->last_segment, line);
+
+        state->min = v2f32_min(state->min, v2f32_min(line->p0, line->p1));
+        state->max = v2f32_max(state->max, v2f32_max(line->p0, line->p1));
+    }
+
+    state->point = point;
+}
+
+// NOTE(simon): Control points are relative to the previous one.
+internal Void cff_curve_to(CFF_CharStringState *state, V2F32 d1, V2F32 d2, V2F32 d3) {
+    V2F32 p0 = state->point;
+    V2F32 p1 = v2f32_add(p0, d1);
+    V2F32 p2 = v2f32_add(p1, d2);
+    V2F32 p3 = v2f32_add(p2, d3);
+
+    // NOTE(simon): Curves with both control points on the chord are lines.
+    // Curves with all points equal are handed to cff_line_to as well, which
+    // drops them like any other zero length line.
+    F32   epsilon     = 0.0001f;
+    V2F32 chord       = v2f32_subtract(p3, p0);
+    B32   is_point    =
+        p0.x == p1.x && p0.y == p1.y &&
+        p0.x == p2.x && p0.y == p2.y &&
+        p0.x == p3.x && p0.y == p3.y;
+    B32   is_straight =
+        (p0.x != p3.x || p0.y != p3.y) &&
+        f32_abs(v2f32_cross(v2f32_subtract(p1, p0), chord)) < epsilon &&
+        f32_abs(v2f32_cross(v2f32_subtract(p2, p0), chord)) < epsilon;
+
+    if (is_point || is_straight) {
+        cff_line_to(state, p3);
+    } else {
+        cff_begin_contour(state);
+
+        MSDF_Segment *bezier = arena_push_struct_zero(state->arena, MSDF_Segment);
+        bezier->kind  = MSDF_SEGMENT_CUBIC_BEZIER;
+        bezier->p0    = p0;
+        bezier->p1    = p1;
+        bezier->p2    = p2;
+        bezier->p3    = p3;
+        bezier->flags = 0;
+        dll_push_back(state->contour->first_segment, state->contour->last_segment, bezier);
+
+        cff_extend_cubic_bounds(p0.x, p1.x, p2.x, p3.x, &state->min.x, &state->max.x);
+        cff_extend_cubic_bounds(p0.y, p1.y, p2.y, p3.y, &state->min.y, &state->max.y);
+
+        state->point = p3;
+    }
+}
+
+// NOTE(simon): Contours are implicitly closed by a line back to their start.
+internal Void cff_close_contour(CFF_CharStringState *state) {
+    if (state->contour) {
+        cff_line_to(state, state->contour_start);
+
+        if (state->contour->first_segment) {
+            dll_push_back(state->glyph.first_contour, state->glyph.last_contour, state->contour);
+        }
+
+        state->contour = 0;
+    }
+}
+
+internal Void cff_move_to(CFF_CharStringState *state, V2F32 point) {
+    cff_close_contour(state);
+    state->point = point;
+    cff_begin_contour(state);
+}
+
+// NOTE(simon): In CFF, but not CFF2, the first stack clearing operator can be
+// preceded by the advance width of the glyph. We get it from hmtx instead.
+internal Void cff_skip_width(CFF_CharStringState *state, B32 has_extra_operand) {
+    if (!state->is_width_parsed && !state->font->is_cff2 && has_extra_operand && state->stack_count) {
+        --state->stack_count;
+        memory_move(&state->stack[0], &state->stack[1], state->stack_count * sizeof(F32));
+    }
+    state->is_width_parsed = true;
+}
+
+internal B32 cff_execute_char_string(CFF_CharStringState *state, Str8 char_string, U32 depth) {
+    B32 success      = true;
+    B32 is_returning = false;
+
+    F32 *s = state->stack;
+    TTF_Reader reader = ttf_reader_from_str8(char_string);
+    while (success && !is_returning && !state->is_done && ttf_reader_remaining(&reader)) {
+        U8 b0 = ttf_read_u8(&reader);
+
+        if (b0 == CFF_Op_ShortInt || b0 >= 32) {
+            F32 operand = 0.0f;
+            if (b0 == CFF_Op_ShortInt) {
+                operand = (F32) ttf_read_s16(&reader);
+            } else if (b0 <= 246) {
+                operand = (F32) ((S32) b0 - 139);
+            } else if (b0 <= 250) {
+                operand = (F32) (((S32) b0 - 247) * 256 + (S32) ttf_read_u8(&reader) + 108);
+            } else if (b0 <= 254) {
+                operand = (F32) (-((S32) b0 - 251) * 256 - (S32) ttf_read_u8(&reader) - 108);
+            } else {
+                // NOTE(simon): 16.16 fixed point.
+                operand = (F32) (S32) ttf_read_u32(&reader) / 65536.0f;
+            }
+
+            if (state->stack_count < CFF_MAX_STACK_SIZE) {
+                s[state->stack_count++] = operand;
+            } else {
+                error_emit(str8_literal("ERROR(font/cff): Charstring argument stack overflow."));
+                success = false;
+            }
+            continue;
+        }
+
+        U32 operator     = (b0 == CFF_OPERATOR_ESCAPE ? CFF_ESCAPED(ttf_read_u8(&reader)) : b0);
+        U32 n            = state->stack_count;
+        B32 is_underflow = false;
+        B32 clear_stack  = true;
+
+        switch (operator) {
+            case CFF_Op_HStem:
+            case CFF_Op_VStem:
+            case CFF_Op_HStemHM:
+            case CFF_Op_VStemHM: {
+                cff_skip_width(state, n % 2 != 0);
+                state->stem_count += state->stack_count / 2;
+            } break;
+            case CFF_Op_HintMask:
+            case CFF_Op_CntrMask: {
+                // NOTE(simon): Operands left on the stack are an implicit
+                // vstemhm. The mask has one bit per stem.
+                cff_skip_width(state, n % 2 != 0);
+                state->stem_count += state->stack_count / 2;
+                ttf_reader_skip(&reader, (state->stem_count + 7) / 8);
+            } break;
+            case CFF_Op_RMoveTo: {
+                cff_skip_width(state, n > 2);
+                if (state->stack_count >= 2) {
+                    cff_move_to(state, v2f32_add(state->point, v2f32(s[0], s[1])));
+                } else {
+                    is_underflow = true;
+                }
+            } break;
+            case CFF_Op_HMoveTo:
+            case CFF_Op_VMoveTo: {
+                cff_skip_width(state, n > 1);
+                if (state->stack_count >= 1) {
+                    V2F32 delta = (operator == CFF_Op_HMoveTo ? v2f32(s[0], 0.0f) : v2f32(0.0f, s[0]));
+                    cff_move_to(state, v2f32_add(state->point, delta));
+                } else {
+                    is_underflow = true;
+                }
+            } break;
+            case CFF_Op_RLineTo: {
+                for (U32 i = 0; i + 2 <= n; i += 2) {
+                    cff_line_to(state, v2f32_add(state->point, v2f32(s[i], s[i + 1])));
+                }
+            } break;
+            case CFF_Op_HLineTo:
+            case CFF_Op_VLineTo: {
+                B32 is_horizontal = (operator == CFF_Op_HLineTo);
+                for (U32 i = 0; i < n; ++i) {
+                    V2F32 delta = (is_horizontal ? v2f32(s[i], 0.0f) : v2f32(0.0f, s[i]));
+                    cff_line_to(state, v2f32_add(state->point, delta));
+                    is_horizontal = !is_horizontal;
+                }
+            } break;
+            case CFF_Op_RRCurveTo: {
+                for (U32 i = 0; i + 6 <= n; i += 6) {
+                    cff_curve_to(state, v2f32(s[i], s[i + 1]), v2f32(s[i + 2], s[i + 3]), v2f32(s[i + 4], s[i + 5]));
+                }
+            } break;
+            case CFF_Op_RCurveLine: {
+                if (n >= 8) {
+                    U32 i = 0;
+                    for (; i + 6 <= n - 2; i += 6) {
+                        cff_curve_to(state, v2f32(s[i], s[i + 1]), v2f32(s[i + 2], s[i + 3]), v2f32(s[i + 4], s[i + 5]));
+                    }
+                    cff_line_to(state, v2f32_add(state->point, v2f32(s[i], s[i + 1])));
+                } else {
+                    is_underflow = true;
+                }
+            } break;
+            case CFF_Op_RLineCurve: {
+                if (n >= 8) {
+                    U32 i = 0;
+                    for (; i + 2 <= n - 6; i += 2) {
+                        cff_line_to(state, v2f32_add(state->point, v2f32(s[i], s[i + 1])));
+                    }
+                    cff_curve_to(state, v2f32(s[i], s[i + 1]), v2f32(s[i + 2], s[i + 3]), v2f32(s[i + 4], s[i + 5]));
+                } else {
+                    is_underflow = true;
+                }
+            } break;
+            case CFF_Op_VVCurveTo: {
+                U32 i  = n % 2;
+                F32 dx = (i ? s[0] : 0.0f);
+                for (; i + 4 <= n; i += 4) {
+                    cff_curve_to(state, v2f32(dx, s[i]), v2f32(s[i + 1], s[i + 2]), v2f32(0.0f, s[i + 3]));
+                    dx = 0.0f;
+                }
+            } break;
+            case CFF_Op_HHCurveTo: {
+                U32 i  = n % 2;
+                F32 dy = (i ? s[0] : 0.0f);
+                for (; i + 4 <= n; i += 4) {
+                    cff_curve_to(state, v2f32(s[i], dy), v2f32(s[i + 1], s[i + 2]), v2f32(s[i + 3], 0.0f));
+                    dy = 0.0f;
+                }
+            } break;
+            case CFF_Op_HVCurveTo:
+            case CFF_Op_VHCurveTo: {
+                // NOTE(simon): Curves alternate between starting horizontally
+                // and vertically. The last curve can have an extra operand for
+                // the end direction.
+                B32 is_horizontal = (operator == CFF_Op_HVCurveTo);
+                for (U32 i = 0; i + 4 <= n; i += 4) {
+                    F32 last = (n - i == 5 ? s[i + 4] : 0.0f);
+                    if (is_horizontal) {
+                        cff_curve_to(state, v2f32(s[i], 0.0f), v2f32(s[i + 1], s[i + 2]), v2f32(last, s[i + 3]));
+                    } else {
+                        cff_curve_to(state, v2f32(0.0f, s[i]), v2f32(s[i + 1], s[i + 2]), v2f32(s[i + 3], last));
+                    }
+                    is_horizontal = !is_horizontal;
+                }
+            } break;
+            case CFF_Op_Flex: {
+                if (n >= 13) {
+                    cff_curve_to(state, v2f32(s[0], s[1]), v2f32(s[2], s[3]),  v2f32(s[4],  s[5]));
+                    cff_curve_to(state, v2f32(s[6], s[7]), v2f32(s[8], s[9]),  v2f32(s[10], s[11]));
+                } else {
+                    is_underflow = true;
+                }
+            } break;
+            case CFF_Op_HFlex: {
+                if (n >= 7) {
+                    cff_curve_to(state, v2f32(s[0], 0.0f), v2f32(s[1], s[2]),  v2f32(s[3], 0.0f));
+                    cff_curve_to(state, v2f32(s[4], 0.0f), v2f32(s[5], -s[2]), v2f32(s[6], 0.0f));
+                } else {
+                    is_underflow = true;
+                }
+            } break;
+            case CFF_Op_HFlex1: {
+                if (n >= 9) {
+                    cff_curve_to(state, v2f32(s[0], s[1]), v2f32(s[2], s[3]), v2f32(s[4], 0.0f));
+                    cff_curve_to(state, v2f32(s[5], 0.0f), v2f32(s[6], s[7]), v2f32(s[8], -(s[1] + s[3] + s[7])));
+                } else {
+                    is_underflow = true;
+                }
+            } break;
+            case CFF_Op_Flex1: {
+                if (n >= 11) {
+                    // NOTE(simon): The last point only moves along the axis
+                    // where the curves moved the most.
+                    F32 dx = s[0] + s[2] + s[4] + s[6] + s[8];
+                    F32 dy = s[1] + s[3] + s[5] + s[7] + s[9];
+                    V2F32 last = (f32_abs(dx) > f32_abs(dy) ? v2f32(s[10], -dy) : v2f32(-dx, s[10]));
+                    cff_curve_to(state, v2f32(s[0], s[1]), v2f32(s[2], s[3]), v2f32(s[4], s[5]));
+                    cff_curve_to(state, v2f32(s[6], s[7]), v2f32(s[8], s[9]), last);
+                } else {
+                    is_underflow = true;
+                }
+            } break;
+            case CFF_Op_CallSubr:
+            case CFF_Op_CallGSubr: {
+                clear_stack = false;
+                if (n >= 1) {
+                    CFF_Index subroutines = (operator == CFF_Op_CallSubr ? state->local_subroutines : state->font->global_subroutines);
+                    S32 index = (S32) s[--state->stack_count] + cff_subroutine_bias(subroutines.count);
+
+                    if (!(0 <= index && (U32) index < subroutines.count)) {
+                        error_emit(str8_literal("ERROR(font/cff): Invalid subroutine index."));
+                        success = false;
+                    } else if (depth + 1 > CFF_MAX_SUBROUTINE_DEPTH) {
+                        error_emit(str8_literal("ERROR(font/cff): Subroutines are nested too deeply."));
+                        success = false;
+                    } else {
+                        success = cff_execute_char_string(state, cff_index_get(subroutines, (U32) index), depth + 1);
+                    }
+                } else {
+                    is_underflow = true;
+                }
+            } break;
+            case CFF_Op_Return: {
+                clear_stack  = false;
+                is_returning = true;
+            } break;
+            case CFF_Op_EndChar: {
+                cff_skip_width(state, n == 1 || n == 5);
+                if (state->stack_count >= 4) {
+                    error_emit(str8_literal("ERROR(font/cff): Accented characters built with endchar are not supported."));
+                    success = false;
+                }
+                state->is_done = true;
+            } break;
+            case CFF_Op_VSIndex: {
+                if (n >= 1) {
+                    state->vsindex = (U32) f32_max(0.0f, s[n - 1]);
+                } else {
+                    is_underflow = true;
+                }
+            } break;
+            case CFF_Op_Blend: {
+                // NOTE(simon): Operands are value_count default values, a
+                // delta per region for each of them and value_count. Without
+                // variations applied, only the defaults are kept.
+                clear_stack = false;
+                if (n >= 1) {
+                    U32 value_count  = (U32) f32_max(0.0f, s[n - 1]);
+                    U32 region_count = (state->vsindex < state->font->region_count_count ? state->font->region_counts[state->vsindex] : 0);
+                    U64 required     = (U64) value_count * (region_count + 1) + 1;
+                    if (required <= n) {
+                        state->stack_count = n - 1 - value_count * region_count;
+                    } else {
+                        is_underflow = true;
+                    }
+                } else {
+                    is_underflow = true;
+                }
+            } break;
+            case CFF_Op_DotSection: {
+            } break;
+            default: {
+                error_emit(str8_literal("ERROR(font/cff): Unsupported charstring operator."));
+                success = false;
+            } break;
+        }
+
+        if (is_underflow) {
+            error_emit(str8_literal("ERROR(font/cff): Not enough operands for charstring operator."));
+            success = false;
+        }
+
+        if (clear_stack) {
+            state->stack_count = 0;
+        }
+
+        if (reader.error) {
+            error_emit(str8_literal("ERROR(font/cff): Not enough data in charstring."));
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+internal MSDF_Glyph cff_expand_contours_to_msdf(Arena *arena, CFF_Font *font, U32 glyph_index) {
+    MSDF_Glyph result = { 0 };
+
+    Arena_Temporary scratch = arena_get_scratch(&arena, 1);
+
+    CFF_FontDict *font_dict = &font->font_dicts[cff_font_dict_index(font, glyph_index)];
+
+    CFF_CharStringState *state = arena_push_struct_zero(scratch.arena, CFF_CharStringState);
+    state->arena             = arena;
+    state->font              = font;
+    state->local_subroutines = font_dict->subroutines;
+    state->vsindex           = font_dict->vsindex;
+    state->min               = v2f32(f32_infinity(), f32_infinity());
+    state->max               = v2f32(f32_negative_infinity(), f32_negative_infinity());
+
+    if (cff_execute_char_string(state, cff_index_get(font->char_strings, glyph_index), 0)) {
+        cff_close_contour(state);
+
+        result = state->glyph;
+        if (result.first_contour) {
+            result.x_min = (S32) f32_floor(state->min.x);
+            result.y_min = (S32) f32_floor(state->min.y);
+            result.x_max = (S32) f32_ceil(state->max.x);
+            result.y_max = (S32) f32_ceil(state->max.y);
+        }
+    }
+
+    arena_end_temporary(scratch);
+    return result;
+}
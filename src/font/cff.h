@@ -0,0 +1,116 @@
+#ifndef CFF_H
+#define CFF_H
+
+// NOTE(simon): Outlines stored as Type 2 charstrings in a CFF or CFF2 table,
+// as used by OpenType fonts with PostScript outlines. Charstrings are small
+// stack based programs that produce cubic bezier curves. Hinting is ignored.
+
+// NOTE(simon): CFF2 raised the argument stack limit from 48 to 513, we use
+// the larger one for both.
+#define CFF_MAX_STACK_SIZE       513
+#define CFF_MAX_SUBROUTINE_DEPTH 10
+
+#define CFF_OPERATOR_ESCAPE 12
+#define CFF_ESCAPED(operator) (0x0C00 | (operator))
+
+// NOTE(simon): DICT operators that we care about.
+typedef enum {
+    CFF_DictOp_CharStrings    = 17,
+    CFF_DictOp_Private        = 18,
+    CFF_DictOp_Subrs          = 19,
+    CFF_DictOp_VSIndex        = 22,
+    CFF_DictOp_VStore         = 24,
+    CFF_DictOp_CharStringType = CFF_ESCAPED(6),
+    CFF_DictOp_ROS            = CFF_ESCAPED(30),
+    CFF_DictOp_FDArray        = CFF_ESCAPED(36),
+    CFF_DictOp_FDSelect       = CFF_ESCAPED(37),
+} CFF_DictOp;
+
+typedef enum {
+    CFF_Op_HStem      = 1,
+    CFF_Op_VStem      = 3,
+    CFF_Op_VMoveTo    = 4,
+    CFF_Op_RLineTo    = 5,
+    CFF_Op_HLineTo    = 6,
+    CFF_Op_VLineTo    = 7,
+    CFF_Op_RRCurveTo  = 8,
+    CFF_Op_CallSubr   = 10,
+    CFF_Op_Return     = 11,
+    CFF_Op_EndChar    = 14,
+    CFF_Op_VSIndex    = 15,
+    CFF_Op_Blend      = 16,
+    CFF_Op_HStemHM    = 18,
+    CFF_Op_HintMask   = 19,
+    CFF_Op_CntrMask   = 20,
+    CFF_Op_RMoveTo    = 21,
+    CFF_Op_HMoveTo    = 22,
+    CFF_Op_VStemHM    = 23,
+    CFF_Op_RCurveLine = 24,
+    CFF_Op_RLineCurve = 25,
+    CFF_Op_VVCurveTo  = 26,
+    CFF_Op_HHCurveTo  = 27,
+    CFF_Op_ShortInt   = 28,
+    CFF_Op_CallGSubr  = 29,
+    CFF_Op_VHCurveTo  = 30,
+    CFF_Op_HVCurveTo  = 31,
+    CFF_Op_DotSection = CFF_ESCAPED(0),
+    CFF_Op_HFlex      = CFF_ESCAPED(34),
+    CFF_Op_Flex       = CFF_ESCAPED(35),
+    CFF_Op_HFlex1     = CFF_ESCAPED(36),
+    CFF_Op_Flex1      = CFF_ESCAPED(37),
+} CFF_Op;
+
+// NOTE(simon): An array of variable sized objects. Object i occupies
+// [offset[i], offset[i + 1]) of data, where offsets are read from the offset
+// array and are 1-based.
+typedef struct {
+    U32  count;
+    U32  offset_size;
+    Str8 offsets;
+    Str8 data;
+} CFF_Index;
+
+typedef struct {
+    S32 operands[CFF_MAX_STACK_SIZE];
+    U32 operand_count;
+    U32 operator;
+} CFF_DictEntry;
+
+// NOTE(simon): Private data of one font dict. Non-CID CFF fonts only have a
+// single one.
+typedef struct {
+    CFF_Index subroutines;
+    U32       vsindex;
+} CFF_FontDict;
+
+typedef struct {
+    B32 is_cff2;
+
+    CFF_Index char_strings;
+    CFF_Index global_subroutines;
+
+    CFF_FontDict *font_dicts;
+    U32           font_dict_count;
+
+    // NOTE(simon): Maps glyphs to font dicts. Empty when all glyphs use the
+    // first font dict.
+    Str8 fd_select;
+
+    // NOTE(simon): Number of variation regions for each item variation data
+    // in the CFF2 variation store, needed to know how many operands blend
+    // consumes.
+    U16 *region_counts;
+    U32  region_count_count;
+} CFF_Font;
+
+internal B32  cff_read_index(TTF_Reader *reader, B32 is_cff2, CFF_Index *result);
+internal Str8 cff_index_get(CFF_Index index, U32 i);
+
+// NOTE(simon): Reads the next operator and its operands. Real operands are
+// read as 0 as none of the operators we use take them.
+internal B32 cff_dict_next(TTF_Reader *reader, CFF_DictEntry *result);
+
+internal B32 cff_parse(Arena *arena, Str8 data, B32 is_cff2, U32 glyph_count, CFF_Font *font);
+internal U32 cff_font_dict_index(CFF_Font *font, U32 glyph_index);
+
+#endif // CFF_H
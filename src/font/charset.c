@@ -0,0 +1,185 @@
+global Charset_Block charset_blocks[] = {
+    { "ascii",                         0x0020,  0x007E  },
+    { "basic-latin",                   0x0000,  0x007F  },
+    { "latin-1",                       0x00A0,  0x00FF  },
+    { "latin-1-supplement",            0x0080,  0x00FF  },
+    { "latin-extended-a",              0x0100,  0x017F  },
+    { "latin-extended-b",              0x0180,  0x024F  },
+    { "ipa-extensions",                0x0250,  0x02AF  },
+    { "greek",                         0x0370,  0x03FF  },
+    { "cyrillic",                      0x0400,  0x04FF  },
+    { "cyrillic-supplement",           0x0500,  0x052F  },
+    { "armenian",                      0x0530,  0x058F  },
+    { "hebrew",                        0x0590,  0x05FF  },
+    { "arabic",                        0x0600,  0x06FF  },
+    { "devanagari",                    0x0900,  0x097F  },
+    { "thai",                          0x0E00,  0x0E7F  },
+    { "georgian",                      0x10A0,  0x10FF  },
+    { "hangul-jamo",                   0x1100,  0x11FF  },
+    { "latin-extended-additional",     0x1E00,  0x1EFF  },
+    { "greek-extended",                0x1F00,  0x1FFF  },
+    { "general-punctuation",           0x2000,  0x206F  },
+    { "currency-symbols",              0x20A0,  0x20CF  },
+    { "letterlike-symbols",            0x2100,  0x214F  },
+    { "arrows",                        0x2190,  0x21FF  },
+    { "mathematical-operators",        0x2200,  0x22FF  },
+    { "box-drawing",                   0x2500,  0x257F  },
+    { "block-elements",                0x2580,  0x259F  },
+    { "geometric-shapes",              0x25A0,  0x25FF  },
+    { "cjk-symbols-and-punctuation",   0x3000,  0x303F  },
+    { "hiragana",                      0x3040,  0x309F  },
+    { "katakana",                      0x30A0,  0x30FF  },
+    { "cjk-unified-ideographs",        0x4E00,  0x9FFF  },
+    { "hangul-syllables",              0xAC00,  0xD7AF  },
+    { "halfwidth-and-fullwidth-forms", 0xFF00,  0xFFEF  },
+    { "emoticons",                     0x1F600, 0x1F64F },
+};
+
+internal Void charset_add(Arena *arena, Charset *set, U32 codepoint) {
+    charset_add_range(arena, set, codepoint, codepoint);
+}
+
+internal Void charset_add_range(Arena *arena, Charset *set, U32 first, U32 last) {
+    last = u32_min(last, CHARSET_CODEPOINT_COUNT - 1);
+
+    // NOTE(simon): Fill whole words at a time, masking the partial words at
+    // either end of the range.
+    for (U32 word_first = first; word_first <= last; ) {
+        U32 word_last  = u32_min(last, word_first | 63);
+        U32 page_index = word_first >> CHARSET_PAGE_BITS;
+        U32 word_index = (word_first & (CHARSET_PAGE_SIZE - 1)) >> 6;
+
+        if (!set->pages[page_index]) {
+            set->pages[page_index] = arena_push_array_zero(arena, U64, CHARSET_PAGE_SIZE / 64);
+        }
+
+        U64 *word = &set->pages[page_index][word_index];
+        U64  mask = (U64_MAX >> (63 - (word_last & 63))) & (U64_MAX << (word_first & 63));
+        set->count += u64_pop_count(mask & ~*word);
+        *word |= mask;
+
+        word_first = word_last + 1;
+    }
+}
+
+internal B32 charset_contains(Charset *set, U32 codepoint) {
+    B32 result = false;
+    if (codepoint < CHARSET_CODEPOINT_COUNT) {
+        U64 *page = set->pages[codepoint >> CHARSET_PAGE_BITS];
+        result = page && (page[(codepoint & (CHARSET_PAGE_SIZE - 1)) >> 6] >> (codepoint & 63) & 1);
+    }
+    return result;
+}
+
+internal Void charset_add_utf8(Arena *arena, Charset *set, Str8 text) {
+    for (U8 *ptr = text.data, *opl = text.data + text.size; ptr < opl; ) {
+        StringDecode decode = string_decode_utf8(ptr, (U64) (opl - ptr));
+        ptr += decode.size;
+
+        if (decode.is_valid) {
+            charset_add(arena, set, decode.codepoint);
+        }
+    }
+}
+
+internal B32 charset_add_file(Arena *arena, Charset *set, Str8 file_name) {
+    Arena_Temporary scratch = arena_get_scratch(&arena, 1);
+
+    Str8 text = { 0 };
+    B32 success = os_file_read(scratch.arena, file_name, &text);
+    if (success) {
+        charset_add_utf8(arena, set, text);
+    } else {
+        error_emit(str8_literal("ERROR(font/charset): Could not read text file."));
+    }
+
+    arena_end_temporary(scratch);
+    return success;
+}
+
+internal B32 charset_parse_codepoint(Str8 string, U32 *result) {
+    B32 success = false;
+    U64 value   = 0;
+
+    Str8 prefix = str8_prefix(string, 2);
+    if (str8_equal(prefix, str8_literal("U+")) || str8_equal(prefix, str8_literal("u+")) || str8_equal(prefix, str8_literal("0x")) || str8_equal(prefix, str8_literal("0X"))) {
+        Str8 digits = str8_skip(string, 2);
+
+        success = 0 < digits.size && digits.size <= 6;
+        for (U64 i = 0; success && i < digits.size; ++i) {
+            U8 digit = digits.data[i];
+            if ('0' <= digit && digit <= '9') {
+                value = value * 16 + (U64) (digit - '0');
+            } else if ('a' <= digit && digit <= 'f') {
+                value = value * 16 + (U64) (digit - 'a' + 10);
+            } else if ('A' <= digit && digit <= 'F') {
+                value = value * 16 + (U64) (digit - 'A' + 10);
+            } else {
+                success = false;
+            }
+        }
+    } else {
+        success = u64_from_str8(string, &value);
+    }
+
+    if (success && value < CHARSET_CODEPOINT_COUNT) {
+        *result = (U32) value;
+    } else {
+        success = false;
+    }
+
+    return success;
+}
+
+internal B32 charset_parse_item(Arena *arena, Charset *set, Str8 item) {
+    for (U32 i = 0; i < array_count(charset_blocks); ++i) {
+        if (str8_equal(item, str8_cstr(charset_blocks[i].name))) {
+            charset_add_range(arena, set, charset_blocks[i].first, charset_blocks[i].last);
+            return true;
+        }
+    }
+
+    B32 success = false;
+    U32 first   = 0;
+    U32 last    = 0;
+
+    U64 dash_index = 0;
+    if (str8_first_index_of(item, '-', &dash_index)) {
+        success =
+            charset_parse_codepoint(str8_prefix(item, dash_index), &first) &&
+            charset_parse_codepoint(str8_skip(item, dash_index + 1), &last) &&
+            first <= last;
+    } else {
+        success = charset_parse_codepoint(item, &first);
+        last    = first;
+    }
+
+    if (success) {
+        charset_add_range(arena, set, first, last);
+    }
+
+    return success;
+}
+
+internal B32 charset_parse(Arena *arena, Charset *set, Str8 expression) {
+    B32 success = true;
+
+    U8 *ptr = expression.data;
+    U8 *opl = expression.data + expression.size;
+    while (success && ptr < opl) {
+        U8 *item_start = ptr;
+        while (ptr < opl && !(*ptr == ',' || *ptr == ' ' || *ptr == '\t' || *ptr == '\r' || *ptr == '\n')) {
+            ++ptr;
+        }
+
+        Str8 item = str8_range(item_start, ptr);
+        if (item.size && !charset_parse_item(arena, set, item)) {
+            error_emit(str8_literal("ERROR(font/charset): Invalid codepoint, range or block name in character set."));
+            success = false;
+        }
+
+        ++ptr;
+    }
+
+    return success;
+}
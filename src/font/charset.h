@@ -0,0 +1,39 @@
+#ifndef CHARSET_H
+#define CHARSET_H
+
+#define CHARSET_CODEPOINT_COUNT 0x110000
+#define CHARSET_PAGE_BITS       12
+#define CHARSET_PAGE_SIZE       (1 << CHARSET_PAGE_BITS)
+#define CHARSET_PAGE_COUNT      (CHARSET_CODEPOINT_COUNT / CHARSET_PAGE_SIZE)
+
+// NOTE(simon): A set of codepoints as a two-level bitmap. Each page covers
+// 4096 consecutive codepoints and is only allocated once something on it is
+// added, so the sets used for baking rarely need more than a few kilobytes.
+typedef struct {
+    U64 *pages[CHARSET_PAGE_COUNT];
+    U32  count;
+} Charset;
+
+typedef struct {
+    CStr name;
+    U32  first;
+    U32  last;
+} Charset_Block;
+
+internal Void charset_add(Arena *arena, Charset *set, U32 codepoint);
+internal Void charset_add_range(Arena *arena, Charset *set, U32 first, U32 last);
+internal B32  charset_contains(Charset *set, U32 codepoint);
+
+// NOTE(simon): Adds every codepoint in the text. Invalid UTF-8 is skipped.
+internal Void charset_add_utf8(Arena *arena, Charset *set, Str8 text);
+internal B32  charset_add_file(Arena *arena, Charset *set, Str8 file_name);
+
+// NOTE(simon): Adds everything in a list of items separated by commas or
+// whitespace. An item is a codepoint, an inclusive range of two codepoints
+// separated by '-', or the name of a Unicode block such as "cyrillic".
+// Codepoints are written as U+XXXX, 0xXXXX or in decimal. For example:
+//
+//     ascii, latin-1, U+0400-U+04FF, 0x2026
+internal B32 charset_parse(Arena *arena, Charset *set, Str8 expression);
+
+#endif // CHARSET_H
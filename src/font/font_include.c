@@ -1,2 +1,5 @@
+#include "ttf_reader.c"
+#include "cff.c"
 #include "ttf.c"
 #include "msdf.c"
+#include "charset.c"
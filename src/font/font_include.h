@@ -1,7 +1,10 @@
 #ifndef FONT_INCLUDE_H
 #define FONT_INCLUDE_H
 
+#include "ttf_reader.h"
+#include "cff.h"
 #include "ttf.h"
 #include "msdf.h"
+#include "charset.h"
 
 #endif // FONT_INCLUDE_H
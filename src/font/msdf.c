@@ -1,6 +1,3 @@
-// TODO: Allow for pruning small contours. This would hopefully increase the
-// quality of the final MSDF, although it won't be as accurate any more.
-
 internal Void msdf_quadratic_bezier_split(MSDF_Segment segment, F32 t, MSDF_Segment *result_a, MSDF_Segment *result_b) {
     // De Casteljau's algorithm.
     V2F32 a = v2f32_add(segment.p0, v2f32_scale(v2f32_subtract(segment.p1, segment.p0), t));
@@ -34,12 +31,71 @@ internal Void msdf_line_split(MSDF_Segment segment, F32 t, MSDF_Segment *result_
     result_b->flags = segment.flags;
 }
 
+internal Void msdf_cubic_bezier_split(MSDF_Segment segment, F32 t, MSDF_Segment *result_a, MSDF_Segment *result_b) {
+    // De Casteljau's algorithm.
+    V2F32 a  = v2f32_add(segment.p0, v2f32_scale(v2f32_subtract(segment.p1, segment.p0), t));
+    V2F32 b  = v2f32_add(segment.p1, v2f32_scale(v2f32_subtract(segment.p2, segment.p1), t));
+    V2F32 c  = v2f32_add(segment.p2, v2f32_scale(v2f32_subtract(segment.p3, segment.p2), t));
+    V2F32 ab = v2f32_add(a, v2f32_scale(v2f32_subtract(b, a), t));
+    V2F32 bc = v2f32_add(b, v2f32_scale(v2f32_subtract(c, b), t));
+    V2F32 d  = v2f32_add(ab, v2f32_scale(v2f32_subtract(bc, ab), t));
+
+    result_a->kind  = MSDF_SEGMENT_CUBIC_BEZIER;
+    result_a->p0    = segment.p0;
+    result_a->p1    = a;
+    result_a->p2    = ab;
+    result_a->p3    = d;
+    result_a->flags = segment.flags;
+
+    result_b->kind  = MSDF_SEGMENT_CUBIC_BEZIER;
+    result_b->p0    = d;
+    result_b->p1    = bc;
+    result_b->p2    = c;
+    result_b->p3    = segment.p3;
+    result_b->flags = segment.flags;
+}
+
 internal Void msdf_segment_split(MSDF_Segment segment, F32 t, MSDF_Segment *result_a, MSDF_Segment *result_b) {
     if (segment.kind == MSDF_SEGMENT_LINE) {
         msdf_line_split(segment, t, result_a, result_b);
     } else if (segment.kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
         msdf_quadratic_bezier_split(segment, t, result_a, result_b);
+    } else if (segment.kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        msdf_cubic_bezier_split(segment, t, result_a, result_b);
+    }
+}
+
+internal V2F32 *msdf_segment_end(MSDF_Segment *segment) {
+    V2F32 *result = &segment->p1;
+    if (segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
+        result = &segment->p2;
+    } else if (segment->kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        result = &segment->p3;
+    }
+    return result;
+}
+
+// NOTE(simon): Cubic control points frequently coincide with the end points
+// in CFF outlines, in which case the tangent is given by the next one.
+internal V2F32 msdf_segment_start_control(MSDF_Segment segment) {
+    V2F32 result = segment.p1;
+    if (segment.kind == MSDF_SEGMENT_CUBIC_BEZIER && segment.p1.x == segment.p0.x && segment.p1.y == segment.p0.y) {
+        result = (segment.p2.x == segment.p0.x && segment.p2.y == segment.p0.y ? segment.p3 : segment.p2);
     }
+    return result;
+}
+
+internal V2F32 msdf_segment_end_control(MSDF_Segment segment) {
+    V2F32 result = segment.p0;
+    if (segment.kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
+        result = segment.p1;
+    } else if (segment.kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        result = segment.p2;
+        if (segment.p2.x == segment.p3.x && segment.p2.y == segment.p3.y) {
+            result = (segment.p1.x == segment.p3.x && segment.p1.y == segment.p3.y ? segment.p0 : segment.p1);
+        }
+    }
+    return result;
 }
 
 internal B32 msdf_distance_is_closer(MSDF_Distance a, MSDF_Distance b) {
@@ -207,6 +263,109 @@ internal U32 msdf_line_intersect(MSDF_Segment a, MSDF_Segment b, F32 *result_ats
     return intersection_count;
 }
 
+internal Void msdf_segment_bounds(MSDF_Segment segment, V2F32 *result_min, V2F32 *result_max) {
+    V2F32 min = v2f32_min(segment.p0, segment.p1);
+    V2F32 max = v2f32_max(segment.p0, segment.p1);
+    if (segment.kind == MSDF_SEGMENT_QUADRATIC_BEZIER || segment.kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        min = v2f32_min(min, segment.p2);
+        max = v2f32_max(max, segment.p2);
+    }
+    if (segment.kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        min = v2f32_min(min, segment.p3);
+        max = v2f32_max(max, segment.p3);
+    }
+    *result_min = min;
+    *result_max = max;
+}
+
+// NOTE(simon): Same approach as for two quadratic beziers, but works for any
+// pair of segment kinds, as all of them lie within the bounds of their control
+// points.
+internal U32 msdf_generic_intersect_recurse(MSDF_Segment a, MSDF_Segment b, U32 iteration_count, F32 *result_ats, F32 *result_bts, U32 capacity) {
+    V2F32 a_min, a_max, b_min, b_max;
+    msdf_segment_bounds(a, &a_min, &a_max);
+    msdf_segment_bounds(b, &b_min, &b_max);
+
+    if (capacity == 0 || !(a_min.x <= b_max.x && a_max.x >= b_min.x && a_min.y <= b_max.y && a_max.y >= b_min.y)) {
+        return 0;
+    }
+
+    if (iteration_count == 0) {
+        // Assume that the curves are equivalent to lines at this point.
+        V2F32 a_end = *msdf_segment_end(&a);
+        V2F32 b_end = *msdf_segment_end(&b);
+        F32 denominator = (a.p0.x - a_end.x) * (b.p0.y - b_end.y) - (a.p0.y - a_end.y) * (b.p0.x - b_end.x);
+        if (f32_abs(denominator) > F32_EPSILON) {
+            F32 at = ((a.p0.x - b.p0.x) * (b.p0.y - b_end.y) - (a.p0.y - b.p0.y) * (b.p0.x - b_end.x)) / denominator;
+            F32 bt = ((a.p0.x - b.p0.x) * (a.p0.y - a_end.y) - (a.p0.y - b.p0.y) * (a.p0.x - a_end.x)) / denominator;
+
+            if (0.0f <= at && at < 1.0f && 0.0f <= bt && bt < 1.0f) {
+                result_ats[0] = at;
+                result_bts[0] = bt;
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    // May intersect, split into two and try again.
+    MSDF_Segment segments[4] = { 0 };
+    msdf_segment_split(a, 0.5f, &segments[0], &segments[1]);
+    msdf_segment_split(b, 0.5f, &segments[2], &segments[3]);
+
+    U32 count = 0;
+    for (U32 i = 0; i < 4; ++i) {
+        U32 first_solution = count;
+        U32 new_solutions  = msdf_generic_intersect_recurse(segments[i / 2], segments[2 + i % 2], iteration_count - 1, &result_ats[first_solution], &result_bts[first_solution], capacity - first_solution);
+        for (U32 j = 0; j < new_solutions; ++j) {
+            F32 at = (i / 2) * 0.5f + result_ats[first_solution + j] * 0.5f;
+            F32 bt = (i % 2) * 0.5f + result_bts[first_solution + j] * 0.5f;
+
+            // NOTE(simon): Neighbouring pieces can report the same
+            // intersection, only keep the first.
+            B32 is_duplicate = false;
+            for (U32 k = 0; k < count; ++k) {
+                if (f32_abs(result_ats[k] - at) < 0.0001f && f32_abs(result_bts[k] - bt) < 0.0001f) {
+                    is_duplicate = true;
+                }
+            }
+
+            if (!is_duplicate) {
+                result_ats[count] = at;
+                result_bts[count] = bt;
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+internal U32 msdf_generic_intersect(MSDF_Segment a, MSDF_Segment b, F32 *result_ats, F32 *result_bts) {
+    // NOTE(simon): Subdivide until the curves are within the error of the
+    // chords connecting their end points. The second derivative of a cubic is
+    // largest at one of its ends.
+    F32 error = 0.00001f;
+    F32 a_length = 0.0f;
+    F32 b_length = 0.0f;
+    if (a.kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
+        a_length = 2.0f * v2f32_length(v2f32_add(v2f32_subtract(a.p2, v2f32_scale(a.p1, 2.0f)), a.p0));
+    } else if (a.kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        a_length = 6.0f * f32_max(v2f32_length(v2f32_add(v2f32_subtract(a.p2, v2f32_scale(a.p1, 2.0f)), a.p0)), v2f32_length(v2f32_add(v2f32_subtract(a.p3, v2f32_scale(a.p2, 2.0f)), a.p1)));
+    }
+    if (b.kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
+        b_length = 2.0f * v2f32_length(v2f32_add(v2f32_subtract(b.p2, v2f32_scale(b.p1, 2.0f)), b.p0));
+    } else if (b.kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        b_length = 6.0f * f32_max(v2f32_length(v2f32_add(v2f32_subtract(b.p2, v2f32_scale(b.p1, 2.0f)), b.p0)), v2f32_length(v2f32_add(v2f32_subtract(b.p3, v2f32_scale(b.p2, 2.0f)), b.p1)));
+    }
+    U32 ar = f32_max(0.0f, f32_log2(f32_sqrt(a_length / (8.0f * error))));
+    U32 br = f32_max(0.0f, f32_log2(f32_sqrt(b_length / (8.0f * error))));
+    U32 r  = u32_min(u32_max(ar, br), MSDF_MAX_INTERSECT_DEPTH);
+
+    U32 count = msdf_generic_intersect_recurse(a, b, r, result_ats, result_bts, MSDF_MAX_INTERSECTIONS);
+
+    return count;
+}
+
 internal U32 msdf_segment_intersect(MSDF_Segment a, MSDF_Segment b, F32 *result_ats, F32 *result_bts) {
     U32 intersection_count = 0;
     if (a.kind == MSDF_SEGMENT_LINE && b.kind == MSDF_SEGMENT_LINE) {
@@ -217,6 +376,8 @@ internal U32 msdf_segment_intersect(MSDF_Segment a, MSDF_Segment b, F32 *result_
         intersection_count = msdf_line_quadratic_bezier_intersect(b, a, result_bts, result_ats);
     } else if (a.kind == MSDF_SEGMENT_QUADRATIC_BEZIER && b.kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
         intersection_count = msdf_quadratic_bezier_intersect(a, b, result_ats, result_bts);
+    } else if (a.kind == MSDF_SEGMENT_CUBIC_BEZIER || b.kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        intersection_count = msdf_generic_intersect(a, b, result_ats, result_bts);
     }
     return intersection_count;
 }
@@ -225,18 +386,24 @@ internal U32 msdf_segment_intersect(MSDF_Segment a, MSDF_Segment b, F32 *result_
 // https://en.wikipedia.org/wiki/Shoelace_formula
 internal S32 msdf_contour_calculate_own_winding_number(MSDF_Contour *contour) {
     F32 double_signed_area = 0.0f;
-    V2F32 previous = (contour->last_segment->kind == MSDF_SEGMENT_LINE ? contour->last_segment->p1 : contour->last_segment->p2);
+    V2F32 previous = *msdf_segment_end(contour->last_segment);
     for (MSDF_Segment *segment = contour->first_segment; segment; segment = segment->next) {
         if (segment->kind == MSDF_SEGMENT_LINE) {
             double_signed_area += previous.x    * segment->p0.y - segment->p0.x * previous.y;
             double_signed_area += segment->p0.x * segment->p1.y - segment->p1.x * segment->p0.y;
             previous = segment->p1;
-        } else {
+        } else if (segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
             // TODO(simon): We might want to use the vertex of the curve instead of P1.
             double_signed_area += previous.x    * segment->p0.y - segment->p0.x * previous.y;
             double_signed_area += segment->p0.x * segment->p1.y - segment->p1.x * segment->p0.y;
             double_signed_area += segment->p1.x * segment->p2.y - segment->p2.x * segment->p1.y;
             previous = segment->p2;
+        } else if (segment->kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+            double_signed_area += previous.x    * segment->p0.y - segment->p0.x * previous.y;
+            double_signed_area += segment->p0.x * segment->p1.y - segment->p1.x * segment->p0.y;
+            double_signed_area += segment->p1.x * segment->p2.y - segment->p2.x * segment->p1.y;
+            double_signed_area += segment->p2.x * segment->p3.y - segment->p3.x * segment->p2.y;
+            previous = segment->p3;
         }
     }
 
@@ -245,6 +412,124 @@ internal S32 msdf_contour_calculate_own_winding_number(MSDF_Contour *contour) {
     return winding;
 }
 
+internal V2F32 msdf_segment_point(MSDF_Segment segment, F32 t) {
+    V2F32 result = { 0 };
+    F32 mt = 1.0f - t;
+    switch (segment.kind) {
+        case MSDF_SEGMENT_NULL:       assert(!"Not reached!"); break;
+        case MSDF_SEGMENT_KIND_COUNT: assert(!"Not reached!"); break;
+        case MSDF_SEGMENT_LINE: {
+            result = v2f32_add(v2f32_scale(segment.p0, mt), v2f32_scale(segment.p1, t));
+        } break;
+        case MSDF_SEGMENT_QUADRATIC_BEZIER: {
+            result = v2f32_add(v2f32_add(v2f32_scale(segment.p0, mt * mt), v2f32_scale(segment.p1, 2.0f * mt * t)), v2f32_scale(segment.p2, t * t));
+        } break;
+        case MSDF_SEGMENT_CUBIC_BEZIER: {
+            result = v2f32_add(
+                v2f32_add(v2f32_scale(segment.p0, mt * mt * mt), v2f32_scale(segment.p1, 3.0f * mt * mt * t)),
+                v2f32_add(v2f32_scale(segment.p2, 3.0f * mt * t * t), v2f32_scale(segment.p3, t * t * t))
+            );
+        } break;
+    }
+    return result;
+}
+
+// NOTE(simon): Finds where the horizontal line at y crosses a segment, and
+// whether the segment goes up (+1) or down (-1) there. Curves are cut at their
+// extrema in y so that every piece is monotone and treated like a line, where
+// only the upper end point is included. Solving for the roots directly would
+// double count lines that pass through an end point or are tangent to a
+// curve. Returns the number of crossings, at most 3.
+internal U32 msdf_segment_horizontal_crossings(MSDF_Segment segment, F32 y, F32 *result_xs, S32 *result_directions) {
+    U32 result = 0;
+
+    if (segment.kind == MSDF_SEGMENT_LINE) {
+        // p0 + u * (p1 - p0) = (x, y)  u in [0, 1]
+        if ((segment.p0.y < y && y <= segment.p1.y) || (segment.p1.y < y && y <= segment.p0.y)) {
+            F32 u = (y - segment.p0.y) / (segment.p1.y - segment.p0.y);
+            result_xs[result]         = segment.p0.x + u * (segment.p1.x - segment.p0.x);
+            result_directions[result] = (segment.p0.y < segment.p1.y ? 1 : -1);
+            ++result;
+        }
+        return result;
+    }
+
+    F32 ts[4] = { 0 };
+    U32 t_count = 0;
+    ts[t_count++] = 0.0f;
+
+    if (segment.kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
+        F32 denominator = segment.p0.y - 2.0f * segment.p1.y + segment.p2.y;
+        if (f32_abs(denominator) > F32_EPSILON) {
+            F32 t = (segment.p0.y - segment.p1.y) / denominator;
+            if (0.0f < t && t < 1.0f) {
+                ts[t_count++] = t;
+            }
+        }
+    } else if (segment.kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        // NOTE(simon): Roots of the derivative divided by 3.
+        F32 a = -segment.p0.y + 3.0f * segment.p1.y - 3.0f * segment.p2.y + segment.p3.y;
+        F32 b = 2.0f * (segment.p0.y - 2.0f * segment.p1.y + segment.p2.y);
+        F32 c = segment.p1.y - segment.p0.y;
+
+        F32 roots[2] = { 0 };
+        U32 root_count = 0;
+        if (f32_abs(a) < F32_EPSILON) {
+            if (f32_abs(b) > F32_EPSILON) {
+                roots[root_count++] = -c / b;
+            }
+        } else {
+            F32 discriminant = b * b - 4.0f * a * c;
+            if (discriminant >= 0.0f) {
+                F32 root0 = (-b - f32_sqrt(discriminant)) / (2.0f * a);
+                F32 root1 = (-b + f32_sqrt(discriminant)) / (2.0f * a);
+                roots[root_count++] = f32_min(root0, root1);
+                roots[root_count++] = f32_max(root0, root1);
+            }
+        }
+
+        for (U32 i = 0; i < root_count; ++i) {
+            if (ts[t_count - 1] < roots[i] && roots[i] < 1.0f) {
+                ts[t_count++] = roots[i];
+            }
+        }
+    }
+
+    ts[t_count++] = 1.0f;
+
+    for (U32 i = 0; i + 1 < t_count; ++i) {
+        F32 low_t  = ts[i + 0];
+        F32 high_t = ts[i + 1];
+        F32 low_y  = msdf_segment_point(segment, low_t).y;
+        F32 high_y = msdf_segment_point(segment, high_t).y;
+
+        if ((low_y < y && y <= high_y) || (high_y < y && y <= low_y)) {
+            result_directions[result] = (low_y < high_y ? 1 : -1);
+
+            // NOTE(simon): The piece is monotone, so bisect for the crossing.
+            if (high_y < low_y) {
+                F32 temporary = low_t;
+                low_t  = high_t;
+                high_t = temporary;
+            }
+
+            for (U32 iteration = 0; iteration < MSDF_RAY_BISECTION_STEPS; ++iteration) {
+                F32 middle_t = 0.5f * (low_t + high_t);
+                if (msdf_segment_point(segment, middle_t).y < y) {
+                    low_t = middle_t;
+                } else {
+                    high_t = middle_t;
+                }
+            }
+
+            result_xs[result] = msdf_segment_point(segment, 0.5f * (low_t + high_t)).x;
+            ++result;
+        }
+    }
+
+    return result;
+}
+
 internal S32 msdf_contour_calculate_global_winding_number(MSDF_Glyph *glyph, MSDF_Contour *contour) {
     // NOTE(simon): Calculcate global winding number.
     S32 global_winding = contour->local_winding;
@@ -257,50 +542,12 @@ internal S32 msdf_contour_calculate_global_winding_number(MSDF_Glyph *glyph, MSD
             U32 intersection_count = 0;
 
             for (MSDF_Segment *segment = other_contour->first_segment; segment; segment = segment->next) {
-                if (segment->kind == MSDF_SEGMENT_LINE) {
-                    // Ray line intersection
-                    // p0 + u * (p1 - p0) = test_point + v * (1, 0)  u in [0, 1), v in [0, inf)
-                    //   p0.x + u * (p1.x - p0.x) = test_point.x + v
-                    //   p0.y + u * (p1.y - p0.y) = test_point.y
-                    if ((segment->p0.y < test_point.y && test_point.y <= segment->p1.y) || (segment->p1.y < test_point.y && test_point.y <= segment->p0.y)) {
-                        F32 u = (test_point.y - segment->p0.y) / (segment->p1.y - segment->p0.y);
-                        F32 v = segment->p0.x + u * (segment->p1.x - segment->p0.x) - test_point.x;
-
-                        if (0.0f <= u && u < 1.0f && 0.0f <= v) {
-                            ++intersection_count;
-                        }
-                    }
-                } else {
-                    // TODO(simon): Properly handle the case where we intersect at a corner, see above.
-
-                    // Ray quadratic bezier intersection
-                    // u^2 * (p0 - 2 * p1 + p2) + u * 2 * (p1 - p0) + p0 = test_point + v * (1, 0)  u in [0, 1), v in [0, inf)
-                    //   u^2 * (p0.x - 2 * p1.x + p2.x) + u * 2 * (p1.x - p0.x) + p0.x = test_point.x + v
-                    //   u^2 * (p0.y - 2 * p1.y + p2.y) + u * 2 * (p1.y - p0.y) + p0.y = test_point.y
-
-                    F32 ax = segment->p0.x - 2.0f * segment->p1.x + segment->p2.x;
-                    F32 bx = 2.0f * (segment->p1.x - segment->p0.x);
-                    F32 cx = segment->p0.x - test_point.x;
-
-                    F32 ay = segment->p0.y - 2.0f * segment->p1.y + segment->p2.y;
-                    F32 by = 2.0f * (segment->p1.y - segment->p0.y);
-                    F32 cy = segment->p0.y - test_point.y;
-
-                    F32 discriminant = by * by - 4.0f * ay * cy;
-                    if (-0.0001f <= discriminant) {
-                        F32 u0 = (-by - f32_sqrt(f32_max(0.0f, discriminant))) / (2.0f * ay);
-                        F32 u1 = (-by + f32_sqrt(f32_max(0.0f, discriminant))) / (2.0f * ay);
-
-                        F32 v0 = u0 * u0 * ax + u0 * bx + cx;
-                        F32 v1 = u1 * u1 * ax + u1 * bx + cx;
-
-                        if (0.0f <= u0 && u0 < 1.0f && 0.0f <= v0) {
-                            ++intersection_count;
-                        }
-
-                        if (0.0f <= u1 && u1 < 1.0f && 0.0f <= v1) {
-                            ++intersection_count;
-                        }
+                F32 xs[3] = { 0 };
+                S32 directions[3] = { 0 };
+                U32 crossing_count = msdf_segment_horizontal_crossings(*segment, test_point.y, xs, directions);
+                for (U32 i = 0; i < crossing_count; ++i) {
+                    if (test_point.x <= xs[i]) {
+                        ++intersection_count;
                     }
                 }
             }
@@ -321,12 +568,14 @@ internal B32 msdf_is_corner(MSDF_Segment a, MSDF_Segment b, F32 threshold) {
         case MSDF_SEGMENT_NULL:             assert(!"Not reached!");                             break;
         case MSDF_SEGMENT_LINE:             a_dir = v2f32_normalize(v2f32_subtract(a.p1, a.p0)); break;
         case MSDF_SEGMENT_QUADRATIC_BEZIER: a_dir = v2f32_normalize(v2f32_subtract(a.p2, a.p1)); break;
+        case MSDF_SEGMENT_CUBIC_BEZIER:     a_dir = v2f32_normalize(v2f32_subtract(a.p3, msdf_segment_end_control(a))); break;
         case MSDF_SEGMENT_KIND_COUNT:       a_dir = v2f32(0.0f, 0.0f);                           break;
     }
     switch (b.kind) {
         case MSDF_SEGMENT_NULL:             assert(!"Not reached!");                             break;
         case MSDF_SEGMENT_LINE:             b_dir = v2f32_normalize(v2f32_subtract(b.p1, b.p0)); break;
         case MSDF_SEGMENT_QUADRATIC_BEZIER: b_dir = v2f32_normalize(v2f32_subtract(b.p1, b.p0)); break;
+        case MSDF_SEGMENT_CUBIC_BEZIER:     b_dir = v2f32_normalize(v2f32_subtract(msdf_segment_start_control(b), b.p0)); break;
         case MSDF_SEGMENT_KIND_COUNT:       b_dir = v2f32(0.0f, 0.0f);                           break;
     }
 
@@ -338,30 +587,70 @@ internal B32 msdf_is_corner(MSDF_Segment a, MSDF_Segment b, F32 threshold) {
     return is_corner;
 }
 
-internal MSDF_Distance msdf_line_distance_orthogonality(V2F32 point, MSDF_Segment line) {
-    V2F32 length = v2f32_subtract(line.p1, line.p0);
-    F32 t = v2f32_dot(v2f32_subtract(point, line.p0), length) / v2f32_length_squared(length);
+internal Void msdf_segment_precompute(MSDF_Segment *segment) {
+    MSDF_SegmentCoefficients *coefficients = &segment->coefficients;
+    switch (segment->kind) {
+        case MSDF_SEGMENT_NULL: {
+            assert(!"Not reached!");
+        } break;
+        case MSDF_SEGMENT_LINE: {
+            coefficients->v1              = v2f32_subtract(segment->p1, segment->p0);
+            coefficients->start_direction = coefficients->v1;
+            coefficients->end_direction   = coefficients->v1;
+        } break;
+        case MSDF_SEGMENT_QUADRATIC_BEZIER: {
+            coefficients->v1              = v2f32_subtract(segment->p1, segment->p0);
+            coefficients->v2              = v2f32_add(v2f32_add(segment->p2, v2f32_scale(segment->p1, -2)), segment->p0);
+            coefficients->a               = v2f32_length_squared(coefficients->v2);
+            coefficients->b               = 3.0f * v2f32_dot(coefficients->v1, coefficients->v2);
+            coefficients->c               = 2.0f * v2f32_length_squared(coefficients->v1);
+            coefficients->start_direction = v2f32_subtract(segment->p1, segment->p0);
+            coefficients->end_direction   = v2f32_subtract(segment->p2, segment->p1);
+        } break;
+        case MSDF_SEGMENT_CUBIC_BEZIER: {
+            coefficients->v1              = v2f32_subtract(segment->p1, segment->p0);
+            coefficients->v2              = v2f32_subtract(v2f32_subtract(segment->p2, segment->p1), coefficients->v1);
+            coefficients->v3              = v2f32_subtract(v2f32_subtract(v2f32_subtract(segment->p3, segment->p2), v2f32_subtract(segment->p2, segment->p1)), coefficients->v2);
+            coefficients->start_direction = v2f32_subtract(msdf_segment_start_control(*segment), segment->p0);
+            coefficients->end_direction   = v2f32_subtract(segment->p3, msdf_segment_end_control(*segment));
+        } break;
+        case MSDF_SEGMENT_KIND_COUNT: {
+            assert(!"Not reached!");
+        } break;
+    }
+
+    coefficients->inverse_start_length_squared = 1.0f / v2f32_length_squared(coefficients->start_direction);
+    coefficients->inverse_end_length_squared   = 1.0f / v2f32_length_squared(coefficients->end_direction);
+    coefficients->unit_direction               = v2f32_scale(coefficients->start_direction, f32_sqrt(coefficients->inverse_start_length_squared));
+}
+
+internal MSDF_Distance msdf_line_distance_orthogonality(V2F32 point, MSDF_Segment *line) {
+    MSDF_SegmentCoefficients *coefficients = &line->coefficients;
+
+    F32 t = v2f32_dot(v2f32_subtract(point, line->p0), coefficients->v1) * coefficients->inverse_start_length_squared;
     t = f32_min(f32_max(0.0f, t), 1.0f);
-    V2F32 vector_distance = v2f32_subtract(point, v2f32_add(line.p0, v2f32_scale(length, t)));
+    V2F32 vector_distance = v2f32_subtract(point, v2f32_add(line->p0, v2f32_scale(coefficients->v1, t)));
 
     F32 distance = v2f32_length(vector_distance);
 
     MSDF_Distance result;
     result.distance      = distance;
-    result.orthogonality = f32_abs(v2f32_cross(v2f32_normalize(length), v2f32_scale(vector_distance, 1.0f / distance)));
+    result.orthogonality = f32_abs(v2f32_cross(coefficients->unit_direction, vector_distance)) / distance;
     result.unclamped_t   = t;
 
     return result;
 }
 
-internal MSDF_Distance msdf_quadratic_bezier_distance_orthogonality(V2F32 point, MSDF_Segment bezier) {
-    V2F32 p  = v2f32_subtract(point, bezier.p0);
-    V2F32 p1 = v2f32_subtract(bezier.p1, bezier.p0);
-    V2F32 p2 = v2f32_add(v2f32_add(bezier.p2, v2f32_scale(bezier.p1, -2)), bezier.p0);
+internal MSDF_Distance msdf_quadratic_bezier_distance_orthogonality(V2F32 point, MSDF_Segment *bezier) {
+    MSDF_SegmentCoefficients *coefficients = &bezier->coefficients;
+
+    V2F32 p  = v2f32_subtract(point, bezier->p0);
+    V2F32 p1 = coefficients->v1;
+    V2F32 p2 = coefficients->v2;
 
-    F32 a = v2f32_length_squared(p2);
-    F32 b = 3.0f * v2f32_dot(p1, p2);
-    F32 c = 2.0f * v2f32_length_squared(p1) - v2f32_dot(p2, p);
+    F32 a = coefficients->a;
+    F32 b = coefficients->b;
+    F32 c = coefficients->c - v2f32_dot(p2, p);
     F32 d = -v2f32_dot(p1, p);
 
     // NOTE: We always need to check both end points of the curve, thus we
@@ -377,7 +666,7 @@ internal MSDF_Distance msdf_quadratic_bezier_distance_orthogonality(V2F32 point,
     for (U32 i = 0; i < solution_count; ++i) {
         F32 t = f32_min(f32_max(0.0f, ts[i]), 1.0f);
 
-        V2F32 vector_distance = v2f32_subtract(point, v2f32_add(v2f32_add(v2f32_scale(p2, t * t), v2f32_scale(p1, 2.0f * t)), bezier.p0));
+        V2F32 vector_distance = v2f32_subtract(point, v2f32_add(v2f32_add(v2f32_scale(p2, t * t), v2f32_scale(p1, 2.0f * t)), bezier->p0));
         F32 distance = v2f32_length_squared(vector_distance);
 
         if (distance < min_distance) {
@@ -399,33 +688,178 @@ internal MSDF_Distance msdf_quadratic_bezier_distance_orthogonality(V2F32 point,
     return result;
 }
 
-internal F32 msdf_line_signed_pseudo_distance(V2F32 point, MSDF_Segment line) {
-    V2F32 length = v2f32_subtract(line.p1, line.p0);
-    F32 t = v2f32_dot(v2f32_subtract(point, line.p0), length) / v2f32_length_squared(length);
-    V2F32 distance = v2f32_subtract(v2f32_add(line.p0, v2f32_scale(length, t)), point);
+// NOTE(simon): The closest point is where f(t) = dot(B(t) - point, B'(t)) / 2
+// is zero, which are the roots of the cubic above. When f is increasing on
+// [0, 1] the squared distance is convex there, so the closest point is
+// either an end point or the only root inside, which a few Newton steps from
+// the seed find while being kept inside of a bracket around it. Everything
+// else falls back to solving the cubic.
+internal MSDF_Distance msdf_quadratic_bezier_distance_orthogonality_seeded(V2F32 point, MSDF_Segment *bezier, F32 *seed) {
+    MSDF_SegmentCoefficients *coefficients = &bezier->coefficients;
+
+    V2F32 p  = v2f32_subtract(point, bezier->p0);
+    V2F32 p1 = coefficients->v1;
+    V2F32 p2 = coefficients->v2;
+
+    F32 a = coefficients->a;
+    F32 b = coefficients->b;
+    F32 c = coefficients->c - v2f32_dot(p2, p);
+    F32 d = -v2f32_dot(p1, p);
+
+    // NOTE(simon): f' is a parabola opening upwards, so its minimum on [0, 1]
+    // is at one of the ends or at its vertex.
+    F32 min_slope = f32_min(c, 3.0f * a + 2.0f * b + c);
+    if (a > 0.0f && 0.0f < -b && -b < 3.0f * a) {
+        min_slope = f32_min(min_slope, c - b * b / (3.0f * a));
+    }
+
+    B32 is_solved = false;
+    F32 t         = 0.0f;
+    if (min_slope > 0.0f) {
+        F32 start_value = d;
+        F32 end_value   = a + b + c + d;
+        if (start_value >= 0.0f) {
+            t         = 0.0f;
+            is_solved = true;
+        } else if (end_value <= 0.0f) {
+            t         = 1.0f;
+            is_solved = true;
+        } else {
+            F32 low  = 0.0f;
+            F32 high = 1.0f;
+            t = (0.0f <= *seed && *seed <= 1.0f ? *seed : start_value / (start_value - end_value));
+            for (U32 step = 0; !is_solved && step < MSDF_NEWTON_STEPS; ++step) {
+                F32 value = ((a * t + b) * t + c) * t + d;
+                F32 slope = (3.0f * a * t + 2.0f * b) * t + c;
+                if (value < 0.0f) {
+                    low = t;
+                } else {
+                    high = t;
+                }
+
+                F32 next_t = t - value / slope;
+                if (!(low < next_t && next_t < high)) {
+                    next_t = 0.5f * (low + high);
+                }
+
+                is_solved = (f32_abs(next_t - t) <= MSDF_NEWTON_TOLERANCE);
+                t         = next_t;
+            }
+        }
+    }
+
+    MSDF_Distance result = { 0 };
+    if (is_solved) {
+        V2F32 vector_distance = v2f32_subtract(point, v2f32_add(v2f32_add(v2f32_scale(p2, t * t), v2f32_scale(p1, 2.0f * t)), bezier->p0));
+        F32   distance        = v2f32_length(vector_distance);
+        V2F32 direction       = v2f32_normalize(v2f32_add(v2f32_scale(p2, t), p1));
+
+        result.distance      = distance;
+        result.orthogonality = f32_abs(v2f32_cross(direction, v2f32_scale(vector_distance, 1.0f / distance)));
+        result.unclamped_t   = t;
+    } else {
+        result = msdf_quadratic_bezier_distance_orthogonality(point, bezier);
+    }
+
+    *seed = result.unclamped_t;
+    return result;
+}
+
+// NOTE(simon): Based on the approach used by msdfgen. There is no closed form
+// for the closest point on a cubic, so we run a few Newton iterations on
+// dot(B(t) - point, B'(t)) = 0 from evenly spaced starting points and keep
+// the closest result, including the end points.
+internal MSDF_Distance msdf_cubic_bezier_distance_orthogonality(V2F32 point, MSDF_Segment *bezier) {
+    MSDF_SegmentCoefficients *coefficients = &bezier->coefficients;
+
+    // B(t) = p0 + 3 * t * ab + 3 * t^2 * br + t^3 * as
+    V2F32 qa = v2f32_subtract(bezier->p0, point);
+    V2F32 ab = coefficients->v1;
+    V2F32 br = coefficients->v2;
+    V2F32 as = coefficients->v3;
+
+    // NOTE(simon): For the end points, t is where the point projects onto the
+    // tangent, but never inside of the curve. This is what decides if the
+    // pseudo distance should extend the curve or not.
+    V2F32 start_direction = coefficients->start_direction;
+    V2F32 end_direction   = coefficients->end_direction;
+
+    F32   min_distance        = v2f32_length_squared(qa);
+    F32   unclamped_t         = f32_min(-v2f32_dot(qa, start_direction) * coefficients->inverse_start_length_squared, 0.0f);
+    V2F32 min_vector_distance = v2f32_negate(qa);
+    V2F32 direction           = start_direction;
+
+    V2F32 end_vector_distance = v2f32_subtract(point, bezier->p3);
+    F32   end_distance        = v2f32_length_squared(end_vector_distance);
+    if (end_distance < min_distance) {
+        min_distance        = end_distance;
+        unclamped_t         = f32_max(1.0f + v2f32_dot(end_vector_distance, end_direction) * coefficients->inverse_end_length_squared, 1.0f);
+        min_vector_distance = end_vector_distance;
+        direction           = end_direction;
+    }
+
+    for (U32 i = 0; i <= MSDF_CUBIC_SEARCH_STARTS; ++i) {
+        F32 t = (F32) i / (F32) MSDF_CUBIC_SEARCH_STARTS;
+        V2F32 qe = v2f32_add(v2f32_add(v2f32_add(qa, v2f32_scale(ab, 3.0f * t)), v2f32_scale(br, 3.0f * t * t)), v2f32_scale(as, t * t * t));
+        for (U32 step = 0; step < MSDF_CUBIC_SEARCH_STEPS; ++step) {
+            V2F32 d1 = v2f32_add(v2f32_add(v2f32_scale(ab, 3.0f), v2f32_scale(br, 6.0f * t)), v2f32_scale(as, 3.0f * t * t));
+            V2F32 d2 = v2f32_add(v2f32_scale(br, 6.0f), v2f32_scale(as, 6.0f * t));
+            t -= v2f32_dot(qe, d1) / (v2f32_dot(d1, d1) + v2f32_dot(qe, d2));
+
+            // NOTE(simon): Also catches NaN from a zero denominator.
+            if (!(0.0f < t && t < 1.0f)) {
+                break;
+            }
+
+            qe = v2f32_add(v2f32_add(v2f32_add(qa, v2f32_scale(ab, 3.0f * t)), v2f32_scale(br, 3.0f * t * t)), v2f32_scale(as, t * t * t));
+            F32 distance = v2f32_length_squared(qe);
+            if (distance < min_distance) {
+                min_distance        = distance;
+                unclamped_t         = t;
+                min_vector_distance = v2f32_negate(qe);
+                direction           = v2f32_add(v2f32_add(v2f32_scale(ab, 3.0f), v2f32_scale(br, 6.0f * t)), v2f32_scale(as, 3.0f * t * t));
+            }
+        }
+    }
+
+    F32 distance = f32_sqrt(min_distance);
+    V2F32 perpendicular = v2f32_scale(min_vector_distance, 1.0f / distance);
+
+    MSDF_Distance result;
+    result.distance      = distance;
+    result.orthogonality = f32_abs(v2f32_cross(v2f32_normalize(direction), perpendicular));
+    result.unclamped_t   = unclamped_t;
+    return result;
+}
+
+internal F32 msdf_line_signed_pseudo_distance(V2F32 point, MSDF_Segment *line) {
+    MSDF_SegmentCoefficients *coefficients = &line->coefficients;
 
-    F32 sign = f32_sign(v2f32_cross(length, distance));
+    F32 t = v2f32_dot(v2f32_subtract(point, line->p0), coefficients->v1) * coefficients->inverse_start_length_squared;
+    V2F32 distance = v2f32_subtract(v2f32_add(line->p0, v2f32_scale(coefficients->v1, t)), point);
+
+    F32 sign = f32_sign(v2f32_cross(coefficients->v1, distance));
     return sign * v2f32_length(distance);
 }
 
-internal F32 msdf_quadratic_bezier_signed_pseudo_distance(V2F32 point, MSDF_Segment bezier, F32 unclamped_t) {
-    V2F32 p  = v2f32_subtract(point, bezier.p0);
-    V2F32 p1 = v2f32_subtract(bezier.p1, bezier.p0);
-    V2F32 p2 = v2f32_add(v2f32_add(bezier.p2, v2f32_scale(bezier.p1, -2)), bezier.p0);
+internal F32 msdf_quadratic_bezier_signed_pseudo_distance(V2F32 point, MSDF_Segment *bezier, F32 unclamped_t) {
+    MSDF_SegmentCoefficients *coefficients = &bezier->coefficients;
 
     V2F32 derivative;
     V2F32 distance;
 
     if (unclamped_t < 0.0f) {
-        derivative = v2f32_subtract(bezier.p1, bezier.p0);
-        F32 t = v2f32_dot(v2f32_subtract(point, bezier.p0), derivative) / v2f32_length_squared(derivative);
-        distance = v2f32_subtract(v2f32_add(bezier.p0, v2f32_scale(derivative, t)), point);
+        derivative = coefficients->start_direction;
+        F32 t = v2f32_dot(v2f32_subtract(point, bezier->p0), derivative) * coefficients->inverse_start_length_squared;
+        distance = v2f32_subtract(v2f32_add(bezier->p0, v2f32_scale(derivative, t)), point);
     } else if (unclamped_t > 1.0f) {
-        derivative = v2f32_subtract(bezier.p2, bezier.p1);
-        F32 t = v2f32_dot(v2f32_subtract(point, bezier.p1), derivative) / v2f32_length_squared(derivative);
-        distance = v2f32_subtract(v2f32_add(bezier.p1, v2f32_scale(derivative, t)), point);
+        derivative = coefficients->end_direction;
+        F32 t = v2f32_dot(v2f32_subtract(point, bezier->p1), derivative) * coefficients->inverse_end_length_squared;
+        distance = v2f32_subtract(v2f32_add(bezier->p1, v2f32_scale(derivative, t)), point);
     } else {
-        distance   = v2f32_subtract(v2f32_add(v2f32_add(v2f32_scale(p2, unclamped_t * unclamped_t), v2f32_scale(p1, 2.0f * unclamped_t)), bezier.p0), point);
+        V2F32 p1 = coefficients->v1;
+        V2F32 p2 = coefficients->v2;
+        distance   = v2f32_subtract(v2f32_add(v2f32_add(v2f32_scale(p2, unclamped_t * unclamped_t), v2f32_scale(p1, 2.0f * unclamped_t)), bezier->p0), point);
         derivative = v2f32_add(v2f32_scale(p2, 2.0f * unclamped_t), v2f32_scale(p1, 2.0f));
     }
 
@@ -433,6 +867,41 @@ internal F32 msdf_quadratic_bezier_signed_pseudo_distance(V2F32 point, MSDF_Segm
     return sign * v2f32_length(distance);
 }
 
+internal F32 msdf_cubic_bezier_signed_pseudo_distance(V2F32 point, MSDF_Segment *bezier, F32 unclamped_t) {
+    MSDF_SegmentCoefficients *coefficients = &bezier->coefficients;
+
+    V2F32 derivative;
+    V2F32 distance;
+
+    if (unclamped_t < 0.0f) {
+        derivative = coefficients->start_direction;
+        F32 t = v2f32_dot(v2f32_subtract(point, bezier->p0), derivative) * coefficients->inverse_start_length_squared;
+        distance = v2f32_subtract(v2f32_add(bezier->p0, v2f32_scale(derivative, t)), point);
+    } else if (unclamped_t > 1.0f) {
+        derivative = coefficients->end_direction;
+        F32 t = v2f32_dot(v2f32_subtract(point, bezier->p3), derivative) * coefficients->inverse_end_length_squared;
+        distance = v2f32_subtract(v2f32_add(bezier->p3, v2f32_scale(derivative, t)), point);
+    } else {
+        // NOTE(simon): B(t) = p0 + 3 * t * ab + 3 * t^2 * br + t^3 * as
+        F32 t = unclamped_t;
+        V2F32 position = v2f32_add(
+            v2f32_add(bezier->p0, v2f32_scale(coefficients->v1, 3.0f * t)),
+            v2f32_add(v2f32_scale(coefficients->v2, 3.0f * t * t), v2f32_scale(coefficients->v3, t * t * t))
+        );
+        distance   = v2f32_subtract(position, point);
+        derivative = v2f32_add(v2f32_add(v2f32_scale(coefficients->v1, 3.0f), v2f32_scale(coefficients->v2, 6.0f * t)), v2f32_scale(coefficients->v3, 3.0f * t * t));
+
+        // NOTE(simon): The derivative vanishes at end points with coinciding
+        // control points.
+        if (v2f32_length_squared(derivative) == 0.0f) {
+            derivative = (t < 0.5f ? coefficients->start_direction : coefficients->end_direction);
+        }
+    }
+
+    F32 sign = f32_sign(v2f32_cross(derivative, distance));
+    return sign * v2f32_length(distance);
+}
+
 internal Void msdf_resolve_contour_overlap(Arena *arena, MSDF_Glyph *glyph) {
     for (MSDF_Contour *a_contour = glyph->first_contour; a_contour; a_contour = a_contour->next) {
         for (MSDF_Contour *b_contour = a_contour->next; b_contour; b_contour = b_contour->next) {
@@ -478,14 +947,14 @@ internal Void msdf_resolve_contour_overlap(Arena *arena, MSDF_Glyph *glyph) {
                     // corners. This can be 0, so we also add a small amount to
                     // ensure that the corners do not overlapp.
                     // TODO: Why is the "small amount" 0.005f? What should it be?
-                    V2F32 *a0_corner    = (a_segment->kind == MSDF_SEGMENT_LINE ? &a_segment->p1 : &a_segment->p2);
-                    V2F32  a0_direction = v2f32_normalize(v2f32_subtract((a_segment->kind == MSDF_SEGMENT_LINE ? a_segment->p0 : a_segment->p1), *a0_corner));
+                    V2F32 *a0_corner    = msdf_segment_end(a_segment);
+                    V2F32  a0_direction = v2f32_normalize(v2f32_subtract(msdf_segment_end_control(*a_segment), *a0_corner));
                     V2F32 *a1_corner    = &a_new->p0;
-                    V2F32  a1_direction = v2f32_normalize(v2f32_subtract(a_new->p1, *a1_corner));
-                    V2F32 *b0_corner    = (b_segment->kind == MSDF_SEGMENT_LINE ? &b_segment->p1 : &b_segment->p2);
-                    V2F32  b0_direction = v2f32_normalize(v2f32_subtract((b_segment->kind == MSDF_SEGMENT_LINE ? b_segment->p0 : b_segment->p1), *b0_corner));
+                    V2F32  a1_direction = v2f32_normalize(v2f32_subtract(msdf_segment_start_control(*a_new), *a1_corner));
+                    V2F32 *b0_corner    = msdf_segment_end(b_segment);
+                    V2F32  b0_direction = v2f32_normalize(v2f32_subtract(msdf_segment_end_control(*b_segment), *b0_corner));
                     V2F32 *b1_corner    = &b_new->p0;
-                    V2F32  b1_direction = v2f32_normalize(v2f32_subtract(b_new->p1, *b1_corner));
+                    V2F32  b1_direction = v2f32_normalize(v2f32_subtract(msdf_segment_start_control(*b_new), *b1_corner));
                     F32    move_amount  = 0.005f + v2f32_length(v2f32_subtract(v2f32_add(*a0_corner, *b1_corner), v2f32_add(*a1_corner, *b0_corner))) * 0.5f;
 
                     if (v2f32_dot(a0_direction, b1_direction) < v2f32_dot(a1_direction, b0_direction)) {
@@ -573,13 +1042,13 @@ internal Void msdf_convert_to_simple_polygons(Arena *arena, MSDF_Glyph *glyph) {
 
                     // Ensure that the contour is connected properly.
                     V2F32 *a0_corner = &a_new->p0;
-                    V2F32 *a1_corner = (b_new->kind == MSDF_SEGMENT_LINE ? &b_new->p1 : &b_new->p2);
+                    V2F32 *a1_corner = msdf_segment_end(b_new);
                     V2F32 a_corner = v2f32_scale(v2f32_add(*a0_corner, *a1_corner), 0.5f);
                     *a0_corner = a_corner;
                     *a1_corner = a_corner;
 
                     V2F32 *b0_corner = &b_segment->p0;
-                    V2F32 *b1_corner = (a_segment->kind == MSDF_SEGMENT_LINE ? &a_segment->p1 : &a_segment->p2);
+                    V2F32 *b1_corner = msdf_segment_end(a_segment);
                     V2F32 b_corner = v2f32_scale(v2f32_add(*b0_corner, *b1_corner), 0.5f);
                     *b0_corner = b_corner;
                     *b1_corner = b_corner;
@@ -628,6 +1097,13 @@ internal Void msdf_correct_contour_orientation(MSDF_Glyph *glyph) {
                     V2F32 temp = segment->p0;
                     segment->p0 = segment->p2;
                     segment->p2 = temp;
+                } else if (segment->kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+                    V2F32 temp = segment->p0;
+                    segment->p0 = segment->p3;
+                    segment->p3 = temp;
+                    temp = segment->p1;
+                    segment->p1 = segment->p2;
+                    segment->p2 = temp;
                 }
 
                 dll_push_back(first_segment, last_segment, segment);
@@ -709,45 +1185,293 @@ internal Void msdf_color_edges(MSDF_Glyph glyph) {
     }
 }
 
-internal MSDF_RasterResult msdf_generate(Arena *arena, TTF_Font *font, U32 codepoint, U32 render_size) {
-    MSDF_RasterResult result = { 0 };
+internal U32 msdf_channel_count_from_format(MSDF_Format format) {
+    U32 result = 0;
+    switch (format) {
+        case MSDF_Format_RGBA8:   result = 4; break;
+        case MSDF_Format_RGB8:    result = 3; break;
+        case MSDF_Format_RGB16:   result = 3; break;
+        case MSDF_Format_RGB16F:  result = 3; break;
+        case MSDF_Format_RGBA16:  result = 4; break;
+        case MSDF_Format_RGBA16F: result = 4; break;
+        case MSDF_Format_R8:      result = 1; break;
+        case MSDF_Format_COUNT:   break;
+    }
+    return result;
+}
+
+internal U32 msdf_pixel_size_from_format(MSDF_Format format) {
+    U32 result = msdf_channel_count_from_format(format);
+    if (format != MSDF_Format_RGBA8 && format != MSDF_Format_RGB8 && format != MSDF_Format_R8) {
+        result *= 2;
+    }
+    return result;
+}
+
+internal Void msdf_store_pixel(U8 *destination, MSDF_Format format, F32 red, F32 green, F32 blue, F32 alpha) {
+    F32 channels[4] = { red, green, blue, alpha };
+    U32 channel_count = msdf_channel_count_from_format(format);
+
+    switch (format) {
+        case MSDF_Format_RGBA8:
+        case MSDF_Format_RGB8:
+        case MSDF_Format_R8: {
+            for (U32 i = 0; i < channel_count; ++i) {
+                destination[i] = (U8) s32_min(s32_max(0, f32_round_to_s32(channels[i] * 255.0f)), 255);
+            }
+        } break;
+        case MSDF_Format_RGB16:
+        case MSDF_Format_RGBA16: {
+            U16 values[4] = { 0 };
+            for (U32 i = 0; i < channel_count; ++i) {
+                values[i] = (U16) s32_min(s32_max(0, f32_round_to_s32(channels[i] * 65535.0f)), 65535);
+            }
+            memory_copy(destination, values, channel_count * sizeof(*values));
+        } break;
+        case MSDF_Format_RGB16F:
+        case MSDF_Format_RGBA16F: {
+            F16 values[4] = { 0 };
+            for (U32 i = 0; i < channel_count; ++i) {
+                values[i] = f16_from_f32(channels[i]);
+            }
+            memory_copy(destination, values, channel_count * sizeof(*values));
+        } break;
+        case MSDF_Format_COUNT: {
+        } break;
+    }
+}
+
+// NOTE(simon): Two neighbouring texels clash if the channel with the second
+// largest difference between them changes by more than the threshold, which
+// makes the median interpolate to a wrong value in between. Only the texel
+// farther away from the edge is flagged. This is the clash detection from
+// Chlumsky's thesis.
+internal B32 msdf_texels_clash(V4F32 a, V4F32 b, F32 threshold) {
+    F32 a0 = a.x, a1 = a.y, a2 = a.z;
+    F32 b0 = b.x, b1 = b.y, b2 = b.z;
+
+    // NOTE(simon): Sort the channel pairs by decreasing difference.
+    if (f32_abs(b0 - a0) < f32_abs(b1 - a1)) {
+        swap(a0, a1, F32);
+        swap(b0, b1, F32);
+    }
+    if (f32_abs(b1 - a1) < f32_abs(b2 - a2)) {
+        swap(a1, a2, F32);
+        swap(b1, b2, F32);
+        if (f32_abs(b0 - a0) < f32_abs(b1 - a1)) {
+            swap(a0, a1, F32);
+            swap(b0, b1, F32);
+        }
+    }
+
+    B32 result =
+        f32_abs(b1 - a1) >= threshold &&
+        !(b0 == b1 && b0 == b2) &&
+        f32_abs(a2 - 0.5f) >= f32_abs(b2 - 0.5f);
+    return result;
+}
 
+internal Void msdf_correct_errors(Arena *arena, V4F32 *pixels, U32 width, U32 height, F32 threshold) {
+    Arena_Temporary scratch = arena_get_scratch(&arena, 1);
+
+    // NOTE(simon): Detect everything before correcting anything, so that
+    // corrected texels don't affect their neighbours.
+    U8 *clashes = arena_push_array_zero(scratch.arena, U8, width * height);
+    // NOTE(simon): Diagonal neighbours are sqrt(2) texels away, so their
+    // distances are allowed to differ by that much more.
+    F32 diagonal_threshold = F32_SQRT2 * threshold;
+    for (U32 y = 0; y < height; ++y) {
+        for (U32 x = 0; x < width; ++x) {
+            U32   index = y * width + x;
+            V4F32 pixel = pixels[index];
+
+            B32 has_left  = x > 0;
+            B32 has_right = x + 1 < width;
+            B32 has_down  = y > 0;
+            B32 has_up    = y + 1 < height;
+
+            clashes[index] =
+                (has_left  && msdf_texels_clash(pixel, pixels[index - 1],     threshold)) ||
+                (has_right && msdf_texels_clash(pixel, pixels[index + 1],     threshold)) ||
+                (has_down  && msdf_texels_clash(pixel, pixels[index - width], threshold)) ||
+                (has_up    && msdf_texels_clash(pixel, pixels[index + width], threshold)) ||
+                (has_left  && has_down && msdf_texels_clash(pixel, pixels[index - width - 1], diagonal_threshold)) ||
+                (has_right && has_down && msdf_texels_clash(pixel, pixels[index - width + 1], diagonal_threshold)) ||
+                (has_left  && has_up   && msdf_texels_clash(pixel, pixels[index + width - 1], diagonal_threshold)) ||
+                (has_right && has_up   && msdf_texels_clash(pixel, pixels[index + width + 1], diagonal_threshold));
+        }
+    }
+
+    // NOTE(simon): Collapsing a texel to its median turns it into a regular
+    // single channel distance, which always interpolates correctly.
+    for (U32 i = 0; i < width * height; ++i) {
+        if (clashes[i]) {
+            V4F32 *pixel  = &pixels[i];
+            F32    median = f32_max(f32_min(pixel->x, pixel->y), f32_min(f32_max(pixel->x, pixel->y), pixel->z));
+            pixel->x = median;
+            pixel->y = median;
+            pixel->z = median;
+        }
+    }
+
+    arena_end_temporary(scratch);
+}
+
+internal F32 msdf_chord_distance(V2F32 point, V2F32 a, V2F32 b) {
+    V2F32 length         = v2f32_subtract(b, a);
+    F32   length_squared = v2f32_length_squared(length);
+
+    F32 t = 0.0f;
+    if (length_squared > 0.0f) {
+        t = f32_min(f32_max(0.0f, v2f32_dot(v2f32_subtract(point, a), length) / length_squared), 1.0f);
+    }
+
+    F32 result = v2f32_length(v2f32_subtract(point, v2f32_add(a, v2f32_scale(length, t))));
+    return result;
+}
+
+internal Void msdf_simplify_glyph(MSDF_Glyph *glyph, V2F32 pixel_size) {
+    F32 tolerance = MSDF_SIMPLIFY_TOLERANCE * f32_min(pixel_size.x, pixel_size.y);
+
+    MSDF_Contour *next_contour = 0;
+    for (MSDF_Contour *contour = glyph->first_contour; contour; contour = next_contour) {
+        next_contour = contour->next;
+
+        // NOTE(simon): Curves lie within the convex hull of their control
+        // points, so this bounds the whole contour.
+        V2F32 min = v2f32(f32_infinity(), f32_infinity());
+        V2F32 max = v2f32(-f32_infinity(), -f32_infinity());
+        for (MSDF_Segment *segment = contour->first_segment; segment; segment = segment->next) {
+            V2F32 points[] = { segment->p0, segment->p1, segment->p2, segment->p3 };
+            U32 point_count = (segment->kind == MSDF_SEGMENT_LINE ? 2 : (segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER ? 3 : 4));
+            for (U32 i = 0; i < point_count; ++i) {
+                min = v2f32_min(min, points[i]);
+                max = v2f32_max(max, points[i]);
+            }
+        }
+
+        if (max.x - min.x <= MSDF_SIMPLIFY_MIN_CONTOUR_SIZE * pixel_size.x && max.y - min.y <= MSDF_SIMPLIFY_MIN_CONTOUR_SIZE * pixel_size.y) {
+            dll_remove(glyph->first_contour, glyph->last_contour, contour);
+            continue;
+        }
+
+        // NOTE(simon): For the same reason, a curve whose control points are
+        // all within tolerance of the chord is itself within tolerance of it.
+        for (MSDF_Segment *segment = contour->first_segment; segment; segment = segment->next) {
+            if (segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER || segment->kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+                V2F32 end     = *msdf_segment_end(segment);
+                B32   is_flat = msdf_chord_distance(segment->p1, segment->p0, end) <= tolerance;
+                if (segment->kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+                    is_flat = is_flat && msdf_chord_distance(segment->p2, segment->p0, end) <= tolerance;
+                }
+
+                if (is_flat) {
+                    segment->kind = MSDF_SEGMENT_LINE;
+                    segment->p1   = end;
+                }
+            }
+        }
+
+        // NOTE(simon): Short lines are removed, and the following segment is
+        // moved to start where they did to keep the contour closed.
+        MSDF_Segment *next_segment = 0;
+        for (MSDF_Segment *segment = contour->first_segment; segment; segment = next_segment) {
+            next_segment = segment->next;
+
+            if (segment->kind == MSDF_SEGMENT_LINE && v2f32_length(v2f32_subtract(segment->p1, segment->p0)) <= tolerance) {
+                MSDF_Segment *following = (next_segment ? next_segment : contour->first_segment);
+                following->p0 = segment->p0;
+                dll_remove(contour->first_segment, contour->last_segment, segment);
+            }
+        }
+
+        // NOTE(simon): Runs of lines are merged as long as every point that is
+        // removed stays within tolerance of the merged line, and every line in
+        // the run goes in the same direction as it.
+        for (MSDF_Segment *start = contour->first_segment; start; start = start->next) {
+            if (start->kind != MSDF_SEGMENT_LINE) {
+                continue;
+            }
+
+            MSDF_Segment *end = start;
+            for (MSDF_Segment *candidate = start->next; candidate && candidate->kind == MSDF_SEGMENT_LINE; candidate = candidate->next) {
+                V2F32 direction = v2f32_subtract(candidate->p1, start->p0);
+
+                B32 is_collinear = true;
+                for (MSDF_Segment *inner = start; is_collinear && inner != candidate->next; inner = inner->next) {
+                    is_collinear = v2f32_dot(v2f32_subtract(inner->p1, inner->p0), direction) > 0.0f;
+                    if (inner != candidate) {
+                        is_collinear = is_collinear && msdf_chord_distance(inner->p1, start->p0, candidate->p1) <= tolerance;
+                    }
+                }
+
+                if (!is_collinear) {
+                    break;
+                }
+                end = candidate;
+            }
+
+            if (end != start) {
+                start->p1 = end->p1;
+
+                MSDF_Segment *stop = end->next;
+                while (start->next != stop) {
+                    MSDF_Segment *removed = start->next;
+                    dll_remove(contour->first_segment, contour->last_segment, removed);
+                }
+            }
+        }
+
+        if (!contour->first_segment) {
+            dll_remove(glyph->first_contour, glyph->last_contour, contour);
+        }
+    }
+}
+
+internal MSDF_PreparedGlyph *msdf_prepare_glyph(Arena *arena, TTF_Font *font, U32 glyph_index, U32 render_size, MSDF_Mode mode) {
     Arena_Temporary scratch = arena_get_scratch(&arena, 1);
 
-    U32 glyph_index = ttf_get_glyph_index(font, codepoint);
     MSDF_Glyph glyph = ttf_expand_contours_to_msdf(scratch.arena, font, glyph_index);
-    TTF_HmtxMetrics metrics = ttf_get_metrics(font, glyph_index);
 
-    result.x_min             = (F32)  glyph.x_min / (F32) font->funits_per_em;
-    result.y_min             = (F32) -glyph.y_max / (F32) font->funits_per_em;
-    result.x_max             = (F32)  glyph.x_max / (F32) font->funits_per_em;
-    result.y_max             = (F32) -glyph.y_min / (F32) font->funits_per_em;
-    result.advance_width     = (F32) metrics.advance_width / (F32) font->funits_per_em;
-    result.left_side_bearing = (F32) metrics.left_side_bearing / (F32) font->funits_per_em;
+    // NOTE(simon): The rasterizer stretches the bounds of the glyph to fill
+    // the render size, so this is an upper bound for the size of a pixel.
+    V2F32 pixel_size = v2f32(
+        (F32) (glyph.x_max - glyph.x_min) / (F32) render_size,
+        (F32) (glyph.y_max - glyph.y_min) / (F32) render_size
+    );
+    msdf_simplify_glyph(&glyph, pixel_size);
 
     msdf_resolve_contour_overlap(scratch.arena, &glyph);
     msdf_convert_to_simple_polygons(scratch.arena, &glyph);
     msdf_correct_contour_orientation(&glyph);
-    msdf_color_edges(glyph);
 
-    // NOTE(simon): We no longer need the segments to be organized in curves or
-    // have any order amongst themselves. Separate them by kind to ease
-    // processing.
-    MSDF_SegmentList lines        = { 0 };
-    MSDF_SegmentList quad_beziers = { 0 };
-    for (MSDF_Contour *contour = glyph.first_contour; contour; contour = contour->next) {
-        for (MSDF_Segment *segment = contour->first_segment, *next; segment; segment = next) {
-            next = segment->next;
+    if (mode == MSDF_Mode_SDF) {
+        for (MSDF_Contour *contour = glyph.first_contour; contour; contour = contour->next) {
+            for (MSDF_Segment *segment = contour->first_segment; segment; segment = segment->next) {
+                segment->flags = MSDF_COLOR_RED | MSDF_COLOR_GREEN | MSDF_COLOR_BLUE;
+            }
+        }
+    } else {
+        msdf_color_edges(glyph);
+    }
 
+    U32 line_count             = 0;
+    U32 quadratic_bezier_count = 0;
+    U32 cubic_bezier_count     = 0;
+    for (MSDF_Contour *contour = glyph.first_contour; contour; contour = contour->next) {
+        for (MSDF_Segment *segment = contour->first_segment; segment; segment = segment->next) {
             switch (segment->kind) {
                 case MSDF_SEGMENT_NULL: {
                     assert(!"Not reached");
                 } break;
                 case MSDF_SEGMENT_LINE: {
-                    dll_push_back(lines.first, lines.last, segment);
+                    ++line_count;
                 } break;
                 case MSDF_SEGMENT_QUADRATIC_BEZIER: {
-                    dll_push_back(quad_beziers.first, quad_beziers.last, segment);
+                    ++quadratic_bezier_count;
+                } break;
+                case MSDF_SEGMENT_CUBIC_BEZIER: {
+                    ++cubic_bezier_count;
                 } break;
                 case MSDF_SEGMENT_KIND_COUNT: {
                     assert(!"Not reached");
@@ -756,21 +1480,782 @@ internal MSDF_RasterResult msdf_generate(Arena *arena, TTF_Font *font, U32 codep
         }
     }
 
+    MSDF_PreparedGlyph *result = arena_push_struct_zero(arena, MSDF_PreparedGlyph);
+    result->x_min                  = glyph.x_min;
+    result->y_min                  = glyph.y_min;
+    result->x_max                  = glyph.x_max;
+    result->y_max                  = glyph.y_max;
+    result->metrics                = ttf_get_metrics(font, glyph_index);
+    result->funits_per_em          = font->funits_per_em;
+    result->line_count             = line_count;
+    result->quadratic_bezier_count = quadratic_bezier_count;
+    result->cubic_bezier_count     = cubic_bezier_count;
+    result->segments               = arena_push_array(arena, MSDF_PreparedSegment, line_count + quadratic_bezier_count + cubic_bezier_count);
+
+    // NOTE(simon): We no longer need the segments to be organized in curves or
+    // have any order amongst themselves. Separate them by kind to ease
+    // processing.
+    MSDF_PreparedSegment *lines        = &result->segments[0];
+    MSDF_PreparedSegment *quad_beziers  = &result->segments[line_count];
+    MSDF_PreparedSegment *cubic_beziers = &result->segments[line_count + quadratic_bezier_count];
+    for (MSDF_Contour *contour = glyph.first_contour; contour; contour = contour->next) {
+        for (MSDF_Segment *segment = contour->first_segment; segment; segment = segment->next) {
+            MSDF_PreparedSegment *prepared = 0;
+            if (segment->kind == MSDF_SEGMENT_LINE) {
+                prepared = lines++;
+            } else if (segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
+                prepared = quad_beziers++;
+            } else {
+                prepared = cubic_beziers++;
+            }
+            prepared->p0    = segment->p0;
+            prepared->p1    = segment->p1;
+            prepared->p2    = segment->p2;
+            prepared->p3    = segment->p3;
+            prepared->flags = segment->flags;
+        }
+    }
+
+    arena_end_temporary(scratch);
+    return result;
+}
+
+internal MSDF_PreparedGlyph *msdf_get_prepared_glyph(Arena *arena, TTF_Font *font, U32 glyph_index, U32 render_size, MSDF_Mode mode) {
+    // NOTE(simon): Simplification depends on the render size, but a glyph
+    // prepared for a larger size works for smaller ones too. Rounding up to a
+    // power of 2 means a glyph is prepared once per size class instead of once
+    // per size, at the cost of simplifying up to half as much.
+    U32 prepared_size = 1u << (32 - u32_leading_zeros(u32_max(render_size, 1) - 1));
+
+    // NOTE(simon): Glyph indices are 16-bit, and only SDF is prepared
+    // differently from the other modes.
+    U64 key = (U64) prepared_size << 32 | (U64) (mode == MSDF_Mode_SDF) << 16 | glyph_index;
+
+    Void *cached = 0;
+    if (cache_lookup(font->prepared_cache, key, &cached)) {
+        return (MSDF_PreparedGlyph *) cached;
+    }
+
+    // NOTE(simon): Preparing never waits on another prepared glyph, so unlike
+    // the outline cache we can hold the entry while doing the work and other
+    // threads wait for us instead of preparing the same glyph again.
+    Cache_Ticket ticket = { 0 };
+    if (cache_acquire(font->prepared_cache, key, &cached, &ticket)) {
+        return (MSDF_PreparedGlyph *) cached;
+    }
+
+    // NOTE(simon): The cache is full, copying into the cache arena would only
+    // leak memory that is never reused.
+    if (!ticket.slot) {
+        return msdf_prepare_glyph(arena, font, glyph_index, prepared_size, mode);
+    }
+
+    Arena_Temporary scratch = arena_get_scratch(0, 0);
+    MSDF_PreparedGlyph *prepared = msdf_prepare_glyph(scratch.arena, font, glyph_index, prepared_size, mode);
+    U32 segment_count = prepared->line_count + prepared->quadratic_bezier_count + prepared->cubic_bezier_count;
+
+    while (atomic_u32_compare_exchange(&font->cache_lock, 0, 1) != 0) {
+        os_thread_yield();
+    }
+
+    MSDF_PreparedGlyph *result = arena_push_struct(font->cache_arena, MSDF_PreparedGlyph);
+    *result = *prepared;
+    result->segments = arena_push_array(font->cache_arena, MSDF_PreparedSegment, segment_count);
+
+    atomic_u32_store(&font->cache_lock, 0);
+
+    memory_copy(result->segments, prepared->segments, segment_count * sizeof(MSDF_PreparedSegment));
+    arena_end_temporary(scratch);
+
+    cache_publish(ticket, result);
+    return result;
+}
+
+global MSDF_Segment msdf_nil_segment = { 0 };
+
+// NOTE(simon): Finds the closest of the candidate segments and evaluates the
+// true signed distance to it, with the sign of its pseudo-distance. The
+// channels of the result are all the same.
+internal MSDF_Sample msdf_sample_sdf(MSDF_Segment *segments, MSDF_CandidateList *candidates, F32 *seeds, V2F32 point, F32 distance_range) {
+    U32 *lines         = candidates->indices;
+    U32 *quad_beziers  = lines + candidates->line_count;
+    U32 *cubic_beziers = quad_beziers + candidates->bezier_count;
+
+    MSDF_Distance closest_distance = { .distance = f32_infinity(), .orthogonality = 0.0f };
+    MSDF_Segment *closest_segment  = &msdf_nil_segment;
+
+    for (U32 i = 0; i < candidates->line_count; ++i) {
+        MSDF_Segment *line = &segments[lines[i]];
+        F32 min_distance = v2f32_length_squared(v2f32_subtract(line->circle_center, point));
+
+        F32 bound = closest_distance.distance + line->circle_radius;
+        if (bound * bound >= min_distance) {
+            MSDF_Distance distance = msdf_line_distance_orthogonality(point, line);
+            if (msdf_distance_is_closer(distance, closest_distance)) {
+                closest_distance = distance;
+                closest_segment  = line;
+            }
+        }
+    }
+
+    for (U32 i = 0; i < candidates->bezier_count; ++i) {
+        MSDF_Segment *bezier = &segments[quad_beziers[i]];
+        F32 min_distance = v2f32_length_squared(v2f32_subtract(bezier->circle_center, point));
+
+        F32 bound = closest_distance.distance + bezier->circle_radius;
+        if (bound * bound >= min_distance) {
+            MSDF_Distance distance = { 0 };
+            if (seeds) {
+                distance = msdf_quadratic_bezier_distance_orthogonality_seeded(point, bezier, &seeds[quad_beziers[i]]);
+            } else {
+                distance = msdf_quadratic_bezier_distance_orthogonality(point, bezier);
+            }
+
+            if (msdf_distance_is_closer(distance, closest_distance)) {
+                closest_distance = distance;
+                closest_segment  = bezier;
+            }
+        }
+    }
+
+    for (U32 i = 0; i < candidates->cubic_bezier_count; ++i) {
+        MSDF_Segment *bezier = &segments[cubic_beziers[i]];
+        F32 min_distance = v2f32_length_squared(v2f32_subtract(bezier->circle_center, point));
+
+        F32 bound = closest_distance.distance + bezier->circle_radius;
+        if (bound * bound >= min_distance) {
+            MSDF_Distance distance = msdf_cubic_bezier_distance_orthogonality(point, bezier);
+            if (msdf_distance_is_closer(distance, closest_distance)) {
+                closest_distance = distance;
+                closest_segment  = bezier;
+            }
+        }
+    }
+
+    F32 pseudo_distance = 0.0f;
+    if (closest_segment->kind == MSDF_SEGMENT_LINE) {
+        pseudo_distance = msdf_line_signed_pseudo_distance(point, closest_segment);
+    } else if (closest_segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
+        pseudo_distance = msdf_quadratic_bezier_signed_pseudo_distance(point, closest_segment, closest_distance.unclamped_t);
+    } else if (closest_segment->kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        pseudo_distance = msdf_cubic_bezier_signed_pseudo_distance(point, closest_segment, closest_distance.unclamped_t);
+    }
+
+    F32 value = f32_sign(pseudo_distance) * closest_distance.distance / distance_range + 0.5f;
+
+    MSDF_Sample result = { 0 };
+    result.value          = v4f32(value, value, value, value);
+    result.red_segment    = closest_segment;
+    result.green_segment  = closest_segment;
+    result.blue_segment   = closest_segment;
+    result.true_segment   = closest_segment;
+    result.red_distance   = closest_distance.distance;
+    result.green_distance = closest_distance.distance;
+    result.blue_distance  = closest_distance.distance;
+
+    return result;
+}
+
+// NOTE(simon): Finds the closest of the candidate segments for each channel
+// and evaluates the signed pseudo-distances to them.
+internal MSDF_Sample msdf_sample(MSDF_Segment *segments, MSDF_CandidateList *candidates, F32 *seeds, V2F32 point, F32 distance_range, MSDF_Mode mode) {
+    if (mode == MSDF_Mode_SDF) {
+        return msdf_sample_sdf(segments, candidates, seeds, point, distance_range);
+    }
+
+    U32 *lines         = candidates->indices;
+    U32 *quad_beziers  = lines + candidates->line_count;
+    U32 *cubic_beziers = quad_beziers + candidates->bezier_count;
+
+    MSDF_Distance red_distance   = { .distance = f32_infinity(), .orthogonality = 0.0f };
+    MSDF_Segment *red_segment    = &msdf_nil_segment;
+    MSDF_Distance green_distance = { .distance = f32_infinity(), .orthogonality = 0.0f };
+    MSDF_Segment *green_segment  = &msdf_nil_segment;
+    MSDF_Distance blue_distance  = { .distance = f32_infinity(), .orthogonality = 0.0f };
+    MSDF_Segment *blue_segment   = &msdf_nil_segment;
+
+    for (U32 i = 0; i < candidates->line_count; ++i) {
+        MSDF_Segment *line = &segments[lines[i]];
+        F32 min_distance = v2f32_length_squared(v2f32_subtract(line->circle_center, point));
+
+        F32 red   = red_distance.distance   + line->circle_radius;
+        F32 green = green_distance.distance + line->circle_radius;
+        F32 blue  = blue_distance.distance  + line->circle_radius;
+        if (red * red >= min_distance || green * green >= min_distance || blue * blue >= min_distance) {
+            MSDF_Distance distance = msdf_line_distance_orthogonality(point, line);
+
+            if ((line->flags & MSDF_COLOR_RED) && msdf_distance_is_closer(distance, red_distance)) {
+                red_distance = distance;
+                red_segment  = line;
+            }
+            if ((line->flags & MSDF_COLOR_GREEN) && msdf_distance_is_closer(distance, green_distance)) {
+                green_distance = distance;
+                green_segment  = line;
+            }
+            if ((line->flags & MSDF_COLOR_BLUE) && msdf_distance_is_closer(distance, blue_distance)) {
+                blue_distance = distance;
+                blue_segment  = line;
+            }
+        }
+    }
+
+    for (U32 i = 0; i < candidates->bezier_count; ++i) {
+        MSDF_Segment *bezier = &segments[quad_beziers[i]];
+        F32 min_distance = v2f32_length_squared(v2f32_subtract(bezier->circle_center, point));
+
+        F32 red   = red_distance.distance   + bezier->circle_radius;
+        F32 green = green_distance.distance + bezier->circle_radius;
+        F32 blue  = blue_distance.distance  + bezier->circle_radius;
+        if (red * red >= min_distance || green * green >= min_distance || blue * blue >= min_distance) {
+            MSDF_Distance distance = { 0 };
+            if (seeds) {
+                distance = msdf_quadratic_bezier_distance_orthogonality_seeded(point, bezier, &seeds[quad_beziers[i]]);
+            } else {
+                distance = msdf_quadratic_bezier_distance_orthogonality(point, bezier);
+            }
+
+            if ((bezier->flags & MSDF_COLOR_RED) && msdf_distance_is_closer(distance, red_distance)) {
+                red_distance = distance;
+                red_segment  = bezier;
+            }
+            if ((bezier->flags & MSDF_COLOR_GREEN) && msdf_distance_is_closer(distance, green_distance)) {
+                green_distance = distance;
+                green_segment  = bezier;
+            }
+            if ((bezier->flags & MSDF_COLOR_BLUE) && msdf_distance_is_closer(distance, blue_distance)) {
+                blue_distance = distance;
+                blue_segment  = bezier;
+            }
+        }
+    }
+
+    for (U32 i = 0; i < candidates->cubic_bezier_count; ++i) {
+        MSDF_Segment *bezier = &segments[cubic_beziers[i]];
+        F32 min_distance = v2f32_length_squared(v2f32_subtract(bezier->circle_center, point));
+
+        F32 red   = red_distance.distance   + bezier->circle_radius;
+        F32 green = green_distance.distance + bezier->circle_radius;
+        F32 blue  = blue_distance.distance  + bezier->circle_radius;
+        if (red * red >= min_distance || green * green >= min_distance || blue * blue >= min_distance) {
+            MSDF_Distance distance = msdf_cubic_bezier_distance_orthogonality(point, bezier);
+
+            if ((bezier->flags & MSDF_COLOR_RED) && msdf_distance_is_closer(distance, red_distance)) {
+                red_distance = distance;
+                red_segment  = bezier;
+            }
+            if ((bezier->flags & MSDF_COLOR_GREEN) && msdf_distance_is_closer(distance, green_distance)) {
+                green_distance = distance;
+                green_segment  = bezier;
+            }
+            if ((bezier->flags & MSDF_COLOR_BLUE) && msdf_distance_is_closer(distance, blue_distance)) {
+                blue_distance = distance;
+                blue_segment  = bezier;
+            }
+        }
+    }
+
+    // NOTE(simon): Every segment has at least one color, so the closest
+    // of the channel winners is the closest segment overall. We only
+    // need to remember which channel it came from, as the sign of its
+    // pseudo-distance is also the sign of the true distance.
+    MSDF_Distance true_distance        = red_distance;
+    F32          *true_pseudo_distance = &red_distance.distance;
+    MSDF_Segment *true_segment         = red_segment;
+    if (msdf_distance_is_closer(green_distance, true_distance)) {
+        true_distance        = green_distance;
+        true_pseudo_distance = &green_distance.distance;
+        true_segment         = green_segment;
+    }
+    if (msdf_distance_is_closer(blue_distance, true_distance)) {
+        true_distance        = blue_distance;
+        true_pseudo_distance = &blue_distance.distance;
+        true_segment         = blue_segment;
+    }
+
+    F32 red_true_distance   = red_distance.distance;
+    F32 green_true_distance = green_distance.distance;
+    F32 blue_true_distance  = blue_distance.distance;
+
+    if (red_segment->kind == MSDF_SEGMENT_LINE) {
+        red_distance.distance = msdf_line_signed_pseudo_distance(point, red_segment);
+    } else if (red_segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
+        red_distance.distance = msdf_quadratic_bezier_signed_pseudo_distance(point, red_segment, red_distance.unclamped_t);
+    } else if (red_segment->kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        red_distance.distance = msdf_cubic_bezier_signed_pseudo_distance(point, red_segment, red_distance.unclamped_t);
+    }
+    if (green_segment->kind == MSDF_SEGMENT_LINE) {
+        green_distance.distance = msdf_line_signed_pseudo_distance(point, green_segment);
+    } else if (green_segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
+        green_distance.distance = msdf_quadratic_bezier_signed_pseudo_distance(point, green_segment, green_distance.unclamped_t);
+    } else if (green_segment->kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        green_distance.distance = msdf_cubic_bezier_signed_pseudo_distance(point, green_segment, green_distance.unclamped_t);
+    }
+    if (blue_segment->kind == MSDF_SEGMENT_LINE) {
+        blue_distance.distance = msdf_line_signed_pseudo_distance(point, blue_segment);
+    } else if (blue_segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
+        blue_distance.distance = msdf_quadratic_bezier_signed_pseudo_distance(point, blue_segment, blue_distance.unclamped_t);
+    } else if (blue_segment->kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+        blue_distance.distance = msdf_cubic_bezier_signed_pseudo_distance(point, blue_segment, blue_distance.unclamped_t);
+    }
+
+    F32 alpha = 0.0f;
+    if (mode == MSDF_Mode_MTSDF) {
+        alpha = f32_sign(*true_pseudo_distance) * true_distance.distance / distance_range + 0.5f;
+    }
+
+    MSDF_Sample result = { 0 };
+    result.value = v4f32(
+        red_distance.distance   / distance_range + 0.5f,
+        green_distance.distance / distance_range + 0.5f,
+        blue_distance.distance  / distance_range + 0.5f,
+        alpha
+    );
+    result.red_segment   = red_segment;
+    result.green_segment = green_segment;
+    result.blue_segment  = blue_segment;
+    result.true_segment   = true_segment;
+    result.red_distance   = red_true_distance;
+    result.green_distance = green_true_distance;
+    result.blue_distance  = blue_true_distance;
+
+    return result;
+}
+
+internal F32 msdf_segment_distance(V2F32 point, MSDF_Segment *segment) {
+    F32 result = f32_infinity();
+    switch (segment->kind) {
+        case MSDF_SEGMENT_NULL:             assert(!"Not reached!");                                                   break;
+        case MSDF_SEGMENT_LINE:             result = msdf_line_distance_orthogonality(point, segment).distance;             break;
+        case MSDF_SEGMENT_QUADRATIC_BEZIER: result = msdf_quadratic_bezier_distance_orthogonality(point, segment).distance; break;
+        case MSDF_SEGMENT_CUBIC_BEZIER:     result = msdf_cubic_bezier_distance_orthogonality(point, segment).distance;     break;
+        case MSDF_SEGMENT_KIND_COUNT:       assert(!"Not reached!");                                                   break;
+    }
+    return result;
+}
+
+internal MSDF_Sample *msdf_adaptive_sample(MSDF_AdaptiveRaster *raster, MSDF_CandidateList *candidates, U32 x, U32 y) {
+    U32 index = (y - raster->first_row) * raster->render_size + x;
+    if (!raster->is_sampled[index]) {
+        V2F32 point = v2f32((x + 0.5f) / (F32) raster->render_size, (y + 0.5f) / (F32) raster->render_size);
+        raster->samples[index]    = msdf_sample(raster->segments, candidates, raster->seeds, point, raster->distance_range, raster->mode);
+        raster->is_sampled[index] = true;
+    }
+    return &raster->samples[index];
+}
+
+// NOTE(simon): Distances are 1-Lipschitz, so the distance from any point
+// within half_diagonal of center is at least the distance from center minus
+// half_diagonal. The exact distance is only evaluated when the bounding
+// circle isn't enough to show that the segment is farther away than
+// threshold.
+internal F32 msdf_segment_lower_bound(MSDF_Segment *segment, V2F32 center, F32 half_diagonal, F32 threshold) {
+    F32 result = v2f32_length(v2f32_subtract(segment->circle_center, center)) - segment->circle_radius - half_diagonal;
+    if (result <= threshold) {
+        result = msdf_segment_distance(center, segment) - half_diagonal;
+    }
+    return result;
+}
+
+// NOTE(simon): The closest distance of a channel is also 1-Lipschitz, so
+// inside of the block it is at most its largest value at the corners plus
+// half the diagonal. Segments that are farther away than that from the whole
+// block for all of their colors can't win anywhere inside of it. The order of
+// the candidates is kept so that ties are broken the same way.
+internal Void msdf_cull_candidates(MSDF_AdaptiveRaster *raster, MSDF_CandidateList *candidates, MSDF_Sample **samples, V2F32 center, F32 half_diagonal, MSDF_CandidateList *result) {
+    F32 red_bound   = 0.0f;
+    F32 green_bound = 0.0f;
+    F32 blue_bound  = 0.0f;
+    for (U32 i = 0; i < 4; ++i) {
+        red_bound   = f32_max(red_bound,   samples[i]->red_distance);
+        green_bound = f32_max(green_bound, samples[i]->green_distance);
+        blue_bound  = f32_max(blue_bound,  samples[i]->blue_distance);
+    }
+    red_bound   += half_diagonal + MSDF_ADAPTIVE_MARGIN;
+    green_bound += half_diagonal + MSDF_ADAPTIVE_MARGIN;
+    blue_bound  += half_diagonal + MSDF_ADAPTIVE_MARGIN;
+
+    U32 kind_counts[] = { candidates->line_count, candidates->bezier_count, candidates->cubic_bezier_count };
+    U32 result_counts[3] = { 0 };
+    U32 candidate_index  = 0;
+    U32 result_index     = 0;
+    for (U32 kind = 0; kind < 3; ++kind) {
+        for (U32 i = 0; i < kind_counts[kind]; ++i) {
+            U32           index   = candidates->indices[candidate_index++];
+            MSDF_Segment *segment = &raster->segments[index];
+
+            F32 threshold = 0.0f;
+            if (segment->flags & MSDF_COLOR_RED) {
+                threshold = f32_max(threshold, red_bound);
+            }
+            if (segment->flags & MSDF_COLOR_GREEN) {
+                threshold = f32_max(threshold, green_bound);
+            }
+            if (segment->flags & MSDF_COLOR_BLUE) {
+                threshold = f32_max(threshold, blue_bound);
+            }
+
+            if (msdf_segment_lower_bound(segment, center, half_diagonal, threshold) <= threshold) {
+                result->indices[result_index++] = index;
+                ++result_counts[kind];
+            }
+        }
+    }
+
+    result->line_count         = result_counts[0];
+    result->bezier_count       = result_counts[1];
+    result->cubic_bezier_count = result_counts[2];
+}
+
+// NOTE(simon): Distance to a segment is convex, so the largest distance from
+// the winner to any point in the block is found at one of the corners. If
+// every other candidate of the colors is farther away than that from all of
+// the block, the winner can't change inside of it.
+internal B32 msdf_segment_wins_block(MSDF_AdaptiveRaster *raster, MSDF_CandidateList *candidates, MSDF_Segment *winner, MSDF_ColorFlags colors, F32 max_distance, V2F32 center, F32 half_diagonal) {
+    U32 candidate_count = candidates->line_count + candidates->bezier_count + candidates->cubic_bezier_count;
+    F32 threshold       = max_distance + MSDF_ADAPTIVE_MARGIN;
+
+    B32 result = true;
+    for (U32 i = 0; result && i < candidate_count; ++i) {
+        MSDF_Segment *segment = &raster->segments[candidates->indices[i]];
+        if (segment != winner && (segment->flags & colors)) {
+            result = (msdf_segment_lower_bound(segment, center, half_diagonal, threshold) > threshold);
+        }
+    }
+
+    return result;
+}
+
+// NOTE(simon): The pseudo-distance to a line is an affine function of the
+// position, so if the same lines win every channel throughout a block, its
+// pixels are exactly the bilinear interpolation of its corners. The true
+// distance used by MTSDF and SDF is only affine when the closest point stays
+// inside of the line, away from its end points. SDF has nothing else to check.
+internal B32 msdf_block_is_affine(MSDF_AdaptiveRaster *raster, MSDF_CandidateList *candidates, MSDF_Sample **samples, V2F32 *corners, V2F32 center, F32 half_diagonal) {
+    MSDF_Sample *first = samples[0];
+
+    B32 result =
+        first->red_segment->kind   == MSDF_SEGMENT_LINE &&
+        first->green_segment->kind == MSDF_SEGMENT_LINE &&
+        first->blue_segment->kind  == MSDF_SEGMENT_LINE;
+    for (U32 i = 1; result && i < 4; ++i) {
+        result =
+            samples[i]->red_segment   == first->red_segment &&
+            samples[i]->green_segment == first->green_segment &&
+            samples[i]->blue_segment  == first->blue_segment &&
+            samples[i]->true_segment  == first->true_segment;
+    }
+
+    F32 red_distance   = 0.0f;
+    F32 green_distance = 0.0f;
+    F32 blue_distance  = 0.0f;
+    F32 true_distance  = 0.0f;
+    for (U32 i = 0; result && i < 4; ++i) {
+        red_distance   = f32_max(red_distance,   samples[i]->red_distance);
+        green_distance = f32_max(green_distance, samples[i]->green_distance);
+        blue_distance  = f32_max(blue_distance,  samples[i]->blue_distance);
+        true_distance  = f32_max(true_distance,  f32_min(samples[i]->red_distance, f32_min(samples[i]->green_distance, samples[i]->blue_distance)));
+    }
+
+    if (result && raster->mode != MSDF_Mode_MSDF) {
+        MSDF_Segment *line   = first->true_segment;
+        V2F32         length = v2f32_subtract(line->p1, line->p0);
+        for (U32 i = 0; result && i < 4; ++i) {
+            F32 t = v2f32_dot(v2f32_subtract(corners[i], line->p0), length) / v2f32_length_squared(length);
+            result = (0.0f < t && t < 1.0f);
+        }
+
+        result = result && msdf_segment_wins_block(raster, candidates, line, MSDF_COLOR_RED | MSDF_COLOR_GREEN | MSDF_COLOR_BLUE, true_distance, center, half_diagonal);
+    }
+
+    if (raster->mode != MSDF_Mode_SDF) {
+        result = result && msdf_segment_wins_block(raster, candidates, first->red_segment,   MSDF_COLOR_RED,   red_distance,   center, half_diagonal);
+        result = result && msdf_segment_wins_block(raster, candidates, first->green_segment, MSDF_COLOR_GREEN, green_distance, center, half_diagonal);
+        result = result && msdf_segment_wins_block(raster, candidates, first->blue_segment,  MSDF_COLOR_BLUE,  blue_distance,  center, half_diagonal);
+    }
+
+    return result;
+}
+
+// NOTE(simon): Fills the pixels in [x0, x1] x [y0, y1], which shares its edges
+// with neighbouring blocks. Blocks that can't be interpolated are split in
+// half along each side, and only the candidates that can still win are
+// passed on to them.
+internal Void msdf_rasterize_block(MSDF_AdaptiveRaster *raster, MSDF_CandidateList *candidates, U32 x0, U32 y0, U32 x1, U32 y1) {
+    U32 render_size = raster->render_size;
+
+    B32 has_pending_pixels = false;
+    for (U32 y = y0; !has_pending_pixels && y <= y1; ++y) {
+        for (U32 x = x0; !has_pending_pixels && x <= x1; ++x) {
+            has_pending_pixels = !raster->is_done[(y - raster->first_row) * render_size + x];
+        }
+    }
+
+    if (!has_pending_pixels) {
+        return;
+    }
+
+    MSDF_Sample *samples[4] = {
+        msdf_adaptive_sample(raster, candidates, x0, y0),
+        msdf_adaptive_sample(raster, candidates, x1, y0),
+        msdf_adaptive_sample(raster, candidates, x0, y1),
+        msdf_adaptive_sample(raster, candidates, x1, y1),
+    };
+    V2F32 corners[4] = {
+        v2f32((x0 + 0.5f) / (F32) render_size, (y0 + 0.5f) / (F32) render_size),
+        v2f32((x1 + 0.5f) / (F32) render_size, (y0 + 0.5f) / (F32) render_size),
+        v2f32((x0 + 0.5f) / (F32) render_size, (y1 + 0.5f) / (F32) render_size),
+        v2f32((x1 + 0.5f) / (F32) render_size, (y1 + 0.5f) / (F32) render_size),
+    };
+    V2F32 center        = v2f32_scale(v2f32_add(corners[0], corners[3]), 0.5f);
+    F32   half_diagonal = 0.5f * v2f32_length(v2f32_subtract(corners[3], corners[0]));
+
+    Arena_Temporary scratch = arena_begin_temporary(raster->arena);
+
+    MSDF_CandidateList block_candidates = { 0 };
+    block_candidates.indices = arena_push_array(raster->arena, U32, candidates->line_count + candidates->bezier_count + candidates->cubic_bezier_count);
+    msdf_cull_candidates(raster, candidates, samples, center, half_diagonal, &block_candidates);
+
+    if (msdf_block_is_affine(raster, &block_candidates, samples, corners, center, half_diagonal)) {
+        V4F32 c00 = samples[0]->value;
+        V4F32 c10 = samples[1]->value;
+        V4F32 c01 = samples[2]->value;
+        V4F32 c11 = samples[3]->value;
+        for (U32 y = y0; y <= y1; ++y) {
+            F32 v = (F32) (y - y0) / (F32) u32_max(1, y1 - y0);
+            for (U32 x = x0; x <= x1; ++x) {
+                U32 index = (y - raster->first_row) * render_size + x;
+                if (!raster->is_done[index]) {
+                    F32 u = (F32) (x - x0) / (F32) u32_max(1, x1 - x0);
+                    raster->distances[index] = v4f32(
+                        f32_lerp(f32_lerp(c00.x, c10.x, u), f32_lerp(c01.x, c11.x, u), v),
+                        f32_lerp(f32_lerp(c00.y, c10.y, u), f32_lerp(c01.y, c11.y, u), v),
+                        f32_lerp(f32_lerp(c00.z, c10.z, u), f32_lerp(c01.z, c11.z, u), v),
+                        f32_lerp(f32_lerp(c00.w, c10.w, u), f32_lerp(c01.w, c11.w, u), v)
+                    );
+                    raster->is_done[index] = true;
+                }
+            }
+        }
+    } else if (x1 - x0 <= MSDF_ADAPTIVE_LEAF_SIZE && y1 - y0 <= MSDF_ADAPTIVE_LEAF_SIZE) {
+        for (U32 y = y0; y <= y1; ++y) {
+            for (U32 x = x0; x <= x1; ++x) {
+                U32 index = (y - raster->first_row) * render_size + x;
+                if (raster->is_done[index]) {
+                    continue;
+                }
+
+                if (raster->is_sampled[index]) {
+                    raster->distances[index] = raster->samples[index].value;
+                } else {
+                    V2F32 point = v2f32((x + 0.5f) / (F32) render_size, (y + 0.5f) / (F32) render_size);
+                    raster->distances[index] = msdf_sample(raster->segments, &block_candidates, raster->seeds, point, raster->distance_range, raster->mode).value;
+                }
+                raster->is_done[index] = true;
+            }
+        }
+    } else {
+        U32 xm = (x1 - x0 >= 2 ? (x0 + x1) / 2 : x1);
+        U32 ym = (y1 - y0 >= 2 ? (y0 + y1) / 2 : y1);
+        msdf_rasterize_block(raster, &block_candidates, x0, y0, xm, ym);
+        if (xm != x1) {
+            msdf_rasterize_block(raster, &block_candidates, xm, y0, x1, ym);
+        }
+        if (ym != y1) {
+            msdf_rasterize_block(raster, &block_candidates, x0, ym, xm, y1);
+        }
+        if (xm != x1 && ym != y1) {
+            msdf_rasterize_block(raster, &block_candidates, xm, ym, x1, y1);
+        }
+    }
+
+    arena_end_temporary(scratch);
+}
+
+// NOTE(simon): The band holds every pixel whose center lies within the
+// distance range of the bounds of some segment, which includes all pixels
+// that can end up with an unsaturated true distance. Pixels outside of it
+// only need to know if they are inside, which we find by sweeping over the
+// crossings of each row with the outline. Only rows in [y_min, y_max) are
+// touched.
+internal Void msdf_fill_narrow_band(MSDF_RasterTask *task, U32 y_min, U32 y_max, F32 *crossing_xs, S32 *crossing_directions) {
+    MSDF_Segment *segments       = task->segments;
+    U32           segment_count  = task->segment_count;
+    U32           render_size    = task->render_size;
+    F32           distance_range = task->distance_range;
+    B8           *is_in_band     = task->is_in_band;
+    V4F32        *distances      = task->distances;
+
+    // NOTE(simon): The bounds of long or curved segments cover a lot of
+    // pixels that are far away from them, so segments are cut into pieces
+    // about MSDF_BAND_PIECE_SIZE pixels long first. Pieces lie within the
+    // bounds of their segment, so segments that are far from the rows can be
+    // skipped without cutting them, with a row to spare for rounding.
+    for (U32 i = 0; i < segment_count; ++i) {
+        MSDF_Segment remaining = segments[i];
+
+        V2F32 segment_min = { 0 };
+        V2F32 segment_max = { 0 };
+        msdf_segment_bounds(remaining, &segment_min, &segment_max);
+        S32 segment_y_min = (S32) f32_ceil( (segment_min.y - distance_range) * (F32) render_size - 0.5f) - 1;
+        S32 segment_y_max = (S32) f32_floor((segment_max.y + distance_range) * (F32) render_size - 0.5f) + 1;
+        if (segment_y_max < (S32) y_min || segment_y_min >= (S32) y_max) {
+            continue;
+        }
+
+        F32 hull_length = v2f32_length(v2f32_subtract(remaining.p1, remaining.p0));
+        if (remaining.kind == MSDF_SEGMENT_QUADRATIC_BEZIER || remaining.kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+            hull_length += v2f32_length(v2f32_subtract(remaining.p2, remaining.p1));
+        }
+        if (remaining.kind == MSDF_SEGMENT_CUBIC_BEZIER) {
+            hull_length += v2f32_length(v2f32_subtract(remaining.p3, remaining.p2));
+        }
+        U32 piece_count = u32_max(1, (U32) f32_ceil(hull_length * (F32) render_size / MSDF_BAND_PIECE_SIZE));
+
+        for (U32 piece = 0; piece < piece_count; ++piece) {
+            MSDF_Segment current = remaining;
+            if (piece + 1 < piece_count) {
+                msdf_segment_split(remaining, 1.0f / (F32) (piece_count - piece), &current, &remaining);
+            }
+
+            V2F32 min = { 0 };
+            V2F32 max = { 0 };
+            msdf_segment_bounds(current, &min, &max);
+
+            S32 x_min       = s32_max(0,                     (S32) f32_ceil( (min.x - distance_range) * (F32) render_size - 0.5f));
+            S32 piece_y_min = s32_max((S32) y_min,           (S32) f32_ceil( (min.y - distance_range) * (F32) render_size - 0.5f));
+            S32 x_max       = s32_min((S32) render_size - 1, (S32) f32_floor((max.x + distance_range) * (F32) render_size - 0.5f));
+            S32 piece_y_max = s32_min((S32) y_max - 1,       (S32) f32_floor((max.y + distance_range) * (F32) render_size - 0.5f));
+            for (S32 y = piece_y_min; x_min <= x_max && y <= piece_y_max; ++y) {
+                memory_set(&is_in_band[((U32) y - task->first_row) * render_size + (U32) x_min], true, (U32) (x_max - x_min + 1));
+            }
+        }
+    }
+
+    for (U32 y = y_min; y < y_max; ++y) {
+        U32 crossing_count = 0;
+        U32 crossing_index = 0;
+        S32 winding        = 0;
+        F32 row_y = (y + 0.5f) / (F32) render_size;
+        for (U32 i = 0; i < segment_count; ++i) {
+            crossing_count += msdf_segment_horizontal_crossings(segments[i], row_y, &crossing_xs[crossing_count], &crossing_directions[crossing_count]);
+        }
+
+        for (U32 i = 1; i < crossing_count; ++i) {
+            F32 crossing_x         = crossing_xs[i];
+            S32 crossing_direction = crossing_directions[i];
+            U32 j = i;
+            for (; j > 0 && crossing_xs[j - 1] > crossing_x; --j) {
+                crossing_xs[j]         = crossing_xs[j - 1];
+                crossing_directions[j] = crossing_directions[j - 1];
+            }
+            crossing_xs[j]         = crossing_x;
+            crossing_directions[j] = crossing_direction;
+        }
+
+        for (U32 x = 0; x < render_size; ++x) {
+            F32 point_x = (x + 0.5f) / (F32) render_size;
+            while (crossing_index < crossing_count && crossing_xs[crossing_index] <= point_x) {
+                winding += crossing_directions[crossing_index++];
+            }
+
+            U32 index = (y - task->first_row) * render_size + x;
+            if (!is_in_band[index]) {
+                F32 value = (winding != 0 ? 1.0f : 0.0f);
+                distances[index] = v4f32(value, value, value, task->mode != MSDF_Mode_MSDF ? value : 0.0f);
+            }
+        }
+    }
+}
+
+internal Void msdf_rasterize_band(Void *data, U32 band_index) {
+    MSDF_RasterTask *task = (MSDF_RasterTask *) data;
+    U32 render_size = task->render_size;
+    U32 y_min       = (task->first_band + band_index) * MSDF_RASTER_BAND_HEIGHT;
+    U32 y_max       = u32_min(y_min + MSDF_RASTER_BAND_HEIGHT, render_size);
+
+    Arena_Temporary scratch = arena_get_scratch(0, 0);
+
+    // NOTE(simon): Closest point parameters of the previous pixel in the band
+    // that evaluated each segment, negative until there is one.
+    F32 *seeds = 0;
+    if (task->seeded_newton) {
+        seeds = arena_push_array(scratch.arena, F32, task->segment_count);
+        for (U32 i = 0; i < task->segment_count; ++i) {
+            seeds[i] = -1.0f;
+        }
+    }
+
+    if (task->adaptive) {
+        // NOTE(simon): Blocks never leave the pixels they start with, so the
+        // bands can share the per-pixel state. The band is split into square
+        // blocks, as long and thin ones cull candidates poorly.
+        MSDF_AdaptiveRaster raster = *task->adaptive;
+        raster.arena = scratch.arena;
+        raster.seeds = seeds;
+        for (U32 x_min = 0; x_min < render_size; x_min += MSDF_RASTER_BAND_HEIGHT) {
+            U32 x_max = u32_min(x_min + MSDF_RASTER_BAND_HEIGHT, render_size);
+            msdf_rasterize_block(&raster, task->candidates, x_min, y_min, x_max - 1, y_max - 1);
+        }
+    } else {
+        for (U32 y = y_min; y < y_max; ++y) {
+            for (U32 x = 0; x < render_size; ++x) {
+                U32 index = (y - task->first_row) * render_size + x;
+                if (task->is_in_band && !task->is_in_band[index]) {
+                    continue;
+                }
+
+                V2F32 point = v2f32((x + 0.5f) / (F32) render_size, (y + 0.5f) / (F32) render_size);
+                task->distances[index] = msdf_sample(task->segments, task->candidates, seeds, point, task->distance_range, task->mode).value;
+            }
+        }
+    }
+
+    arena_end_temporary(scratch);
+}
+
+internal MSDF_RasterResult msdf_rasterize_internal(Arena *arena, MSDF_PreparedGlyph *glyph, MSDF_GenerateParams *parameters) {
+    MSDF_RasterResult result = { 0 };
+    U32 render_size = parameters->render_size;
+    U32 pixel_size  = msdf_pixel_size_from_format(parameters->format);
+    result.format   = parameters->format;
+
+    Arena_Temporary scratch = arena_get_scratch(&arena, 1);
+
+    result.x_min             = (F32)  glyph->x_min / (F32) glyph->funits_per_em;
+    result.y_min             = (F32) -glyph->y_max / (F32) glyph->funits_per_em;
+    result.x_max             = (F32)  glyph->x_max / (F32) glyph->funits_per_em;
+    result.y_max             = (F32) -glyph->y_min / (F32) glyph->funits_per_em;
+    result.advance_width     = (F32) glyph->metrics.advance_width / (F32) glyph->funits_per_em;
+    result.left_side_bearing = (F32) glyph->metrics.left_side_bearing / (F32) glyph->funits_per_em;
+
+    U32 line_count         = glyph->line_count;
+    U32 bezier_count       = glyph->quadratic_bezier_count;
+    U32 cubic_bezier_count = glyph->cubic_bezier_count;
+    U32 segment_count      = line_count + bezier_count + cubic_bezier_count;
+    MSDF_Segment *segments      = arena_push_array_zero(scratch.arena, MSDF_Segment, segment_count);
+    MSDF_Segment *lines         = segments;
+    MSDF_Segment *quad_beziers  = lines + line_count;
+    MSDF_Segment *cubic_beziers = quad_beziers + bezier_count;
+
     // Scale the contours to the range [0--1] and generate bounding circles
     // for the them.
     U32 padding = 1;
 
-    F32 x_scale = (F32) (render_size - 2 * padding) / (F32) (glyph.x_max - glyph.x_min);
-    F32 y_scale = (F32) (render_size - 2 * padding) / (F32) (glyph.y_max - glyph.y_min);
+    F32 x_scale = (F32) (render_size - 2 * padding) / (F32) (glyph->x_max - glyph->x_min);
+    F32 y_scale = (F32) (render_size - 2 * padding) / (F32) (glyph->y_max - glyph->y_min);
 
-    for (MSDF_Segment *line = lines.first; line; line = line->next) {
+    for (U32 i = 0; i < line_count; ++i) {
+        MSDF_PreparedSegment *prepared = &glyph->segments[i];
+        MSDF_Segment *line = &lines[i];
+        line->kind  = MSDF_SEGMENT_LINE;
+        line->flags = prepared->flags;
         line->p0 = v2f32(
-            ((line->p0.x  - glyph.x_min) * x_scale + (F32) padding) / (F32) render_size,
-            ((glyph.y_max - line->p0.y)  * y_scale + (F32) padding) / (F32) render_size
+            ((prepared->p0.x - glyph->x_min)  * x_scale + (F32) padding) / (F32) render_size,
+            ((glyph->y_max   - prepared->p0.y) * y_scale + (F32) padding) / (F32) render_size
         );
         line->p1 = v2f32(
-            ((line->p1.x  - glyph.x_min) * x_scale + (F32) padding) / (F32) render_size,
-            ((glyph.y_max - line->p1.y)  * y_scale + (F32) padding) / (F32) render_size
+            ((prepared->p1.x - glyph->x_min)  * x_scale + (F32) padding) / (F32) render_size,
+            ((glyph->y_max   - prepared->p1.y) * y_scale + (F32) padding) / (F32) render_size
         );
 
         V2F32 min = v2f32_min(line->p0, line->p1);
@@ -779,19 +2264,24 @@ internal MSDF_RasterResult msdf_generate(Arena *arena, TTF_Font *font, U32 codep
         F32 radius = 0.5f * v2f32_length(v2f32_subtract(max, min));
         line->circle_center = center;
         line->circle_radius = radius;
+        msdf_segment_precompute(line);
     }
-    for (MSDF_Segment *bezier = quad_beziers.first; bezier; bezier = bezier->next) {
+    for (U32 i = 0; i < bezier_count; ++i) {
+        MSDF_PreparedSegment *prepared = &glyph->segments[line_count + i];
+        MSDF_Segment *bezier = &quad_beziers[i];
+        bezier->kind  = MSDF_SEGMENT_QUADRATIC_BEZIER;
+        bezier->flags = prepared->flags;
         bezier->p0 = v2f32(
-            ((bezier->p0.x - glyph.x_min)  * x_scale + (F32) padding) / (F32) render_size,
-            ((glyph.y_max  - bezier->p0.y) * y_scale + (F32) padding) / (F32) render_size
+            ((prepared->p0.x - glyph->x_min)  * x_scale + (F32) padding) / (F32) render_size,
+            ((glyph->y_max   - prepared->p0.y) * y_scale + (F32) padding) / (F32) render_size
         );
         bezier->p1 = v2f32(
-            ((bezier->p1.x - glyph.x_min)  * x_scale + (F32) padding) / (F32) render_size,
-            ((glyph.y_max  - bezier->p1.y) * y_scale + (F32) padding) / (F32) render_size
+            ((prepared->p1.x - glyph->x_min)  * x_scale + (F32) padding) / (F32) render_size,
+            ((glyph->y_max   - prepared->p1.y) * y_scale + (F32) padding) / (F32) render_size
         );
         bezier->p2 = v2f32(
-            ((bezier->p2.x - glyph.x_min)  * x_scale + (F32) padding) / (F32) render_size,
-            ((glyph.y_max  - bezier->p2.y) * y_scale + (F32) padding) / (F32) render_size
+            ((prepared->p2.x - glyph->x_min)  * x_scale + (F32) padding) / (F32) render_size,
+            ((glyph->y_max   - prepared->p2.y) * y_scale + (F32) padding) / (F32) render_size
         );
 
         V2F32 min = v2f32_min(v2f32_min(bezier->p0, bezier->p1), bezier->p2);
@@ -800,94 +2290,171 @@ internal MSDF_RasterResult msdf_generate(Arena *arena, TTF_Font *font, U32 codep
         F32 radius = 0.5f * v2f32_length(v2f32_subtract(max, min));
         bezier->circle_center = center;
         bezier->circle_radius = radius;
+        msdf_segment_precompute(bezier);
     }
+    for (U32 i = 0; i < cubic_bezier_count; ++i) {
+        MSDF_PreparedSegment *prepared = &glyph->segments[line_count + bezier_count + i];
+        MSDF_Segment *bezier = &cubic_beziers[i];
+        bezier->kind  = MSDF_SEGMENT_CUBIC_BEZIER;
+        bezier->flags = prepared->flags;
+        bezier->p0 = v2f32(
+            ((prepared->p0.x - glyph->x_min)  * x_scale + (F32) padding) / (F32) render_size,
+            ((glyph->y_max   - prepared->p0.y) * y_scale + (F32) padding) / (F32) render_size
+        );
+        bezier->p1 = v2f32(
+            ((prepared->p1.x - glyph->x_min)  * x_scale + (F32) padding) / (F32) render_size,
+            ((glyph->y_max   - prepared->p1.y) * y_scale + (F32) padding) / (F32) render_size
+        );
+        bezier->p2 = v2f32(
+            ((prepared->p2.x - glyph->x_min)  * x_scale + (F32) padding) / (F32) render_size,
+            ((glyph->y_max   - prepared->p2.y) * y_scale + (F32) padding) / (F32) render_size
+        );
+        bezier->p3 = v2f32(
+            ((prepared->p3.x - glyph->x_min)  * x_scale + (F32) padding) / (F32) render_size,
+            ((glyph->y_max   - prepared->p3.y) * y_scale + (F32) padding) / (F32) render_size
+        );
 
-    F32 distance_range = 2.0f / render_size;
-    U32 pixel_index = 0;
-    result.data = arena_push_array(arena, U8, 4 * render_size * render_size);
-    for (U32 y = 0; y < render_size; ++y) {
-        for (U32 x = 0; x < render_size; ++x) {
-            MSDF_Segment nil_segment     = { 0 };
-            MSDF_Distance red_distance   = { .distance = f32_infinity(), .orthogonality = 0.0f };
-            MSDF_Segment *red_segment    = &nil_segment;
-            MSDF_Distance green_distance = { .distance = f32_infinity(), .orthogonality = 0.0f };
-            MSDF_Segment *green_segment  = &nil_segment;
-            MSDF_Distance blue_distance  = { .distance = f32_infinity(), .orthogonality = 0.0f };
-            MSDF_Segment *blue_segment   = &nil_segment;
-
-            V2F32 point = v2f32((x + 0.5f) / (F32) render_size, (y + 0.5f) / (F32) render_size);
-            for (MSDF_Segment *line = lines.first; line; line = line->next) {
-                F32 min_distance = v2f32_length_squared(v2f32_subtract(line->circle_center, point));
-
-                F32 red   = red_distance.distance   + line->circle_radius;
-                F32 green = green_distance.distance + line->circle_radius;
-                F32 blue  = blue_distance.distance  + line->circle_radius;
-                if (red * red >= min_distance || green * green >= min_distance || blue * blue >= min_distance) {
-                    MSDF_Distance distance = msdf_line_distance_orthogonality(point, *line);
-
-                    if ((line->flags & MSDF_COLOR_RED) && msdf_distance_is_closer(distance, red_distance)) {
-                        red_distance = distance;
-                        red_segment  = line;
-                    }
-                    if ((line->flags & MSDF_COLOR_GREEN) && msdf_distance_is_closer(distance, green_distance)) {
-                        green_distance = distance;
-                        green_segment  = line;
-                    }
-                    if ((line->flags & MSDF_COLOR_BLUE) && msdf_distance_is_closer(distance, blue_distance)) {
-                        blue_distance = distance;
-                        blue_segment  = line;
-                    }
-                }
-            }
+        V2F32 min = v2f32_min(v2f32_min(bezier->p0, bezier->p1), v2f32_min(bezier->p2, bezier->p3));
+        V2F32 max = v2f32_max(v2f32_max(bezier->p0, bezier->p1), v2f32_max(bezier->p2, bezier->p3));
+        V2F32 center = v2f32_scale(v2f32_add(max, min), 0.5f);
+        F32 radius = 0.5f * v2f32_length(v2f32_subtract(max, min));
+        bezier->circle_center = center;
+        bezier->circle_radius = radius;
+        msdf_segment_precompute(bezier);
+    }
 
-            for (MSDF_Segment *bezier = quad_beziers.first; bezier; bezier = bezier->next) {
-                F32 min_distance = v2f32_length_squared(v2f32_subtract(bezier->circle_center, point));
+    // NOTE(simon): Normalized distances are kept as floats until the error
+    // correction has run, and only then converted to the output format. The
+    // channels of an SDF are all the same, so they can't clash.
+    F32 distance_range = parameters->distance_range / (F32) render_size;
+    U64 row_size       = (U64) render_size * pixel_size;
+    B32 is_streaming   = parameters->sink.write != 0 || parameters->destination;
+    B32 is_correcting  = parameters->error_correction && parameters->mode != MSDF_Mode_SDF;
+
+    // NOTE(simon): Rows are rasterized one strip at a time, and without a
+    // sink or a destination the whole glyph is a single strip. Strips are
+    // made of whole bands so that the bands are the same as without
+    // streaming.
+    U32 strip_height = render_size;
+    if (is_streaming) {
+        strip_height = (parameters->strip_height ? parameters->strip_height : MSDF_STRIP_HEIGHT);
+        strip_height = (strip_height + MSDF_RASTER_BAND_HEIGHT - 1) / MSDF_RASTER_BAND_HEIGHT * MSDF_RASTER_BAND_HEIGHT;
+        strip_height = u32_min(strip_height, render_size);
+    }
 
-                F32 red   = red_distance.distance   + bezier->circle_radius;
-                F32 green = green_distance.distance + bezier->circle_radius;
-                F32 blue  = blue_distance.distance  + bezier->circle_radius;
-                if (red * red >= min_distance || green * green >= min_distance || blue * blue >= min_distance) {
-                    MSDF_Distance distance = msdf_quadratic_bezier_distance_orthogonality(point, *bezier);
+    // NOTE(simon): Error correction compares texels with their neighbours,
+    // so when there are several strips, the last two rows of each one are
+    // kept from before the correction and carried over to the next. Rows are
+    // then written one row behind the strip, once the row after them is
+    // known.
+    U32    halo_rows   = (is_correcting && strip_height < render_size ? 2 : 0);
+    U32    buffer_size = (strip_height + halo_rows) * render_size;
+    V4F32 *distances   = arena_push_array(scratch.arena, V4F32, buffer_size);
+    V4F32 *halo        = arena_push_array(scratch.arena, V4F32, halo_rows * render_size);
+
+    MSDF_RasterTask task = { 0 };
+    task.segments       = segments;
+    task.segment_count  = segment_count;
+    task.render_size    = render_size;
+    task.distance_range = distance_range;
+    task.mode           = parameters->mode;
+    task.seeded_newton  = parameters->seeded_newton;
+    task.distances      = distances;
+
+    F32 *crossing_xs         = 0;
+    S32 *crossing_directions = 0;
+    if (parameters->narrow_band) {
+        task.is_in_band     = arena_push_array(scratch.arena, B8,  buffer_size);
+        crossing_xs         = arena_push_array(scratch.arena, F32, 3 * segment_count);
+        crossing_directions = arena_push_array(scratch.arena, S32, 3 * segment_count);
+    }
 
-                    if ((bezier->flags & MSDF_COLOR_RED) && msdf_distance_is_closer(distance, red_distance)) {
-                        red_distance = distance;
-                        red_segment  = bezier;
-                    }
-                    if ((bezier->flags & MSDF_COLOR_GREEN) && msdf_distance_is_closer(distance, green_distance)) {
-                        green_distance = distance;
-                        green_segment  = bezier;
-                    }
-                    if ((bezier->flags & MSDF_COLOR_BLUE) && msdf_distance_is_closer(distance, blue_distance)) {
-                        blue_distance = distance;
-                        blue_segment  = bezier;
-                    }
-                }
-            }
+    MSDF_CandidateList candidates = { 0 };
+    candidates.indices            = arena_push_array(scratch.arena, U32, segment_count);
+    candidates.line_count         = line_count;
+    candidates.bezier_count       = bezier_count;
+    candidates.cubic_bezier_count = cubic_bezier_count;
+    for (U32 i = 0; i < segment_count; ++i) {
+        candidates.indices[i] = i;
+    }
+    task.candidates = &candidates;
+
+    MSDF_AdaptiveRaster raster = { 0 };
+    if (parameters->adaptive) {
+        raster.segments       = segments;
+        raster.render_size    = render_size;
+        raster.distance_range = distance_range;
+        raster.mode           = parameters->mode;
+        raster.distances      = distances;
+        raster.is_done        = arena_push_array(scratch.arena, B8, buffer_size);
+        raster.samples        = arena_push_array(scratch.arena, MSDF_Sample, buffer_size);
+        raster.is_sampled     = arena_push_array(scratch.arena, B8, buffer_size);
+        task.adaptive         = &raster;
+    }
 
-            if (red_segment->kind == MSDF_SEGMENT_LINE) {
-                red_distance.distance = msdf_line_signed_pseudo_distance(point, *red_segment);
-            } else if (red_segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
-                red_distance.distance = msdf_quadratic_bezier_signed_pseudo_distance(point, *red_segment, red_distance.unclamped_t);
-            }
-            if (green_segment->kind == MSDF_SEGMENT_LINE) {
-                green_distance.distance = msdf_line_signed_pseudo_distance(point, *green_segment);
-            } else if (green_segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
-                green_distance.distance = msdf_quadratic_bezier_signed_pseudo_distance(point, *green_segment, green_distance.unclamped_t);
+    // NOTE(simon): The last strip also writes the row held back from the one
+    // before it.
+    U8 *pixels      = 0;
+    U8 *destination = parameters->destination;
+    U64 stride      = (parameters->stride ? parameters->stride : row_size);
+    if (!destination && is_streaming) {
+        pixels = arena_push_array(scratch.arena, U8, (strip_height + 1) * row_size);
+    } else if (!destination) {
+        result.data = arena_push_array(arena, U8, render_size * row_size);
+        destination = result.data;
+    }
+
+    B32 is_running = true;
+    for (U32 strip_min = 0; is_running && strip_min < render_size; strip_min += strip_height) {
+        U32 strip_max         = u32_min(strip_min + strip_height, render_size);
+        U32 first_row         = (strip_min ? strip_min - halo_rows : 0);
+        U32 row_count         = strip_max - first_row;
+        U32 strip_offset      = (strip_min - first_row) * render_size;
+        U32 strip_pixel_count = (strip_max - strip_min) * render_size;
+        task.first_row  = first_row;
+        task.first_band = strip_min / MSDF_RASTER_BAND_HEIGHT;
+
+        if (strip_min && halo_rows) {
+            memory_copy(distances, halo, halo_rows * render_size * sizeof(V4F32));
+        }
+
+        if (task.is_in_band) {
+            memory_zero(&task.is_in_band[strip_offset], strip_pixel_count);
+            msdf_fill_narrow_band(&task, strip_min, strip_max, crossing_xs, crossing_directions);
+        }
+
+        if (task.adaptive) {
+            raster.first_row = first_row;
+            for (U32 i = strip_offset; i < strip_offset + strip_pixel_count; ++i) {
+                raster.is_done[i]    = (task.is_in_band && !task.is_in_band[i]);
+                raster.is_sampled[i] = false;
             }
-            if (blue_segment->kind == MSDF_SEGMENT_LINE) {
-                blue_distance.distance = msdf_line_signed_pseudo_distance(point, *blue_segment);
-            } else if (blue_segment->kind == MSDF_SEGMENT_QUADRATIC_BEZIER) {
-                blue_distance.distance = msdf_quadratic_bezier_signed_pseudo_distance(point, *blue_segment, blue_distance.unclamped_t);
+        }
+
+        U32 band_count = (strip_max - strip_min + MSDF_RASTER_BAND_HEIGHT - 1) / MSDF_RASTER_BAND_HEIGHT;
+        thread_pool_run(parameters->pool, msdf_rasterize_band, &task, band_count);
+
+        U32 output_min = strip_min;
+        U32 output_max = strip_max;
+        if (is_correcting) {
+            if (halo_rows) {
+                memory_copy(halo, &distances[(row_count - halo_rows) * render_size], halo_rows * render_size * sizeof(V4F32));
+                output_min = (strip_min ? strip_min - 1 : 0);
+                output_max = (strip_max < render_size ? strip_max - 1 : render_size);
             }
+            msdf_correct_errors(scratch.arena, distances, render_size, row_count, MSDF_ERROR_CORRECTION_THRESHOLD / parameters->distance_range);
+        }
 
-            S32 red   = s32_min(s32_max(0, f32_round_to_s32((red_distance.distance   / distance_range + 0.5f) * 255.0f)), 255);
-            S32 green = s32_min(s32_max(0, f32_round_to_s32((green_distance.distance / distance_range + 0.5f) * 255.0f)), 255);
-            S32 blue  = s32_min(s32_max(0, f32_round_to_s32((blue_distance.distance  / distance_range + 0.5f) * 255.0f)), 255);
+        for (U32 y = output_min; y < output_max; ++y) {
+            U8    *output = (pixels ? &pixels[(y - output_min) * row_size] : &destination[y * stride]);
+            V4F32 *source = &distances[(y - first_row) * render_size];
+            for (U32 x = 0; x < render_size; ++x) {
+                msdf_store_pixel(&output[x * pixel_size], parameters->format, source[x].x, source[x].y, source[x].z, source[x].w);
+            }
+        }
 
-            result.data[pixel_index++] = red;
-            result.data[pixel_index++] = green;
-            result.data[pixel_index++] = blue;
-            result.data[pixel_index++] = 0;
+        if (pixels) {
+            is_running = parameters->sink.write(parameters->sink.user_data, output_min, output_max - output_min, pixels);
         }
     }
 
@@ -895,3 +2462,14 @@ internal MSDF_RasterResult msdf_generate(Arena *arena, TTF_Font *font, U32 codep
 
     return result;
 }
+
+internal MSDF_RasterResult msdf_generate_internal(Arena *arena, TTF_Font *font, U32 codepoint, MSDF_GenerateParams *parameters) {
+    U32 glyph_index = ttf_get_glyph_index(font, codepoint);
+    Arena_Temporary scratch = arena_get_scratch(&arena, 1);
+
+    MSDF_PreparedGlyph *glyph = msdf_get_prepared_glyph(scratch.arena, font, glyph_index, parameters->render_size, parameters->mode);
+    MSDF_RasterResult result = msdf_rasterize_internal(arena, glyph, parameters);
+
+    arena_end_temporary(scratch);
+    return result;
+}
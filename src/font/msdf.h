@@ -5,6 +5,7 @@ typedef enum {
     MSDF_SEGMENT_NULL,
     MSDF_SEGMENT_LINE,
     MSDF_SEGMENT_QUADRATIC_BEZIER,
+    MSDF_SEGMENT_CUBIC_BEZIER,
     MSDF_SEGMENT_KIND_COUNT,
 } MSDF_SegmentKind;
 
@@ -22,6 +23,27 @@ typedef enum {
     MSDF_ContourFlags_Keep = 0x02,
 } MSDF_ContourFlags;
 
+// NOTE(simon): Everything the distance functions need that doesn't depend on
+// the pixel. Lines store p1 - p0 in v1. Quadratic beziers are
+// p0 + 2 * t * v1 + t^2 * v2, and a, b and c are the parts of the cubic
+// for the closest point that don't depend on it. Cubic beziers are
+// p0 + 3 * t * v1 + 3 * t^2 * v2 + t^3 * v3. The directions are the tangents
+// at the ends, along which the pseudo-distance extends the segment.
+typedef struct {
+    V2F32 v1;
+    V2F32 v2;
+    V2F32 v3;
+    F32   a;
+    F32   b;
+    F32   c;
+
+    V2F32 start_direction;
+    V2F32 end_direction;
+    V2F32 unit_direction;
+    F32   inverse_start_length_squared;
+    F32   inverse_end_length_squared;
+} MSDF_SegmentCoefficients;
+
 typedef struct MSDF_Segment MSDF_Segment;
 struct MSDF_Segment {
     MSDF_SegmentKind kind;
@@ -30,11 +52,16 @@ struct MSDF_Segment {
     V2F32 p0;
     V2F32 p1;
     V2F32 p2;
+    V2F32 p3;
     MSDF_ColorFlags flags;
 
     // NOTE(simon): Bounding circle for pruning
     V2F32 circle_center;
     F32   circle_radius;
+
+    // NOTE(simon): Only filled in for the segments being rasterized, see
+    // msdf_segment_precompute.
+    MSDF_SegmentCoefficients coefficients;
 };
 
 typedef struct MSDF_SegmentList MSDF_SegmentList;
@@ -64,12 +91,233 @@ struct MSDF_Glyph {
     S32 y_max;
 };
 
+// NOTE(simon): A glyph after overlap resolution, simple polygon conversion,
+// orientation correction and edge coloring, still in font units. The lines
+// come first, followed by the quadratic and then the cubic beziers, each in
+// contour order.
+// Prepared glyphs are never modified, so they can be shared between threads.
+// They are simplified for the render size they were prepared for, smaller
+// sizes are fine while larger ones might show the simplification.
+typedef struct {
+    V2F32 p0;
+    V2F32 p1;
+    V2F32 p2;
+    V2F32 p3;
+    MSDF_ColorFlags flags;
+} MSDF_PreparedSegment;
+
+typedef struct {
+    S32 x_min;
+    S32 y_min;
+    S32 x_max;
+    S32 y_max;
+
+    TTF_HmtxMetrics metrics;
+    U16 funits_per_em;
+
+    U32 line_count;
+    U32 quadratic_bezier_count;
+    U32 cubic_bezier_count;
+    MSDF_PreparedSegment *segments;
+} MSDF_PreparedGlyph;
+
+// NOTE(simon): Channels are stored as distance / distance_range + 0.5. The
+// unorm formats clamp this to [0, 1], while the float formats store it as is
+// so that distances outside of the range are kept.
+typedef enum {
+    MSDF_Format_RGBA8,
+    MSDF_Format_RGB8,
+    MSDF_Format_RGB16,
+    MSDF_Format_RGB16F,
+    MSDF_Format_RGBA16,
+    MSDF_Format_RGBA16F,
+    MSDF_Format_R8,
+    MSDF_Format_COUNT,
+} MSDF_Format;
+
+// NOTE(simon): MTSDF additionally stores the true signed distance in alpha,
+// which is useful for effects such as shadows and outlines. It needs one of
+// the formats with an alpha channel, otherwise it is the same as MSDF.
+//
+// SDF only stores the true signed distance, in every channel of the format,
+// which is meant to be used with MSDF_Format_R8. Edges aren't colored and
+// only the closest segment is tracked, so it is cheaper to generate, but it
+// rounds off corners. It is good enough for small text.
+typedef enum {
+    MSDF_Mode_MSDF,
+    MSDF_Mode_MTSDF,
+    MSDF_Mode_SDF,
+    MSDF_Mode_COUNT,
+} MSDF_Mode;
+
+// NOTE(simon): In pixels, how much larger than a true distance field the
+// change between two neighbouring texels can be before they are considered
+// to clash.
+#define MSDF_ERROR_CORRECTION_THRESHOLD 1.001f
+
+// NOTE(simon): The closest point on a cubic bezier is found with Newton
+// iterations from this many evenly spaced starting points, plus one.
+#define MSDF_CUBIC_SEARCH_STARTS 4
+#define MSDF_CUBIC_SEARCH_STEPS  4
+
+// NOTE(simon): The seeded solver for quadratic beziers takes at most this
+// many Newton steps, and accepts the closest parameter once a step moves it
+// less than the tolerance. Convergence is quadratic, so it is then well below
+// the tolerance from the exact one.
+#define MSDF_NEWTON_STEPS     3
+#define MSDF_NEWTON_TOLERANCE 1e-4f
+
+// NOTE(simon): Segment intersections are written to arrays of this size.
+// Subdivision is capped so that nearly coincident cubics can't explode.
+#define MSDF_MAX_INTERSECTIONS   4
+#define MSDF_MAX_INTERSECT_DEPTH 12
+
+// NOTE(simon): Bisection steps used to find where a ray crosses a curve when
+// calculating winding numbers.
+#define MSDF_RAY_BISECTION_STEPS 24
+
+// NOTE(simon): In pixels, the length of the pieces that segments are cut into
+// when finding the narrow band.
+#define MSDF_BAND_PIECE_SIZE 4.0f
+
+// NOTE(simon): In pixels, how far simplification may move the outline, and
+// the size below which contours are dropped.
+#define MSDF_SIMPLIFY_TOLERANCE        (1.0f / 64.0f)
+#define MSDF_SIMPLIFY_MIN_CONTOUR_SIZE 0.5f
+
+// NOTE(simon): In pixels, the size below which the adaptive raster stops
+// splitting blocks that can't be interpolated and evaluates their pixels.
+// Bounds are padded by the margin to stay clear of ties, which are broken by
+// orthogonality.
+#define MSDF_ADAPTIVE_LEAF_SIZE 4
+#define MSDF_ADAPTIVE_MARGIN    (4.0f * F32_EPSILON)
+
+// NOTE(simon): Pixels are rasterized in bands of this many rows. Every band
+// starts over with its own seeds and quadtree, so the result is the same no
+// matter how the bands are spread over threads.
+#define MSDF_RASTER_BAND_HEIGHT 32
+
+// NOTE(simon): The number of rows that are rasterized at once when streaming,
+// unless the parameters ask for something else.
+#define MSDF_STRIP_HEIGHT 64
+
+// NOTE(simon): Receives rows [y, y + row_count) of the output, tightly packed
+// in the format of the raster. The data is only valid during the call.
+// Returning false stops the raster.
+typedef B32 MSDF_StripFunction(Void *user_data, U32 y, U32 row_count, U8 *data);
+
+typedef struct {
+    MSDF_StripFunction *write;
+    Void               *user_data;
+} MSDF_StripSink;
+
+typedef struct {
+    U32         render_size;
+    MSDF_Mode   mode;
+    MSDF_Format format;
+    // NOTE(simon): The distance in pixels covered by the full [0, 1] range.
+    F32         distance_range;
+    B32         error_correction;
+    // NOTE(simon): Only compute exact distances for pixels near the outline,
+    // and fill all other pixels with the saturated inside or outside value.
+    // Far pixels lose the unclamped distances kept by the float formats and
+    // the pseudo-distances that extend past sharp corners, so only which side
+    // of the outline a pixel is on is guaranteed to match.
+    B32         narrow_band;
+    // NOTE(simon): Rasterize in a quadtree of blocks. Blocks where the same
+    // lines provably win every channel are interpolated from their corners,
+    // and the rest only search the segments that can still win inside of
+    // them. The result matches full evaluation up to float rounding.
+    B32         adaptive;
+    // NOTE(simon): Find the closest point on quadratic beziers with Newton
+    // steps from the result of the previous pixel when it is provably unique,
+    // see msdf_quadratic_bezier_distance_orthogonality_seeded.
+    B32         seeded_newton;
+    // NOTE(simon): Optional. Rasterizes the bands of a glyph in parallel,
+    // which is worth it for large render sizes. Segments are only read, so
+    // the bands share them.
+    ThreadPool *pool;
+    // NOTE(simon): Optional. Streams the output to the sink a strip of rows
+    // at a time instead of returning it, so that memory use only depends on
+    // the strip height and not the render size. Strips are rounded up to
+    // whole bands.
+    MSDF_StripSink sink;
+    U32            strip_height;
+    // NOTE(simon): Optional. Writes the output straight into caller owned
+    // memory, such as an atlas, with rows stride bytes apart. A stride of 0
+    // means tightly packed rows. Rows are rasterized in strips the same way as
+    // for a sink, which is ignored when this is set.
+    U8            *destination;
+    U64            stride;
+} MSDF_GenerateParams;
+
 typedef struct {
     F32 distance;
     F32 orthogonality;
     F32 unclamped_t;
 } MSDF_Distance;
 
+// NOTE(simon): Indices of the segments that can be closest to some set of
+// points, sorted by kind in the same way as the segments themselves.
+typedef struct {
+    U32 *indices;
+    U32  line_count;
+    U32  bezier_count;
+    U32  cubic_bezier_count;
+} MSDF_CandidateList;
+
+// NOTE(simon): The value of one pixel along with the segments that won each
+// channel and the true distance, and the unsigned distances to them.
+typedef struct {
+    V4F32 value;
+    MSDF_Segment *red_segment;
+    MSDF_Segment *green_segment;
+    MSDF_Segment *blue_segment;
+    MSDF_Segment *true_segment;
+    F32 red_distance;
+    F32 green_distance;
+    F32 blue_distance;
+} MSDF_Sample;
+
+typedef struct {
+    Arena        *arena;
+    MSDF_Segment *segments;
+
+    U32       render_size;
+    F32       distance_range;
+    MSDF_Mode mode;
+
+    // NOTE(simon): The per-pixel arrays start at this row.
+    U32          first_row;
+    V4F32       *distances;
+    F32         *seeds;
+    B8          *is_done;
+    MSDF_Sample *samples;
+    B8          *is_sampled;
+} MSDF_AdaptiveRaster;
+
+typedef struct {
+    MSDF_Segment       *segments;
+    MSDF_CandidateList *candidates;
+    U32                 segment_count;
+    U32                 first_band;
+
+    U32       render_size;
+    F32       distance_range;
+    MSDF_Mode mode;
+    B32       seeded_newton;
+
+    // NOTE(simon): The per-pixel arrays start at this row.
+    U32    first_row;
+    V4F32 *distances;
+    // NOTE(simon): Optional. Pixels outside of the narrow band are already
+    // filled in.
+    B8    *is_in_band;
+    // NOTE(simon): Optional. Shared state for the adaptive raster, each band
+    // only touches its own rows of it.
+    MSDF_AdaptiveRaster *adaptive;
+} MSDF_RasterTask;
+
 typedef struct {
     F32 x_min;
     F32 y_min;
@@ -79,6 +327,9 @@ typedef struct {
     F32 advance_width;
     F32 left_side_bearing;
 
+    MSDF_Format format;
+    // NOTE(simon): Null when the output is streamed to a sink or written to
+    // a destination.
     U8 *data;
 } MSDF_RasterResult;
 
@@ -86,15 +337,32 @@ internal B32 msdf_distance_is_closer(MSDF_Distance a, MSDF_Distance b);
 
 internal B32 msdf_is_corner(MSDF_Segment a, MSDF_Segment b, F32 threshold);
 
-internal MSDF_Distance msdf_line_distance_orthogonality(V2F32 point, MSDF_Segment line);
-internal MSDF_Distance msdf_quadratic_bezier_distance_orthogonality(V2F32 point, MSDF_Segment bezier);
+// NOTE(simon): The distance functions are evaluated for every pixel, so they
+// use the coefficients of the segment instead of its points.
+internal Void msdf_segment_precompute(MSDF_Segment *segment);
 
-internal F32 msdf_line_signed_pseudo_distance(V2F32 point, MSDF_Segment line);
-internal F32 msdf_quadratic_bezier_signed_pseudo_distance(V2F32 point, MSDF_Segment bezier, F32 clamped_t);
+internal MSDF_Distance msdf_line_distance_orthogonality(V2F32 point, MSDF_Segment *line);
+internal MSDF_Distance msdf_quadratic_bezier_distance_orthogonality(V2F32 point, MSDF_Segment *bezier);
+internal MSDF_Distance msdf_cubic_bezier_distance_orthogonality(V2F32 point, MSDF_Segment *bezier);
+// NOTE(simon): Same as msdf_quadratic_bezier_distance_orthogonality, but
+// starts from the closest parameter in seed and stores the new one there.
+internal MSDF_Distance msdf_quadratic_bezier_distance_orthogonality_seeded(V2F32 point, MSDF_Segment *bezier, F32 *seed);
+
+internal F32 msdf_line_signed_pseudo_distance(V2F32 point, MSDF_Segment *line);
+internal F32 msdf_quadratic_bezier_signed_pseudo_distance(V2F32 point, MSDF_Segment *bezier, F32 unclamped_t);
+internal F32 msdf_cubic_bezier_signed_pseudo_distance(V2F32 point, MSDF_Segment *bezier, F32 unclamped_t);
+
+// NOTE(simon): The last point of the segment and the control points leading
+// out of and into it, for code that needs to treat all segment kinds the same.
+internal V2F32 *msdf_segment_end(MSDF_Segment *segment);
+internal V2F32  msdf_segment_start_control(MSDF_Segment segment);
+internal V2F32  msdf_segment_end_control(MSDF_Segment segment);
+internal V2F32  msdf_segment_point(MSDF_Segment segment, F32 t);
 
 internal Void msdf_segment_split(MSDF_Segment segment, F32 t, MSDF_Segment *result_a, MSDF_Segment *result_b);
 internal U32 msdf_segment_intersect(MSDF_Segment a, MSDF_Segment b, F32 *result_ats, F32 *result_bts);
 
+internal U32 msdf_segment_horizontal_crossings(MSDF_Segment segment, F32 y, F32 *result_xs, S32 *result_directions);
 internal S32 msdf_contour_calculate_own_winding_number(MSDF_Contour *contour);
 internal S32 msdf_contour_calculate_winding_number(MSDF_Contour *contour, V2F32 point);
 
@@ -102,6 +370,49 @@ internal Void msdf_resolve_contour_overlap(Arena *arena, MSDF_Glyph *glyph);
 internal Void msdf_convert_to_simple_polygons(Arena *arena, MSDF_Glyph *glyph);
 internal Void msdf_correct_contour_orientation(MSDF_Glyph *glyph);
 
-internal MSDF_RasterResult msdf_generate(Arena *arena, TTF_Font *font, U32 codepoint, U32 render_size);
+internal B32  msdf_texels_clash(V4F32 a, V4F32 b, F32 threshold);
+internal Void msdf_correct_errors(Arena *arena, V4F32 *pixels, U32 width, U32 height, F32 threshold);
+
+internal U32  msdf_channel_count_from_format(MSDF_Format format);
+internal U32  msdf_pixel_size_from_format(MSDF_Format format);
+internal Void msdf_store_pixel(U8 *destination, MSDF_Format format, F32 red, F32 green, F32 blue, F32 alpha);
+
+internal F32          msdf_segment_distance(V2F32 point, MSDF_Segment *segment);
+internal MSDF_Sample  msdf_sample(MSDF_Segment *segments, MSDF_CandidateList *candidates, F32 *seeds, V2F32 point, F32 distance_range, MSDF_Mode mode);
+internal MSDF_Sample  msdf_sample_sdf(MSDF_Segment *segments, MSDF_CandidateList *candidates, F32 *seeds, V2F32 point, F32 distance_range);
+
+internal MSDF_Sample *msdf_adaptive_sample(MSDF_AdaptiveRaster *raster, MSDF_CandidateList *candidates, U32 x, U32 y);
+internal F32          msdf_segment_lower_bound(MSDF_Segment *segment, V2F32 center, F32 half_diagonal, F32 threshold);
+internal Void         msdf_cull_candidates(MSDF_AdaptiveRaster *raster, MSDF_CandidateList *candidates, MSDF_Sample **samples, V2F32 center, F32 half_diagonal, MSDF_CandidateList *result);
+internal B32          msdf_segment_wins_block(MSDF_AdaptiveRaster *raster, MSDF_CandidateList *candidates, MSDF_Segment *winner, MSDF_ColorFlags colors, F32 max_distance, V2F32 center, F32 half_diagonal);
+internal B32          msdf_block_is_affine(MSDF_AdaptiveRaster *raster, MSDF_CandidateList *candidates, MSDF_Sample **samples, V2F32 *corners, V2F32 center, F32 half_diagonal);
+internal Void         msdf_rasterize_block(MSDF_AdaptiveRaster *raster, MSDF_CandidateList *candidates, U32 x0, U32 y0, U32 x1, U32 y1);
+
+internal Void msdf_fill_narrow_band(MSDF_RasterTask *task, U32 y_min, U32 y_max, F32 *crossing_xs, S32 *crossing_directions);
+internal Void msdf_rasterize_band(Void *data, U32 band_index);
+
+// NOTE(simon): Removes contours smaller than MSDF_SIMPLIFY_MIN_CONTOUR_SIZE,
+// demotes nearly flat curves to lines, and drops short lines and merges runs
+// of nearly collinear ones, all within MSDF_SIMPLIFY_TOLERANCE. Every segment
+// removed is work saved for every pixel. The pixel size is in font units.
+internal F32  msdf_chord_distance(V2F32 point, V2F32 a, V2F32 b);
+internal Void msdf_simplify_glyph(MSDF_Glyph *glyph, V2F32 pixel_size);
+
+// NOTE(simon): Glyphs prepared for MSDF_Mode_SDF have every segment in all
+// channels instead of colored edges.
+internal MSDF_PreparedGlyph *msdf_prepare_glyph(Arena *arena, TTF_Font *font, U32 glyph_index, U32 render_size, MSDF_Mode mode);
+// NOTE(simon): Same as msdf_prepare_glyph, but the result is cached in the
+// font and shared between all callers. The glyph is prepared for the render
+// size rounded up to a power of 2, so all sizes in between share it. When the
+// cache is full the glyph is prepared in arena instead.
+internal MSDF_PreparedGlyph *msdf_get_prepared_glyph(Arena *arena, TTF_Font *font, U32 glyph_index, U32 render_size, MSDF_Mode mode);
+
+#define msdf_parameters(size, ...) (&(MSDF_GenerateParams) { .render_size = size, .mode = MSDF_Mode_MSDF, .format = MSDF_Format_RGBA8, .distance_range = 2.0f, .error_correction = true, __VA_ARGS__ })
+
+#define msdf_rasterize(arena, glyph, size, ...) msdf_rasterize_internal(arena, glyph, msdf_parameters(size, __VA_ARGS__))
+internal MSDF_RasterResult msdf_rasterize_internal(Arena *arena, MSDF_PreparedGlyph *glyph, MSDF_GenerateParams *parameters);
+
+#define msdf_generate(arena, font, codepoint, size, ...) msdf_generate_internal(arena, font, codepoint, msdf_parameters(size, __VA_ARGS__))
+internal MSDF_RasterResult msdf_generate_internal(Arena *arena, TTF_Font *font, U32 codepoint, MSDF_GenerateParams *parameters);
 
 #endif // MSDF_H
@@ -19,66 +19,64 @@ internal F32 ttf_f2dot14_to_f32(TTF_F2Dot14 x) {
 internal B32 ttf_parse_font_tables(Str8 data, TTF_Font *font) {
     B32 success = true;
 
-    U32 table_count = 0;
-    if (data.size >= sizeof(TTF_OffsetSubtable)) {
-        TTF_OffsetSubtable *offset_subtable = (TTF_OffsetSubtable *) &data.data[0];
+    TTF_Reader reader = ttf_reader_from_str8(data);
 
-        U32 scaler_type = u32_big_to_local_endian(offset_subtable->scaler_type);
-        if (scaler_type == TTF_SCALER_TYPE_TRUE || scaler_type == TTF_SCALER_TYPE_1) {
-            table_count = u16_big_to_local_endian(offset_subtable->num_tables);
-        } else {
-            error_emit(str8_literal("ERROR(font/ttf): Unknown scaler type."));
-            success = false;
-        }
-    } else {
+    U32 scaler_type = ttf_read_u32(&reader);
+    U32 table_count = ttf_read_u16(&reader);
+    ttf_reader_skip(&reader, 3 * sizeof(U16)); // NOTE: search_range, entry_selector, range_shift
+
+    if (reader.error) {
         error_emit(str8_literal("ERROR(font/ttf): Not enough data for offset subtable."));
         success = false;
+    } else if (!(scaler_type == TTF_SCALER_TYPE_TRUE || scaler_type == TTF_SCALER_TYPE_1 || scaler_type == TTF_SCALER_TYPE_OTTO)) {
+        error_emit(str8_literal("ERROR(font/ttf): Unknown scaler type."));
+        success = false;
     }
 
-    TTF_TableDirectoryEntry *table_directory_entries = 0;
-    if (success) {
-        Str8 table_directory_data = str8_skip(data, sizeof(TTF_OffsetSubtable));
-        if (table_directory_data.size >= table_count * sizeof(TTF_TableDirectoryEntry)) {
-            table_directory_entries = (TTF_TableDirectoryEntry *) table_directory_data.data;
-        } else {
-            error_emit(str8_literal("ERROR(font/ttf): Not enough data for offset subtable."));
-            success = false;
-        }
+    if (success && ttf_reader_remaining(&reader) < table_count * sizeof(TTF_TableDirectoryEntry)) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data for table directory."));
+        success = false;
     }
 
-    if (success) {
-        for (U32 i = 0; i < table_count && success; ++i) {
-            TTF_TableDirectoryEntry *entry = &table_directory_entries[i];
-            U32 tag       = u32_big_to_local_endian(entry->tag);
-            U32 check_sum = u32_big_to_local_endian(entry->check_sum);
-            U32 offset    = u32_big_to_local_endian(entry->offset);
-            U32 length    = u32_big_to_local_endian(entry->length);
-
-            if (offset + length <= data.size) {
-                Str8 table_data = str8_substring(data, offset, length);
-
-                // TODO: Verify the check sum.
-
-                for (U32 j = 0; j < TTF_Table_COUNT && success; ++j) {
-                    if (tag == ttf_table_tags[j]) {
-                        if (!font->tables[j].data) {
-                            font->tables[j] = table_data;
-                        } else {
-                            error_emit(str8_literal("ERROR(font/ttf): Duplicated entry in the table directory."));
-                            success = false;
-                        }
+    for (U32 i = 0; i < table_count && success; ++i) {
+        U32 tag       = ttf_read_u32(&reader);
+        U32 check_sum = ttf_read_u32(&reader);
+        U64 offset    = ttf_read_u32(&reader);
+        U64 length    = ttf_read_u32(&reader);
+
+        if (offset + length <= data.size) {
+            Str8 table_data = str8_substring(data, offset, length);
+
+            // TODO: Verify the check sum.
+
+            for (U32 j = 0; j < TTF_Table_COUNT && success; ++j) {
+                if (tag == ttf_table_tags[j]) {
+                    if (!font->tables[j].data) {
+                        font->tables[j] = table_data;
+                    } else {
+                        error_emit(str8_literal("ERROR(font/ttf): Duplicated entry in the table directory."));
+                        success = false;
                     }
                 }
-            } else {
-                error_emit(str8_literal("ERROR(font/ttf): Table is referencing data outside of the file."));
-                success = false;
             }
+        } else {
+            error_emit(str8_literal("ERROR(font/ttf): Table is referencing data outside of the file."));
+            success = false;
         }
     }
 
     if (success) {
-        for (U32 i = 0; i < TTF_Table_MaxRequired && success; ++i) {
-            if (!font->tables[i].data) {
+        if (font->tables[TTF_Table_Glyf].data) {
+            font->outline_format = TTF_OutlineFormat_Glyf;
+        } else if (font->tables[TTF_Table_Cff].data) {
+            font->outline_format = TTF_OutlineFormat_Cff;
+        } else if (font->tables[TTF_Table_Cff2].data) {
+            font->outline_format = TTF_OutlineFormat_Cff2;
+        }
+
+        for (U32 i = 0; i <= TTF_Table_MaxRequired && success; ++i) {
+            B32 is_glyf_table = (i == TTF_Table_Glyf || i == TTF_Table_Loca);
+            if (!font->tables[i].data && !(is_glyf_table && font->outline_format != TTF_OutlineFormat_Glyf)) {
                 error_emit(str8_literal("ERROR(font/ttf): Not all required tables are present."));
                 success = false;
             }
@@ -91,65 +89,70 @@ internal B32 ttf_parse_font_tables(Str8 data, TTF_Font *font) {
 internal B32 ttf_parse_head_table(TTF_Font *font) {
     B32 success = true;
 
-    if (font->tables[TTF_Table_Head].size >= sizeof(TTF_HeadTable)) {
-        TTF_HeadTable *head = (TTF_HeadTable *) font->tables[TTF_Table_Head].data;
-
-        TTF_Fixed version             = u32_big_to_local_endian(head->version);
-        U32       magic_number        = u32_big_to_local_endian(head->magic_number);
-        U16       flags               = u16_big_to_local_endian(head->flags);
-        U16       units_per_em        = u16_big_to_local_endian(head->units_per_em);
-        TTF_FWord x_min               = u16_big_to_local_endian(head->x_min);
-        TTF_FWord y_min               = u16_big_to_local_endian(head->y_min);
-        TTF_FWord x_max               = u16_big_to_local_endian(head->x_max);
-        TTF_FWord y_max               = u16_big_to_local_endian(head->y_max);
-        U16       lowest_rec_ppem     = u16_big_to_local_endian(head->lowest_rec_ppem);
-        S16       font_direction_hint = s16_big_to_local_endian(head->font_direction_hint);
-        S16       index_to_loc_format = s16_big_to_local_endian(head->index_to_loc_format);
-        S16       glyph_data_format   = s16_big_to_local_endian(head->glyph_data_format);
-
-        if (success && version != TTF_MAKE_VERSION(1, 0)) {
-            error_emit(str8_literal("ERROR(font/ttf): Unsupported version of head table."));
-            success = false;
-        }
+    TTF_Reader reader = ttf_reader_from_str8(font->tables[TTF_Table_Head]);
+
+    TTF_Fixed version             = ttf_read_u32(&reader);
+    ttf_reader_skip(&reader, sizeof(TTF_Fixed) + sizeof(U32)); // NOTE: font_revision, check_sum_adjustment
+    U32       magic_number        = ttf_read_u32(&reader);
+    U16       flags               = ttf_read_u16(&reader);
+    U16       units_per_em        = ttf_read_u16(&reader);
+    ttf_reader_skip(&reader, 2 * sizeof(TTF_LongDateTime)); // NOTE: created, modified
+    TTF_FWord x_min               = ttf_read_s16(&reader);
+    TTF_FWord y_min               = ttf_read_s16(&reader);
+    TTF_FWord x_max               = ttf_read_s16(&reader);
+    TTF_FWord y_max               = ttf_read_s16(&reader);
+    ttf_reader_skip(&reader, sizeof(U16)); // NOTE: mac_style
+    U16       lowest_rec_ppem     = ttf_read_u16(&reader);
+    S16       font_direction_hint = ttf_read_s16(&reader);
+    S16       index_to_loc_format = ttf_read_s16(&reader);
+    S16       glyph_data_format   = ttf_read_s16(&reader);
+
+    if (reader.error) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data in head table."));
+        success = false;
+    }
 
-        // TODO: Validate check_sum_adjustment
+    if (success && version != TTF_MAKE_VERSION(1, 0)) {
+        error_emit(str8_literal("ERROR(font/ttf): Unsupported version of head table."));
+        success = false;
+    }
 
-        if (success && magic_number != TTF_MAGIC_NUMBER) {
-            error_emit(str8_literal("ERROR(font/ttf): Wrong magic number."));
-            success = false;
-        }
+    // TODO: Validate check_sum_adjustment
 
-        if (success && (flags & 0x0020) != 0) {
-            error_emit(str8_literal("ERROR(font/ttf): Flags required to be unset are set."));
-            success = false;
-        }
+    if (success && magic_number != TTF_MAGIC_NUMBER) {
+        error_emit(str8_literal("ERROR(font/ttf): Wrong magic number."));
+        success = false;
+    }
 
-        if (success && !(64 <= units_per_em && units_per_em <= 16384)) {
-            error_emit(str8_literal("ERROR(font/ttf): Invalid number of units per em."));
-            success = false;
-        }
+    if (success && (flags & 0x0020) != 0) {
+        error_emit(str8_literal("ERROR(font/ttf): Flags required to be unset are set."));
+        success = false;
+    }
 
-        if (success && !(-2 <= font_direction_hint && font_direction_hint <= 2)) {
-            error_emit(str8_literal("ERROR(font/ttf): Invalid font direction hint."));
-            success = false;
-        }
+    if (success && !(64 <= units_per_em && units_per_em <= 16384)) {
+        error_emit(str8_literal("ERROR(font/ttf): Invalid number of units per em."));
+        success = false;
+    }
 
-        if (success && !(index_to_loc_format == 0 || index_to_loc_format == 1)) {
-            error_emit(str8_literal("ERROR(font/ttf): Unknown index to location format."));
-            success = false;
-        }
+    if (success && !(-2 <= font_direction_hint && font_direction_hint <= 2)) {
+        error_emit(str8_literal("ERROR(font/ttf): Invalid font direction hint."));
+        success = false;
+    }
 
-        if (success && glyph_data_format != 0) {
-            error_emit(str8_literal("ERROR(font/ttf): Unknown glyph data format."));
-            success = false;
-        }
+    if (success && !(index_to_loc_format == 0 || index_to_loc_format == 1)) {
+        error_emit(str8_literal("ERROR(font/ttf): Unknown index to location format."));
+        success = false;
+    }
+
+    if (success && glyph_data_format != 0) {
+        error_emit(str8_literal("ERROR(font/ttf): Unknown glyph data format."));
+        success = false;
+    }
 
+    if (success) {
         font->is_long_loca_format = (index_to_loc_format == 1);
         font->funits_per_em       = units_per_em;
         font->lowest_rec_ppem     = lowest_rec_ppem;
-    } else {
-        error_emit(str8_literal("ERROR(font/ttf): Not enough data in head table."));
-        success = false;
     }
 
     return success;
@@ -158,39 +161,51 @@ internal B32 ttf_parse_head_table(TTF_Font *font) {
 internal B32 ttf_parse_maxp_table(Arena *arena, TTF_Font *font) {
     B32 success = true;
 
-    if (font->tables[TTF_Table_Maxp].size >= sizeof(TTF_MaxpTable)) {
-        TTF_MaxpTable *maxp = (TTF_MaxpTable *) font->tables[TTF_Table_Maxp].data;
+    TTF_Reader reader = ttf_reader_from_str8(font->tables[TTF_Table_Maxp]);
 
-        TTF_Fixed version                = u32_big_to_local_endian(maxp->version);
-        U16       num_glyphs             = u16_big_to_local_endian(maxp->num_glyphs);
-        U16       max_zones              = u16_big_to_local_endian(maxp->max_zones);
-        U16       max_component_depth    = u16_big_to_local_endian(maxp->max_component_depth);
-        U16       max_contours           = u16_big_to_local_endian(maxp->max_contours);
-        U16       max_component_contours = u16_big_to_local_endian(maxp->max_component_contours);
-        U16       max_points             = u16_big_to_local_endian(maxp->max_points);
-        U16       max_component_points   = u16_big_to_local_endian(maxp->max_component_points);
+    TTF_Fixed version                = ttf_read_u32(&reader);
+    U16       num_glyphs             = ttf_read_u16(&reader);
 
-        if (success && version != TTF_MAKE_VERSION(1, 0)) {
-            error_emit(str8_literal("ERROR(font/ttf): Unsupported version of maxp table."));
-            success = false;
-        }
+    // NOTE: Version 0.5 is used with CFF outlines and ends after num_glyphs.
+    B32       is_short_version       = (!reader.error && version == TTF_MAKE_VERSION(0, 0x5000) && font->outline_format != TTF_OutlineFormat_Glyf);
 
-        if (success && !(1 <= max_zones && max_zones <= 2)) {
-            error_emit(str8_literal("ERROR(font/ttf): Max zones must between 1 and 2 inclusive."));
-            success = false;
-        }
+    U16       max_points             = ttf_read_u16(&reader);
+    U16       max_contours           = ttf_read_u16(&reader);
+    U16       max_component_points   = ttf_read_u16(&reader);
+    U16       max_component_contours = ttf_read_u16(&reader);
+    U16       max_zones              = ttf_read_u16(&reader);
+    ttf_reader_skip(&reader, 6 * sizeof(U16)); // NOTE: max_twilight_points through max_size_of_instructions
+    U16       max_component_elements = ttf_read_u16(&reader);
+    U16       max_component_depth    = ttf_read_u16(&reader);
 
-        if (success && max_component_depth > 16) {
-            error_emit(str8_literal("ERROR(font/ttf): Max component depth is outside of the legal range."));
-            success = false;
-        }
+    if (reader.error && !is_short_version) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data in maxp table."));
+        success = false;
+    }
+
+    if (success && !is_short_version && version != TTF_MAKE_VERSION(1, 0)) {
+        error_emit(str8_literal("ERROR(font/ttf): Unsupported version of maxp table."));
+        success = false;
+    }
 
-        font->glyph_count = num_glyphs;
+    if (success && !is_short_version && !(1 <= max_zones && max_zones <= 2)) {
+        error_emit(str8_literal("ERROR(font/ttf): Max zones must between 1 and 2 inclusive."));
+        success = false;
+    }
+
+    if (success && !is_short_version && max_component_depth > 16) {
+        error_emit(str8_literal("ERROR(font/ttf): Max component depth is outside of the legal range."));
+        success = false;
+    }
+
+    if (success) {
+        font->glyph_count      = num_glyphs;
         font->contour_capacity = u16_max(max_contours, max_component_contours);
         font->point_capacity   = u16_max(max_points,   max_component_points);
-    } else {
-        error_emit(str8_literal("ERROR(font/ttf): Not enough data in maxp table."));
-        success = false;
+
+        // NOTE: Some fonts leave max_component_elements at 0 even though
+        // they contain compound glyphs, so always leave room for a few.
+        font->component_capacity = u16_max(max_component_elements, 16);
     }
 
     return success;
@@ -199,50 +214,68 @@ internal B32 ttf_parse_maxp_table(Arena *arena, TTF_Font *font) {
 internal B32 ttf_validate_metrics(TTF_Font *font) {
     B32 success = true;
 
-    TTF_HheaTable *hhea = (TTF_HheaTable *) font->tables[TTF_Table_Hhea].data;
     Str8 hmtx_data = font->tables[TTF_Table_Hmtx];
 
-    if (font->tables[TTF_Table_Hhea].size >= sizeof(TTF_HheaTable)) {
-        TTF_Fixed version             = u32_big_to_local_endian(hhea->version);
-        S16       caret_slope_rise    = s16_big_to_local_endian(hhea->caret_slope_rise);
-        S16       caret_slope_run     = s16_big_to_local_endian(hhea->caret_slope_run);
-        S16       metric_data_format  = s16_big_to_local_endian(hhea->metric_data_format);
-        U16       advance_width_count = u16_big_to_local_endian(hhea->num_of_long_hor_metrics);
+    TTF_Reader reader = ttf_reader_from_str8(font->tables[TTF_Table_Hhea]);
+
+    TTF_Fixed version             = ttf_read_u32(&reader);
+    ttf_reader_skip(&reader, 7 * sizeof(U16)); // NOTE: ascent through x_max_extent
+    S16       caret_slope_rise    = ttf_read_s16(&reader);
+    S16       caret_slope_run     = ttf_read_s16(&reader);
+    ttf_reader_skip(&reader, sizeof(TTF_FWord)); // NOTE: caret_offset
+    S16       reserved0           = ttf_read_s16(&reader);
+    S16       reserved1           = ttf_read_s16(&reader);
+    S16       reserved2           = ttf_read_s16(&reader);
+    S16       reserved3           = ttf_read_s16(&reader);
+    S16       metric_data_format  = ttf_read_s16(&reader);
+    U16       advance_width_count = ttf_read_u16(&reader);
+
+    if (reader.error) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data in hhea table."));
+        success = false;
+    }
 
-        U32 left_side_bearing_count = font->glyph_count - advance_width_count;
+    if (success && version != TTF_MAKE_VERSION(1, 0)) {
+        error_emit(str8_literal("ERROR(font/ttf): Unsupported version of hhea table."));
+        success = false;
+    }
 
-        if (success && version != TTF_MAKE_VERSION(1, 0)) {
-            error_emit(str8_literal("ERROR(font/ttf): Unsupported version of hhea table."));
-            success = false;
-        }
+    if (success && caret_slope_rise == 0 && caret_slope_run == 0) {
+        error_emit(str8_literal("ERROR(font/ttf): Both the caret slopes rise and run are 0."));
+        success = false;
+    }
 
-        if (success && caret_slope_rise == 0 && caret_slope_run == 0) {
-            error_emit(str8_literal("ERROR(font/ttf): Both the caret slopes rise and run are 0."));
-            success = false;
-        }
+    if (success && !(reserved0 == 0 && reserved1 == 0 && reserved2 == 0 && reserved3 == 0)) {
+        error_emit(str8_literal("ERROR(font/ttf): Reserved fields in hhea are not set to 0."));
+        success = false;
+    }
 
-        if (success && !(hhea->reserved0 == 0 && hhea->reserved1 == 0 && hhea->reserved2 == 0 && hhea->reserved3 == 0)) {
-            error_emit(str8_literal("ERROR(font/ttf): Reserved fields in hhea are not set to 0."));
-            success = false;
-        }
+    if (success && metric_data_format != 0) {
+        error_emit(str8_literal("ERROR(font/ttf): Unknown metric data format."));
+        success = false;
+    }
 
-        if (success && metric_data_format != 0) {
-            error_emit(str8_literal("ERROR(font/ttf): Unknown metric data format."));
-            success = false;
-        }
+    if (success && advance_width_count == 0) {
+        error_emit(str8_literal("ERROR(font/ttf): There must be at least one long-form entry in the hmtx table."));
+        success = false;
+    }
 
-        if (success && advance_width_count == 0) {
-            error_emit(str8_literal("ERROR(font/ttf): There must be at least one long-form entry in the hmtx table."));
-            success = false;
-        }
+    if (success && advance_width_count > font->glyph_count) {
+        error_emit(str8_literal("ERROR(font/ttf): There are more long-form entries in the hmtx table than glyphs."));
+        success = false;
+    }
+
+    if (success) {
+        U32 left_side_bearing_count = font->glyph_count - advance_width_count;
 
-        if (success && hmtx_data.size < advance_width_count * sizeof(TTF_HmtxMetrics) + left_side_bearing_count * sizeof(TTF_FWord)) {
+        if (hmtx_data.size < advance_width_count * sizeof(TTF_HmtxMetrics) + left_side_bearing_count * sizeof(TTF_FWord)) {
             error_emit(str8_literal("ERROR(font/ttf): Not enough data in hmtx table."));
             success = false;
         }
-    } else {
-        error_emit(str8_literal("ERROR(font/ttf): Not enough data in hhea table."));
-        success = false;
+    }
+
+    if (success) {
+        font->advance_width_count = advance_width_count;
     }
 
     return success;
@@ -251,33 +284,24 @@ internal B32 ttf_validate_metrics(TTF_Font *font) {
 internal TTF_HmtxMetrics ttf_get_metrics(TTF_Font *font, U32 glyph_index) {
     assert(glyph_index < font->glyph_count);
 
-    TTF_HheaTable *hhea = (TTF_HheaTable *) font->tables[TTF_Table_Hhea].data;
     Str8 hmtx_data = font->tables[TTF_Table_Hmtx];
 
-    U32 advance_width_count     = u16_big_to_local_endian(hhea->num_of_long_hor_metrics);
-    U32 left_side_bearing_count = font->glyph_count - advance_width_count;
+    U32 advance_width_count = font->advance_width_count;
+    U32 base_metrics_index  = u32_min(glyph_index, advance_width_count - 1);
 
-    TTF_HmtxMetrics *metrics            = (TTF_HmtxMetrics *) hmtx_data.data;
-    TTF_FWord       *left_side_bearings = (TTF_FWord *) &hmtx_data.data[advance_width_count * sizeof(TTF_HmtxMetrics)];
-
-    U32 base_metrics_index = u32_min(glyph_index, advance_width_count - 1);
-    TTF_HmtxMetrics result = metrics[base_metrics_index];
+    TTF_HmtxMetrics result = { 0 };
+    result.advance_width     = ttf_u16_at(hmtx_data, base_metrics_index * sizeof(TTF_HmtxMetrics));
+    result.left_side_bearing = (TTF_FWord) ttf_u16_at(hmtx_data, base_metrics_index * sizeof(TTF_HmtxMetrics) + sizeof(TTF_UFWord));
 
     if (glyph_index >= advance_width_count) {
         U32 left_side_bearing_index = glyph_index - advance_width_count;
-        result.left_side_bearing = left_side_bearings[left_side_bearing_index];
+        result.left_side_bearing = (TTF_FWord) ttf_u16_at(hmtx_data, advance_width_count * sizeof(TTF_HmtxMetrics) + left_side_bearing_index * sizeof(TTF_FWord));
     }
 
-    result.advance_width     = u16_big_to_local_endian(result.advance_width);
-    result.left_side_bearing = s16_big_to_local_endian(result.left_side_bearing);
-
     return result;
 }
 
-internal U32 ttf_rank_subtable(TTF_CmapSubtable *subtable) {
-    U16 platform_id          = u16_big_to_local_endian(subtable->platform_id);
-    U16 platform_specifig_id = u16_big_to_local_endian(subtable->platform_specific_id);
-
+internal U32 ttf_rank_subtable(U16 platform_id, U16 platform_specifig_id) {
     U32 rank = 0;
 
     switch (platform_id) {
@@ -313,6 +337,45 @@ internal U32 ttf_rank_subtable(TTF_CmapSubtable *subtable) {
     return rank;
 }
 
+internal TTF_CmapFormat4Segment ttf_cmap_format4_segment(Str8 subtable_data, U32 segment_count, U32 segment_index) {
+    U64 end_code_offset        = sizeof(TTF_CmapFormat4);
+    U64 start_code_offset      = end_code_offset        + (segment_count + 1) * sizeof(U16);
+    U64 id_delta_offset        = start_code_offset      + segment_count * sizeof(U16);
+    U64 id_range_offset_offset = id_delta_offset        + segment_count * sizeof(U16);
+
+    TTF_CmapFormat4Segment result = { 0 };
+    result.end                   = ttf_u16_at(subtable_data, end_code_offset        + segment_index * sizeof(U16));
+    result.start                 = ttf_u16_at(subtable_data, start_code_offset      + segment_index * sizeof(U16));
+    result.delta                 = ttf_u16_at(subtable_data, id_delta_offset        + segment_index * sizeof(U16));
+    result.id_range_offset       = ttf_u16_at(subtable_data, id_range_offset_offset + segment_index * sizeof(U16));
+    result.id_range_offset_start = id_range_offset_offset + segment_index * sizeof(U16);
+    return result;
+}
+
+// NOTE: The codepoint has to be within [start, end] of the segment.
+internal U32 ttf_cmap_format4_glyph_index(Str8 subtable_data, TTF_CmapFormat4Segment *segment, U32 codepoint) {
+    U32 result = 0;
+
+    if (segment->id_range_offset == 0) {
+        result = (segment->delta + codepoint) % 65536;
+    } else {
+        // NOTE: The offset is relative to the id_range_offset entry itself.
+        U64 glyph_index_offset = segment->id_range_offset_start + segment->id_range_offset + (codepoint - segment->start) * sizeof(U16);
+
+        if (glyph_index_offset + sizeof(U16) <= subtable_data.size) {
+            U16 raw_glyph_index = ttf_u16_at(subtable_data, glyph_index_offset);
+
+            if (raw_glyph_index) {
+                result = (raw_glyph_index + segment->delta) % 65536;
+            }
+        } else {
+            error_emit(str8_literal("ERROR(font/ttf): Format 4 cmap access data outside of its subtable."));
+        }
+    }
+
+    return result;
+}
+
 // TODO: Ensure that no codepoint is mapped to glyph index 0xFFFF.
 // TODO: Unicode varition sequence subtables.
 internal U32 ttf_get_glyph_index(TTF_Font *font, U32 codepoint) {
@@ -322,65 +385,36 @@ internal U32 ttf_get_glyph_index(TTF_Font *font, U32 codepoint) {
 
     switch (font->character_map_format) {
         case 0: {
-            TTF_CmapFormat0 *format = (TTF_CmapFormat0 *) subtable_data.data;
-
-            if (codepoint < array_count(format->glyph_index_array)) {
-                result = format->glyph_index_array[codepoint];
+            if (codepoint < array_count(member(TTF_CmapFormat0, glyph_index_array))) {
+                result = subtable_data.data[member_offset(TTF_CmapFormat0, glyph_index_array) + codepoint];
             }
         } break;
         case 2: {
             assert(!"Not reached!");
         } break;
         case 4: {
-            TTF_CmapFormat4 *format = (TTF_CmapFormat4 *) subtable_data.data;
-
-            U32 segment_count = u16_big_to_local_endian(format->seg_count_x2) / 2;
-
-            U16 *end_code        = (U16 *) (subtable_data.data + sizeof(TTF_CmapFormat4));
-            U16 *start_code      = (U16 *) (subtable_data.data + sizeof(TTF_CmapFormat4) + sizeof(U16) + 1 * segment_count * sizeof(U16));
-            U16 *id_delta        = (U16 *) (subtable_data.data + sizeof(TTF_CmapFormat4) + sizeof(U16) + 2 * segment_count * sizeof(U16));
-            U16 *id_range_offset = (U16 *) (subtable_data.data + sizeof(TTF_CmapFormat4) + sizeof(U16) + 3 * segment_count * sizeof(U16));
-
-            U32 glyph_index_array_count = (subtable_data.size - (sizeof(TTF_CmapFormat4) + (4 * segment_count + 1) * sizeof(U16))) / sizeof(U16);
+            U32 segment_count = ttf_u16_at(subtable_data, member_offset(TTF_CmapFormat4, seg_count_x2)) / 2;
 
             for (U32 i = 0; i < segment_count; ++i) {
-                U16 start  = u16_big_to_local_endian(start_code[i]);
-                U16 end    = u16_big_to_local_endian(end_code[i]);
-                U16 offset = u16_big_to_local_endian(id_range_offset[i]) / 2;
-                U16 delta  = u16_big_to_local_endian(id_delta[i]);
-
-                if (start <= codepoint && codepoint <= end) {
-                    // NOTE: This is fine to read without a byteswap.
-                    if (id_range_offset[i] == 0) {
-                        result = (delta + codepoint) % 65536;
-                    } else {
-                        U32 lowest_glyph_index_index  = i + offset + (start - start);
-                        U32 highest_glyph_index_index = i + offset + (end   - start);
+                U16 end = ttf_u16_at(subtable_data, sizeof(TTF_CmapFormat4) + i * sizeof(U16));
 
-                        if (segment_count <= lowest_glyph_index_index && highest_glyph_index_index <= segment_count + glyph_index_array_count) {
-                            U16 raw_glyph_index = u16_big_to_local_endian(id_range_offset[i + offset + (codepoint - start)]);
-
-                            if (raw_glyph_index) {
-                                result = (raw_glyph_index + delta) % 65536;
-                            }
-                        } else {
-                            error_emit(str8_literal("ERROR(font/ttf): Format 4 cmap access data outside of its subtable."));
-                        }
+                if (codepoint <= end) {
+                    TTF_CmapFormat4Segment segment = ttf_cmap_format4_segment(subtable_data, segment_count, i);
+                    if (segment.start <= codepoint) {
+                        result = ttf_cmap_format4_glyph_index(subtable_data, &segment, codepoint);
                     }
 
+                    // NOTE: End codes are sorted, so no later segment can contain the codepoint.
                     break;
                 }
             }
         } break;
         case 6: {
-            TTF_CmapFormat6 *format = (TTF_CmapFormat6 *) subtable_data.data;
+            U32 first_code  = ttf_u16_at(subtable_data, member_offset(TTF_CmapFormat6, first_code));
+            U32 entry_count = ttf_u16_at(subtable_data, member_offset(TTF_CmapFormat6, entry_count));
 
-            U32  first_code        = u16_big_to_local_endian(format->first_code);
-            U32  entry_count       = u16_big_to_local_endian(format->entry_count);
-            U16 *glyph_index_array = (U16 *) &subtable_data.data[sizeof(*format)];
-
-            if (codepoint < first_code + entry_count) {
-                result = u16_big_to_local_endian(glyph_index_array[codepoint - first_code]);
+            if (first_code <= codepoint && codepoint < first_code + entry_count) {
+                result = ttf_u16_at(subtable_data, sizeof(TTF_CmapFormat6) + (codepoint - first_code) * sizeof(U16));
             }
         } break;
         case 8: {
@@ -390,15 +424,14 @@ internal U32 ttf_get_glyph_index(TTF_Font *font, U32 codepoint) {
             assert(!"Not reached!");
         } break;
         case 12: {
-            TTF_CmapFormat12 *format = (TTF_CmapFormat12 *) subtable_data.data;
-
-            U32                    group_count = u32_big_to_local_endian(format->n_groups);
-            TTF_CmapFormat12Group *groups      = (TTF_CmapFormat12Group *) &subtable_data.data[sizeof(*format)];
+            U32 group_count = ttf_u32_at(subtable_data, member_offset(TTF_CmapFormat12, n_groups));
 
             for (U32 i = 0; i < group_count; ++i) {
-                U32 first_codepoint   = u32_big_to_local_endian(groups[i].start_char_code);
-                U32 last_codepoint    = u32_big_to_local_endian(groups[i].end_char_code);
-                U32 first_glyph_index = u32_big_to_local_endian(groups[i].start_glyph_code);
+                U64 group_offset = sizeof(TTF_CmapFormat12) + i * sizeof(TTF_CmapFormat12Group);
+
+                U32 first_codepoint   = ttf_u32_at(subtable_data, group_offset + member_offset(TTF_CmapFormat12Group, start_char_code));
+                U32 last_codepoint    = ttf_u32_at(subtable_data, group_offset + member_offset(TTF_CmapFormat12Group, end_char_code));
+                U32 first_glyph_index = ttf_u32_at(subtable_data, group_offset + member_offset(TTF_CmapFormat12Group, start_glyph_code));
 
                 if (first_codepoint <= codepoint && codepoint <= last_codepoint) {
                     result = first_glyph_index + (codepoint - first_codepoint);
@@ -425,62 +458,55 @@ internal B32 ttf_choose_character_map(TTF_Font *font) {
 
     B32 success = true;
 
-    TTF_CmapTable    *cmap           = 0;
-    U32               subtable_count = 0;
-    TTF_CmapSubtable *subtables      = 0;
+    TTF_Reader reader = ttf_reader_from_str8(cmap_data);
 
-    if (cmap_data.size >= sizeof(TTF_CmapTable)) {
-        cmap = (TTF_CmapTable *) cmap_data.data;
-        U16 version    = u16_big_to_local_endian(cmap->version);
-        subtable_count = u16_big_to_local_endian(cmap->number_subtables);
+    U16 version        = ttf_read_u16(&reader);
+    U32 subtable_count = ttf_read_u16(&reader);
 
-        if (success && version != 0) {
-            error_emit(str8_literal("ERROR(font/ttf): Unsupported version of cmap table."));
-            success = false;
-        }
-    } else {
+    if (reader.error) {
         error_emit(str8_literal("ERROR(font/ttf): Not enough data for cmap table."));
         success = false;
+    } else if (version != 0) {
+        error_emit(str8_literal("ERROR(font/ttf): Unsupported version of cmap table."));
+        success = false;
     }
 
-    if (success) {
-        Str8 subtable_data = str8_skip(cmap_data, sizeof(TTF_CmapTable));
-        if (subtable_data.size >= subtable_count * sizeof(TTF_CmapSubtable)) {
-            subtables = (TTF_CmapSubtable *) subtable_data.data;
-        } else {
-            error_emit(str8_literal("ERROR(font/ttf): Not enough data for cmap subtables."));
-            success = false;
-        }
+    if (success && ttf_reader_remaining(&reader) < subtable_count * sizeof(TTF_CmapSubtable)) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data for cmap subtables."));
+        success = false;
     }
 
-    TTF_CmapSubtable *subtable = 0;
+    U64 subtable_offset = 0;
     if (success) {
         U32 rank = 0;
         for (U32 i = 0; i < subtable_count; ++i) {
-            TTF_CmapSubtable *possible_subtable = &subtables[i];
-            U32 new_rank = ttf_rank_subtable(possible_subtable);
+            U16 platform_id          = ttf_read_u16(&reader);
+            U16 platform_specific_id = ttf_read_u16(&reader);
+            U32 offset               = ttf_read_u32(&reader);
+
+            U32 new_rank = ttf_rank_subtable(platform_id, platform_specific_id);
             if (new_rank > rank) {
-                subtable = possible_subtable;
-                rank     = new_rank;
+                subtable_offset = offset;
+                rank            = new_rank;
             }
         }
 
-        if (!subtable) {
+        if (rank == 0) {
             error_emit(str8_literal("ERROR(font/ttf): Could not find a suitable cmap subtable."));
             success = false;
         }
     }
 
-    if (success && u32_big_to_local_endian(subtable->offset) + sizeof(U16) > cmap_data.size) {
+    if (success && subtable_offset + sizeof(U16) > cmap_data.size) {
         error_emit(str8_literal("ERROR(font/ttf): Subtable is outside of cmap table."));
         success = false;
     }
 
     if (success) {
-        Str8 subtable_data = str8_skip(cmap_data, u32_big_to_local_endian(subtable->offset));
+        Str8 subtable_data = str8_skip(cmap_data, subtable_offset);
 
         font->character_map        = subtable_data;
-        font->character_map_format = u16_big_to_local_endian(*(U16 *) subtable_data.data);
+        font->character_map_format = ttf_u16_at(subtable_data, 0);
 
         switch (font->character_map_format) {
             case 0: {
@@ -495,33 +521,20 @@ internal B32 ttf_choose_character_map(TTF_Font *font) {
                 success = false;
             } break;
             case 4: {
-                if (subtable_data.size >= sizeof(TTF_CmapFormat4)) {
-                    TTF_CmapFormat4 *format = (TTF_CmapFormat4 *) subtable_data.data;
-
-                    U32 length        = u16_big_to_local_endian(format->length);
-                    U32 segment_count = u16_big_to_local_endian(format->seg_count_x2) / 2;
+                U32 length        = ttf_u16_at(subtable_data, member_offset(TTF_CmapFormat4, length));
+                U32 segment_count = ttf_u16_at(subtable_data, member_offset(TTF_CmapFormat4, seg_count_x2)) / 2;
 
-                    if (length <= subtable_data.size && length >= sizeof(TTF_CmapFormat4) + (4 * segment_count + 1) * sizeof(U16)) {
-                    } else {
-                        error_emit(str8_literal("ERROR(font/ttf): Not enough data for cmap format 4."));
-                        success = false;
-                    }
+                if (subtable_data.size >= sizeof(TTF_CmapFormat4) && length <= subtable_data.size && length >= sizeof(TTF_CmapFormat4) + (4 * segment_count + 1) * sizeof(U16)) {
+                    font->character_map = str8_prefix(subtable_data, length);
                 } else {
                     error_emit(str8_literal("ERROR(font/ttf): Not enough data for cmap format 4."));
                     success = false;
                 }
             } break;
             case 6: {
-                if (subtable_data.size >= sizeof(TTF_CmapFormat6)) {
-                    TTF_CmapFormat6 *format = (TTF_CmapFormat6 *) subtable_data.data;
-
-                    U32 entry_count = u16_big_to_local_endian(format->entry_count);
+                U32 entry_count = ttf_u16_at(subtable_data, member_offset(TTF_CmapFormat6, entry_count));
 
-                    if (subtable_data.size < sizeof(TTF_CmapFormat6) + entry_count * sizeof(U16)) {
-                        error_emit(str8_literal("ERROR(font/ttf): Not enough data for cmap format 6."));
-                        success = false;
-                    }
-                } else {
+                if (subtable_data.size < sizeof(TTF_CmapFormat6) + entry_count * sizeof(U16)) {
                     error_emit(str8_literal("ERROR(font/ttf): Not enough data for cmap format 6."));
                     success = false;
                 }
@@ -535,22 +548,15 @@ internal B32 ttf_choose_character_map(TTF_Font *font) {
                 success = false;
             } break;
             case 12: {
-                if (subtable_data.size >= sizeof(TTF_CmapFormat12)) {
-                    TTF_CmapFormat12 *format = (TTF_CmapFormat12 *) subtable_data.data;
-
-                    U32 length      = u32_big_to_local_endian(format->length);
-                    U32 group_count = u32_big_to_local_endian(format->n_groups);
+                U64 length      = ttf_u32_at(subtable_data, member_offset(TTF_CmapFormat12, length));
+                U64 group_count = ttf_u32_at(subtable_data, member_offset(TTF_CmapFormat12, n_groups));
 
-                    if (length > subtable_data.size) {
-                        error_emit(str8_literal("ERROR(font/ttf): Not enough data for cmap format 12."));
-                        success = false;
-                    } else if (sizeof(TTF_CmapFormat12) + group_count * sizeof(TTF_CmapFormat12Group) > subtable_data.size) {
-                        error_emit(str8_literal("ERROR(font/ttf): Not enough data for cmap format 12 groups."));
-                        success = false;
-                    }
-                } else {
+                if (subtable_data.size < sizeof(TTF_CmapFormat12) || length > subtable_data.size) {
                     error_emit(str8_literal("ERROR(font/ttf): Not enough data for cmap format 12."));
                     success = false;
+                } else if (sizeof(TTF_CmapFormat12) + group_count * sizeof(TTF_CmapFormat12Group) > subtable_data.size) {
+                    error_emit(str8_literal("ERROR(font/ttf): Not enough data for cmap format 12 groups."));
+                    success = false;
                 }
             } break;
             case 13: {
@@ -571,168 +577,600 @@ internal B32 ttf_choose_character_map(TTF_Font *font) {
     return success;
 }
 
-internal B32 ttf_get_glyph_outlines(TTF_Font *font, U32 glyph_index, U32 contour_capacity, U32 point_capacity, TTF_Glyph *result_glyph) {
-    B32 success = true;
+internal U32 ttf_push_codepoint(TTF_Font *font, U32 *codepoints, U32 *glyph_indicies, U32 count, U32 codepoint, U64 glyph_index) {
+    if (glyph_index != 0 && glyph_index < font->glyph_count) {
+        if (codepoints) {
+            codepoints[count]     = codepoint;
+            glyph_indicies[count] = (U32) glyph_index;
+        }
+        ++count;
+    }
+    return count;
+}
+
+// NOTE: Walks every codepoint covered by the character map and returns how
+// many of them map to a valid glyph, also storing them if codepoints isn't 0.
+// Segments and groups that are out of order are skipped so that the result is
+// sorted and can't contain duplicates.
+internal U32 ttf_collect_codepoints(TTF_Font *font, U32 *codepoints, U32 *glyph_indicies) {
+    U32  count         = 0;
+    Str8 subtable_data = font->character_map;
+
+    switch (font->character_map_format) {
+        case 0: {
+            for (U32 codepoint = 0; codepoint < array_count(member(TTF_CmapFormat0, glyph_index_array)); ++codepoint) {
+                U32 glyph_index = subtable_data.data[member_offset(TTF_CmapFormat0, glyph_index_array) + codepoint];
+                count = ttf_push_codepoint(font, codepoints, glyph_indicies, count, codepoint, glyph_index);
+            }
+        } break;
+        case 4: {
+            U32 segment_count = ttf_u16_at(subtable_data, member_offset(TTF_CmapFormat4, seg_count_x2)) / 2;
 
-    Str8 glyph_data = font->raw_glyph_data[glyph_index];
-    U32  read_index = 0;
+            U32 next_codepoint = 0;
+            for (U32 i = 0; i < segment_count; ++i) {
+                TTF_CmapFormat4Segment segment = ttf_cmap_format4_segment(subtable_data, segment_count, i);
 
-    TTF_GlyphHeader *header = 0;
-    S16 contour_count       = 0;
-    if (success && glyph_data.size >= read_index + sizeof(TTF_GlyphHeader)) {
-        header = (TTF_GlyphHeader *) &glyph_data.data[read_index];
-        read_index += sizeof(TTF_GlyphHeader);
+                if (next_codepoint <= segment.start && segment.start <= segment.end) {
+                    for (U32 codepoint = segment.start; codepoint <= segment.end; ++codepoint) {
+                        U32 glyph_index = ttf_cmap_format4_glyph_index(subtable_data, &segment, codepoint);
+                        count = ttf_push_codepoint(font, codepoints, glyph_indicies, count, codepoint, glyph_index);
+                    }
 
-        result_glyph->x_min = s16_big_to_local_endian(header->x_min);
-        result_glyph->y_min = s16_big_to_local_endian(header->y_min);
-        result_glyph->x_max = s16_big_to_local_endian(header->x_max);
-        result_glyph->y_max = s16_big_to_local_endian(header->y_max);
+                    next_codepoint = (U32) segment.end + 1;
+                }
+            }
+        } break;
+        case 6: {
+            U32 first_code  = ttf_u16_at(subtable_data, member_offset(TTF_CmapFormat6, first_code));
+            U32 entry_count = ttf_u16_at(subtable_data, member_offset(TTF_CmapFormat6, entry_count));
 
-        contour_count = s16_big_to_local_endian(header->number_of_contours);
-    } else {
-        error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph outlines."));
-        success = false;
+            for (U32 i = 0; i < entry_count; ++i) {
+                U32 glyph_index = ttf_u16_at(subtable_data, sizeof(TTF_CmapFormat6) + i * sizeof(U16));
+                count = ttf_push_codepoint(font, codepoints, glyph_indicies, count, first_code + i, glyph_index);
+            }
+        } break;
+        case 12: {
+            U32 group_count = ttf_u32_at(subtable_data, member_offset(TTF_CmapFormat12, n_groups));
+
+            // NOTE: Clamp to the Unicode range so that a single broken group
+            // can't make us walk billions of codepoints.
+            U32 next_codepoint = 0;
+            for (U32 i = 0; i < group_count; ++i) {
+                U64 group_offset = sizeof(TTF_CmapFormat12) + i * sizeof(TTF_CmapFormat12Group);
+
+                U32 first_codepoint   = ttf_u32_at(subtable_data, group_offset + member_offset(TTF_CmapFormat12Group, start_char_code));
+                U32 last_codepoint    = ttf_u32_at(subtable_data, group_offset + member_offset(TTF_CmapFormat12Group, end_char_code));
+                U32 first_glyph_index = ttf_u32_at(subtable_data, group_offset + member_offset(TTF_CmapFormat12Group, start_glyph_code));
+
+                last_codepoint = u32_min(last_codepoint, TTF_MAX_CODEPOINT);
+                if (next_codepoint <= first_codepoint && first_codepoint <= last_codepoint) {
+                    for (U32 codepoint = first_codepoint; codepoint <= last_codepoint; ++codepoint) {
+                        U64 glyph_index = (U64) first_glyph_index + (codepoint - first_codepoint);
+                        count = ttf_push_codepoint(font, codepoints, glyph_indicies, count, codepoint, glyph_index);
+                    }
+
+                    next_codepoint = last_codepoint + 1;
+                }
+            }
+        } break;
     }
 
-    if (success && contour_count > 0) {
-        if ((U32) contour_count > contour_capacity) {
-            error_emit(str8_literal("ERROR(font/ttf): Glyph contains too many contours."));
-            success = false;
+    return count;
+}
+
+internal Void ttf_enumerate_codepoints(Arena *arena, TTF_Font *font) {
+    font->codepoint_count = ttf_collect_codepoints(font, 0, 0);
+    font->codepoints      = arena_push_array(arena, U32, font->codepoint_count);
+    font->glyph_indicies  = arena_push_array(arena, U32, font->codepoint_count);
+    ttf_collect_codepoints(font, font->codepoints, font->glyph_indicies);
+}
+
+// NOTE: Size in bytes of the x and y deltas of a point, indexed by bits 1, 2,
+// 4 and 5 of its flags (short x, short y, same or positive x and y). The x
+// size is in the low nibble and the y size in the high nibble. Looking the
+// sizes up avoids branching on flags, which are unpredictable.
+#define TTF_DELTA_SIZE(short_flag, same_flag) ((short_flag) ? 1 : ((same_flag) ? 0 : 2))
+#define TTF_DELTA_SIZES(i) (TTF_DELTA_SIZE((i) & 0x01, (i) & 0x04) | TTF_DELTA_SIZE((i) & 0x02, (i) & 0x08) << 4)
+global U8 ttf_coordinate_delta_sizes[16] = {
+    TTF_DELTA_SIZES(0x0), TTF_DELTA_SIZES(0x1), TTF_DELTA_SIZES(0x2), TTF_DELTA_SIZES(0x3),
+    TTF_DELTA_SIZES(0x4), TTF_DELTA_SIZES(0x5), TTF_DELTA_SIZES(0x6), TTF_DELTA_SIZES(0x7),
+    TTF_DELTA_SIZES(0x8), TTF_DELTA_SIZES(0x9), TTF_DELTA_SIZES(0xA), TTF_DELTA_SIZES(0xB),
+    TTF_DELTA_SIZES(0xC), TTF_DELTA_SIZES(0xD), TTF_DELTA_SIZES(0xE), TTF_DELTA_SIZES(0xF),
+};
+#undef TTF_DELTA_SIZES
+#undef TTF_DELTA_SIZE
+
+// NOTE: The data must already have been checked to hold all deltas.
+internal Void ttf_decode_coordinates(U8 *data, U8 *flags, U32 count, U8 short_flag, U8 same_flag, TTF_FWord *result) {
+    TTF_FWord previous = 0;
+    for (U32 i = 0; i < count; ++i) {
+        U8 flag = flags[i];
+        if (flag & short_flag) {
+            previous = (TTF_FWord) ((flag & same_flag) ? previous + data[0] : previous - data[0]);
+            data += 1;
+        } else if (!(flag & same_flag)) {
+            previous = (TTF_FWord) (previous + (S16) (data[0] << 8 | data[1]));
+            data += 2;
+        }
+        result[i] = previous;
+    }
+}
+
+// NOTE: How much a tuple variation applies at the current instance. start
+// and end are empty for tuples without an intermediate region, in which case
+// the region spans from 0 to the peak.
+internal F32 ttf_tuple_scalar(TTF_Font *font, Str8 peak, Str8 start, Str8 end) {
+    F32 scalar = 1.0f;
+
+    for (U32 axis = 0; axis < font->axis_count && scalar != 0.0f; ++axis) {
+        F32 coordinate = font->normalized_coordinates[axis];
+        F32 axis_peak  = ttf_f2dot14_to_f32(ttf_u16_at(peak, 2 * axis));
+
+        if (axis_peak == 0.0f || coordinate == axis_peak) {
+            continue;
         }
 
-        if (success && glyph_data.size >= read_index + contour_count * sizeof(U16)) {
-            result_glyph->contour_count = contour_count;
+        F32 axis_start = f32_min(axis_peak, 0.0f);
+        F32 axis_end   = f32_max(axis_peak, 0.0f);
+        if (start.size) {
+            axis_start = ttf_f2dot14_to_f32(ttf_u16_at(start, 2 * axis));
+            axis_end   = ttf_f2dot14_to_f32(ttf_u16_at(end,   2 * axis));
 
-            for (S32 i = 0; i < contour_count; ++i) {
-                result_glyph->contour_end_points[i] = u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]);
-                read_index += sizeof(U16);
+            // NOTE: Invalid regions don't restrict the tuple along this axis.
+            if (axis_start > axis_peak || axis_peak > axis_end || (axis_start < 0.0f && axis_end > 0.0f)) {
+                continue;
             }
+        }
 
-            result_glyph->point_count = result_glyph->contour_end_points[result_glyph->contour_count - 1] + 1;
+        if (coordinate == 0.0f || coordinate < axis_start || axis_end < coordinate) {
+            scalar = 0.0f;
+        } else if (coordinate < axis_peak) {
+            scalar *= (coordinate - axis_start) / (axis_peak - axis_start);
         } else {
-            error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph contours."));
-            success = false;
+            scalar *= (axis_end - coordinate) / (axis_end - axis_peak);
         }
+    }
 
-        if (result_glyph->point_count > point_capacity) {
-            error_emit(str8_literal("ERROR(font/ttf): Glyph contains too many points."));
-            success = false;
-        }
+    return scalar;
+}
 
-        // NOTE: Skip over instructions.
-        if (success && glyph_data.size >= read_index + sizeof(U16)) {
-            U16 instruction_length = u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]);
-            read_index += sizeof(U16);
+// NOTE: Reads packed point numbers, result needs room for point_count of
+// them. A count of 0 means that every point is referenced.
+internal B32 ttf_read_packed_point_numbers(TTF_Reader *reader, U32 point_count, U16 *result, U32 *result_count) {
+    B32 success = true;
+
+    U32 count = ttf_read_u8(reader);
+    if (count & TTF_POINTS_ARE_WORDS) {
+        count = (count & TTF_POINT_RUN_COUNT_MASK) << 8 | ttf_read_u8(reader);
+    }
+
+    if (count > point_count) {
+        error_emit(str8_literal("ERROR(font/ttf): Glyph variation references too many points."));
+        success = false;
+    }
 
-            if (glyph_data.size >= read_index + instruction_length * sizeof(U8)) {
-                read_index += instruction_length * sizeof(U8);
+    U32 point_number = 0;
+    for (U32 i = 0; success && i < count && !reader->error;) {
+        U8  control   = ttf_read_u8(reader);
+        U32 run_count = (U32) (control & TTF_POINT_RUN_COUNT_MASK) + 1;
+
+        for (U32 j = 0; success && j < run_count && i < count; ++j, ++i) {
+            point_number += (control & TTF_POINTS_ARE_WORDS ? ttf_read_u16(reader) : ttf_read_u8(reader));
+
+            if (point_number < point_count) {
+                result[i] = (U16) point_number;
             } else {
-                error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph instructions."));
+                error_emit(str8_literal("ERROR(font/ttf): Glyph variation point number is out of range."));
                 success = false;
             }
-        } else {
-            error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph instructions."));
-            success = false;
         }
+    }
 
-        // NOTE: Any valid ttf-file will have at least one x-coordinate after
-        // the tags, guaranteeing that we have at least two bytes.
-        for (U32 point_index = 0; success && point_index < result_glyph->point_count;) {
-            if (glyph_data.size >= read_index + 2 * sizeof(U8)) {
-                U8 flag = glyph_data.data[read_index++];
-                U32 repeat_count = 1;
+    *result_count = count;
+    return success;
+}
 
-                if (flag & TTF_SIMPLE_GLYPH_FLAGS_REPEAT) {
-                    repeat_count += glyph_data.data[read_index++];
-                }
+internal Void ttf_read_packed_deltas(TTF_Reader *reader, U32 count, F32 *result) {
+    for (U32 i = 0; i < count && !reader->error;) {
+        U8  control   = ttf_read_u8(reader);
+        U32 run_count = (U32) (control & TTF_DELTA_RUN_COUNT_MASK) + 1;
 
-                if (result_glyph->point_count >= point_index + repeat_count) {
-                    for (U32 i = 0; i < repeat_count; ++i) {
-                        result_glyph->flags[point_index++] = flag;
-                    }
-                } else {
-                    error_emit(str8_literal("ERROR(font/ttf): Too many glyph point flags."));
-                    success = false;
-                }
+        for (U32 j = 0; j < run_count && i < count; ++j, ++i) {
+            if (control & TTF_DELTAS_ARE_ZERO) {
+                result[i] = 0.0f;
+            } else if (control & TTF_DELTAS_ARE_WORDS) {
+                result[i] = ttf_read_s16(reader);
             } else {
-                error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph point flags."));
-                success = false;
+                result[i] = ttf_read_s8(reader);
             }
         }
+    }
+}
 
-        if (success) {
-            TTF_FWord previous = 0;
-            for (U32 point_index = 0; success && point_index < result_glyph->point_count; ++point_index) {
-                U8 flag = result_glyph->flags[point_index];
-                if (flag & TTF_SIMPLE_GLYPH_FLAGS_SHORT_X) {
-                    if (glyph_data.size >= read_index + sizeof(U8)) {
-                        if (flag & TTF_SIMPLE_GLYPH_FLAGS_SAME_OR_POSITIVE_X) {
-                            previous += glyph_data.data[read_index++];
-                        } else {
-                            previous -= glyph_data.data[read_index++];
-                        }
-                    } else {
-                        error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph point x-coordinates."));
-                        success = false;
-                    }
-                } else {
-                    if (flag & TTF_SIMPLE_GLYPH_FLAGS_SAME_OR_POSITIVE_X) {
-                        // Nothing to do.
-                    } else {
-                        if (glyph_data.size >= read_index + sizeof(TTF_FWord)) {
-                            previous += s16_big_to_local_endian(*(TTF_FWord *) &glyph_data.data[read_index]);
-                            read_index += sizeof(TTF_FWord);
-                        } else {
-                            error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph point x-coordinates."));
-                            success = false;
-                        }
-                    }
+// NOTE: Interpolates the delta of a point that a tuple doesn't reference from
+// the referenced points before and after it on the same contour. Points
+// outside of the span between them move with the closer one.
+internal F32 ttf_infer_delta(F32 position, F32 position_a, F32 delta_a, F32 position_b, F32 delta_b) {
+    F32 result = 0.0f;
+
+    if (position_a == position_b) {
+        result = (delta_a == delta_b ? delta_a : 0.0f);
+    } else {
+        if (position_a > position_b) {
+            F32 temporary = position_a;
+            position_a = position_b;
+            position_b = temporary;
+
+            temporary = delta_a;
+            delta_a   = delta_b;
+            delta_b   = temporary;
+        }
+
+        if (position <= position_a) {
+            result = delta_a;
+        } else if (position >= position_b) {
+            result = delta_b;
+        } else {
+            result = delta_a + (position - position_a) / (position_b - position_a) * (delta_b - delta_a);
+        }
+    }
+
+    return result;
+}
+
+internal Void ttf_infer_contour_deltas(TTF_Glyph *glyph, B8 *is_referenced, F32 *deltas_x, F32 *deltas_y, U32 first_point, U32 last_point) {
+    U32 count = last_point - first_point + 1;
+
+    U32 first_referenced = first_point;
+    while (first_referenced <= last_point && !is_referenced[first_referenced]) {
+        ++first_referenced;
+    }
+
+    // NOTE: Contours without any referenced points don't move.
+    if (first_referenced > last_point) {
+        return;
+    }
+
+    U32 previous = first_referenced;
+    for (U32 step = 1; step <= count; ++step) {
+        U32 current = first_point + (first_referenced - first_point + step) % count;
+        if (!is_referenced[current]) {
+            continue;
+        }
+
+        for (U32 i = first_point + (previous - first_point + 1) % count; i != current; i = first_point + (i - first_point + 1) % count) {
+            deltas_x[i] = ttf_infer_delta(glyph->x_coordinates[i], glyph->x_coordinates[previous], deltas_x[previous], glyph->x_coordinates[current], deltas_x[current]);
+            deltas_y[i] = ttf_infer_delta(glyph->y_coordinates[i], glyph->y_coordinates[previous], deltas_y[previous], glyph->y_coordinates[current], deltas_y[current]);
+        }
+
+        previous = current;
+    }
+}
+
+// NOTE: Moves the points of a decoded glyph to the current instance. The
+// deltas of all tuples are summed up against the default outline before any
+// point is moved, as inferred deltas depend on the original positions. For
+// compound glyphs, each point is the offset of a component, whose own
+// outlines have already been varied when they were decoded.
+internal B32 ttf_apply_glyph_variations(TTF_Font *font, U32 glyph_index, TTF_Glyph *glyph) {
+    B32 success = true;
+
+    Str8 data = font->raw_glyph_variation_data[glyph_index];
+    if (data.size == 0) {
+        return success;
+    }
+
+    Arena_Temporary scratch = arena_get_scratch(0, 0);
+
+    B32 is_compound         = (glyph->component_count != 0);
+    U32 outline_point_count = (is_compound ? glyph->component_count : glyph->point_count);
+    U32 point_count         = outline_point_count + TTF_PHANTOM_POINT_COUNT;
+
+    F32 *total_x         = arena_push_array_zero(scratch.arena, F32, outline_point_count);
+    F32 *total_y         = arena_push_array_zero(scratch.arena, F32, outline_point_count);
+    F32 *packed_x        = arena_push_array(scratch.arena, F32, point_count);
+    F32 *packed_y        = arena_push_array(scratch.arena, F32, point_count);
+    F32 *deltas_x        = arena_push_array(scratch.arena, F32, point_count);
+    F32 *deltas_y        = arena_push_array(scratch.arena, F32, point_count);
+    B8  *is_referenced   = arena_push_array(scratch.arena, B8,  point_count);
+    U16 *shared_points   = arena_push_array(scratch.arena, U16, point_count);
+    U16 *private_points  = arena_push_array(scratch.arena, U16, point_count);
+    U32  shared_count    = 0;
+    U32  tuple_data_size = font->axis_count * sizeof(TTF_F2Dot14);
+
+    TTF_Reader reader = ttf_reader_from_str8(data);
+    U16 tuple_count_and_flags = ttf_read_u16(&reader);
+    U16 data_offset           = ttf_read_u16(&reader);
+    U32 tuple_count           = tuple_count_and_flags & TTF_GLYPH_VARIATION_COUNT_MASK;
+
+    // NOTE: Serialized data starts with the shared point numbers, followed
+    // by the data of each tuple in order.
+    TTF_Reader data_reader = ttf_reader_from_str8(data);
+    ttf_reader_seek(&data_reader, data_offset);
+    if (tuple_count_and_flags & TTF_GLYPH_VARIATION_SHARED_POINT_NUMBERS) {
+        success = ttf_read_packed_point_numbers(&data_reader, point_count, shared_points, &shared_count);
+    }
+    U64 tuple_offset = data_reader.offset;
+
+    for (U32 tuple = 0; success && tuple < tuple_count && !reader.error; ++tuple) {
+        U16 variation_data_size = ttf_read_u16(&reader);
+        U16 tuple_index         = ttf_read_u16(&reader);
+        U32 shared_tuple_index  = tuple_index & TTF_TUPLE_INDEX_MASK;
+
+        Str8 peak  = { 0 };
+        Str8 start = { 0 };
+        Str8 end   = { 0 };
+        if (tuple_index & TTF_TUPLE_EMBEDDED_PEAK_TUPLE) {
+            peak = ttf_read_bytes(&reader, tuple_data_size);
+        } else if (shared_tuple_index < font->shared_tuple_count) {
+            peak = str8_substring(font->shared_tuples, shared_tuple_index * tuple_data_size, tuple_data_size);
+        } else {
+            error_emit(str8_literal("ERROR(font/ttf): Glyph variation shared tuple index is out of range."));
+            success = false;
+        }
+
+        if (tuple_index & TTF_TUPLE_INTERMEDIATE_REGION) {
+            start = ttf_read_bytes(&reader, tuple_data_size);
+            end   = ttf_read_bytes(&reader, tuple_data_size);
+        }
+
+        if (!success || reader.error) {
+            break;
+        }
+
+        if (tuple_offset + variation_data_size > data.size) {
+            error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph variation."));
+            success = false;
+            break;
+        }
+
+        TTF_Reader tuple_reader = ttf_reader_from_str8(str8_substring(data, tuple_offset, variation_data_size));
+        tuple_offset += variation_data_size;
+
+        F32 scalar = 0.0f;
+        if (!(tuple_index & (TTF_TUPLE_EMBEDDED_PEAK_TUPLE | TTF_TUPLE_INTERMEDIATE_REGION))) {
+            scalar = font->shared_tuple_scalars[shared_tuple_index];
+        } else {
+            scalar = ttf_tuple_scalar(font, peak, start, end);
+        }
+
+        if (scalar == 0.0f) {
+            continue;
+        }
+
+        U16 *points              = shared_points;
+        U32  referenced_count    = shared_count;
+        if (tuple_index & TTF_TUPLE_PRIVATE_POINT_NUMBERS) {
+            points  = private_points;
+            success = ttf_read_packed_point_numbers(&tuple_reader, point_count, private_points, &referenced_count);
+        }
+
+        U32 delta_count = (referenced_count == 0 ? point_count : referenced_count);
+        ttf_read_packed_deltas(&tuple_reader, delta_count, packed_x);
+        ttf_read_packed_deltas(&tuple_reader, delta_count, packed_y);
+
+        if (tuple_reader.error) {
+            error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph variation deltas."));
+            success = false;
+        }
+
+        if (!success) {
+            break;
+        }
+
+        if (referenced_count == 0) {
+            for (U32 i = 0; i < outline_point_count; ++i) {
+                total_x[i] += scalar * packed_x[i];
+                total_y[i] += scalar * packed_y[i];
+            }
+        } else if (is_compound) {
+            // NOTE: Component offsets that aren't referenced don't move.
+            for (U32 i = 0; i < referenced_count; ++i) {
+                U32 point = points[i];
+                if (point < outline_point_count) {
+                    total_x[point] += scalar * packed_x[i];
+                    total_y[point] += scalar * packed_y[i];
                 }
-                result_glyph->x_coordinates[point_index] = previous;
+            }
+        } else {
+            memory_zero(deltas_x,      point_count * sizeof(F32));
+            memory_zero(deltas_y,      point_count * sizeof(F32));
+            memory_zero(is_referenced, point_count * sizeof(B8));
+
+            for (U32 i = 0; i < referenced_count; ++i) {
+                U32 point = points[i];
+                deltas_x[point]      = packed_x[i];
+                deltas_y[point]      = packed_y[i];
+                is_referenced[point] = true;
+            }
+
+            for (U32 contour = 0, first_point = 0; contour < glyph->contour_count; ++contour) {
+                U32 last_point = glyph->contour_end_points[contour];
+                ttf_infer_contour_deltas(glyph, is_referenced, deltas_x, deltas_y, first_point, last_point);
+                first_point = last_point + 1;
+            }
+
+            for (U32 i = 0; i < outline_point_count; ++i) {
+                total_x[i] += scalar * deltas_x[i];
+                total_y[i] += scalar * deltas_y[i];
+            }
+        }
+    }
+
+    if (success && reader.error) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph variation headers."));
+        success = false;
+    }
+
+    if (success && is_compound) {
+        for (U32 i = 0; i < glyph->component_count; ++i) {
+            TTF_GlyphComponent *component = &glyph->components[i];
+            if (component->is_anchored || component->contour_count == 0) {
+                continue;
+            }
+
+            TTF_FWord offset_x = (TTF_FWord) f32_round(total_x[i]);
+            TTF_FWord offset_y = (TTF_FWord) f32_round(total_y[i]);
+
+            U32 first_point = (component->first_contour ? glyph->contour_end_points[component->first_contour - 1] + 1 : 0);
+            U32 last_point  = glyph->contour_end_points[component->first_contour + component->contour_count - 1];
+            for (U32 point = first_point; point <= last_point; ++point) {
+                glyph->x_coordinates[point] += offset_x;
+                glyph->y_coordinates[point] += offset_y;
+            }
+
+            component->offset_x += offset_x;
+            component->offset_y += offset_y;
+        }
+    } else if (success) {
+        for (U32 i = 0; i < glyph->point_count; ++i) {
+            glyph->x_coordinates[i] = (TTF_FWord) f32_round(glyph->x_coordinates[i] + total_x[i]);
+            glyph->y_coordinates[i] = (TTF_FWord) f32_round(glyph->y_coordinates[i] + total_y[i]);
+        }
+    }
+
+    // NOTE: The bounds stored in the glyph are for the default instance.
+    if (success && glyph->point_count) {
+        glyph->x_min = glyph->x_max = glyph->x_coordinates[0];
+        glyph->y_min = glyph->y_max = glyph->y_coordinates[0];
+        for (U32 i = 1; i < glyph->point_count; ++i) {
+            glyph->x_min = s16_min(glyph->x_min, glyph->x_coordinates[i]);
+            glyph->y_min = s16_min(glyph->y_min, glyph->y_coordinates[i]);
+            glyph->x_max = s16_max(glyph->x_max, glyph->x_coordinates[i]);
+            glyph->y_max = s16_max(glyph->y_max, glyph->y_coordinates[i]);
+        }
+    }
+
+    arena_end_temporary(scratch);
+    return success;
+}
+
+internal TTF_Glyph *ttf_get_glyph_at_depth(Arena *arena, TTF_Font *font, U32 glyph_index, U32 depth);
+
+// NOTE: The arrays of the result must have room for as many contours, points
+// and components as the font allows. Components that can't be cached are
+// decoded into arena.
+internal B32 ttf_decode_glyph(Arena *arena, TTF_Font *font, U32 glyph_index, U32 depth, TTF_Glyph *result_glyph) {
+    B32 success = true;
+
+    U32 contour_capacity = font->contour_capacity;
+    U32 point_capacity   = font->point_capacity;
+
+    TTF_Reader reader = ttf_reader_from_str8(font->raw_glyph_data[glyph_index]);
+
+    // NOTE: Glyphs without any data, such as spaces, have no outlines.
+    if (reader.size == 0) {
+        return success;
+    }
+
+    S16 contour_count   = ttf_read_s16(&reader);
+    result_glyph->x_min = ttf_read_s16(&reader);
+    result_glyph->y_min = ttf_read_s16(&reader);
+    result_glyph->x_max = ttf_read_s16(&reader);
+    result_glyph->y_max = ttf_read_s16(&reader);
+
+    if (reader.error) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph outlines."));
+        success = false;
+    }
+
+    if (success && contour_count > 0) {
+        if ((U32) contour_count > contour_capacity) {
+            error_emit(str8_literal("ERROR(font/ttf): Glyph contains too many contours."));
+            success = false;
+        }
+
+        if (success) {
+            ttf_read_u16_array(&reader, result_glyph->contour_end_points, (U32) contour_count);
+
+            if (!reader.error) {
+                result_glyph->contour_count = (U32) contour_count;
+                result_glyph->point_count   = result_glyph->contour_end_points[result_glyph->contour_count - 1] + 1;
+            } else {
+                error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph contours."));
+                success = false;
             }
         }
 
+        for (U32 i = 1; success && i < result_glyph->contour_count; ++i) {
+            if (result_glyph->contour_end_points[i] <= result_glyph->contour_end_points[i - 1]) {
+                error_emit(str8_literal("ERROR(font/ttf): Glyph contour end points are not increasing."));
+                success = false;
+            }
+        }
+
+        if (success && result_glyph->point_count > point_capacity) {
+            error_emit(str8_literal("ERROR(font/ttf): Glyph contains too many points."));
+            success = false;
+        }
+
+        // NOTE: Skip over instructions.
         if (success) {
-            TTF_FWord previous = 0;
-            for (U32 point_index = 0; success && point_index < result_glyph->point_count; ++point_index) {
-                U8 flag = result_glyph->flags[point_index];
-                if (flag & TTF_SIMPLE_GLYPH_FLAGS_SHORT_Y) {
-                    if (glyph_data.size >= read_index + sizeof(U8)) {
-                        if (flag & TTF_SIMPLE_GLYPH_FLAGS_SAME_OR_POSITIVE_Y) {
-                            previous += glyph_data.data[read_index++];
-                        } else {
-                            previous -= glyph_data.data[read_index++];
-                        }
-                    } else {
-                        error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph point y-coordinates."));
-                        success = false;
-                    }
+            U16 instruction_length = ttf_read_u16(&reader);
+            ttf_reader_skip(&reader, instruction_length * sizeof(U8));
+
+            if (reader.error) {
+                error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph instructions."));
+                success = false;
+            }
+        }
+
+        // NOTE: The flags determine the size of every delta, so the data for
+        // all of them is summed up while expanding the flags and bounds
+        // checked once. The deltas are then decoded without any checks and
+        // summed into coordinates.
+        U32 x_size = 0;
+        U32 y_size = 0;
+        for (U32 point_index = 0; success && point_index < result_glyph->point_count;) {
+            U8 flag = ttf_read_u8(&reader);
+            U32 repeat_count = 1;
+
+            if (flag & TTF_SIMPLE_GLYPH_FLAGS_REPEAT) {
+                repeat_count += ttf_read_u8(&reader);
+            }
+
+            if (reader.error) {
+                error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph point flags."));
+                success = false;
+            } else if (result_glyph->point_count >= point_index + repeat_count) {
+                if (repeat_count == 1) {
+                    result_glyph->flags[point_index] = flag;
                 } else {
-                    if (flag & TTF_SIMPLE_GLYPH_FLAGS_SAME_OR_POSITIVE_Y) {
-                        // Nothing to do.
-                    } else {
-                        if (glyph_data.size >= read_index + sizeof(TTF_FWord)) {
-                            previous += s16_big_to_local_endian(*(TTF_FWord *) &glyph_data.data[read_index]);
-                            read_index += sizeof(TTF_FWord);
-                        } else {
-                            error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph point y-coordinates."));
-                            success = false;
-                        }
-                    }
+                    memory_set(&result_glyph->flags[point_index], flag, repeat_count);
                 }
-                result_glyph->y_coordinates[point_index] = previous;
+                point_index += repeat_count;
+
+                U8 sizes = ttf_coordinate_delta_sizes[(flag >> 1 & 0x03) | (flag >> 2 & 0x0C)];
+                x_size += repeat_count * (sizes & 0x0F);
+                y_size += repeat_count * (sizes >> 4);
+            } else {
+                error_emit(str8_literal("ERROR(font/ttf): Too many glyph point flags."));
+                success = false;
+            }
+        }
+
+        if (success) {
+            Str8 x_data = ttf_read_bytes(&reader, x_size);
+            if (!reader.error) {
+                ttf_decode_coordinates(x_data.data, result_glyph->flags, result_glyph->point_count, TTF_SIMPLE_GLYPH_FLAGS_SHORT_X, TTF_SIMPLE_GLYPH_FLAGS_SAME_OR_POSITIVE_X, result_glyph->x_coordinates);
+            } else {
+                error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph point x-coordinates."));
+                success = false;
+            }
+        }
+
+        if (success) {
+            Str8 y_data = ttf_read_bytes(&reader, y_size);
+            if (!reader.error) {
+                ttf_decode_coordinates(y_data.data, result_glyph->flags, result_glyph->point_count, TTF_SIMPLE_GLYPH_FLAGS_SHORT_Y, TTF_SIMPLE_GLYPH_FLAGS_SAME_OR_POSITIVE_Y, result_glyph->y_coordinates);
+            } else {
+                error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph point y-coordinates."));
+                success = false;
             }
         }
     } else if (success && contour_count < 0) {
         B32 has_more_components = true;
         while (success && has_more_components) {
-            U16 flags = 0;
-
-            TTF_Glyph component_glyph = { 0 };
-            component_glyph.contour_end_points = &result_glyph->contour_end_points[result_glyph->contour_count];
-            component_glyph.flags              = &result_glyph->flags[result_glyph->point_count];
-            component_glyph.x_coordinates      = &result_glyph->x_coordinates[result_glyph->point_count];
-            component_glyph.y_coordinates      = &result_glyph->y_coordinates[result_glyph->point_count];
             F32 a = 1.0, b = 0.0;
             F32 c = 0.0, d = 1.0;
             F32 e = 0.0, f = 0.0;
@@ -740,125 +1178,132 @@ internal B32 ttf_get_glyph_outlines(TTF_Font *font, U32 glyph_index, U32 contour
             U16 compound_point_index  = 0;
             U16 component_point_index = 0;
 
-            if (success && glyph_data.size >= read_index + 2 * sizeof(U16)) {
-                flags = u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]);
-                read_index += sizeof(U16);
-
-                U16 component_glyph_index = u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]);
-                read_index += sizeof(U16);
+            U16 flags                 = ttf_read_u16(&reader);
+            U16 component_glyph_index = ttf_read_u16(&reader);
 
-                success = ttf_get_glyph_outlines(font, component_glyph_index, contour_count - result_glyph->contour_count, point_capacity - result_glyph->point_count, &component_glyph);
-            } else {
+            if (reader.error) {
                 error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph component flags."));
                 success = false;
+            } else if (component_glyph_index >= font->glyph_count) {
+                error_emit(str8_literal("ERROR(font/ttf): Glyph component index is out of range."));
+                success = false;
+            } else if (result_glyph->component_count >= font->component_capacity) {
+                error_emit(str8_literal("ERROR(font/ttf): Glyph contains too many components."));
+                success = false;
             }
 
+            // NOTE: Components are shared through the outline cache, so every
+            // component is only decoded once no matter how many glyphs use it.
+            TTF_Glyph *component_glyph = 0;
             if (success) {
-                if (flags & TTF_COMPOUND_GLYPH_FLAGS_ARG_1_AND_2_ARE_WORDS && glyph_data.size < read_index + 2 * sizeof(U16)) {
-                    error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph component arguments."));
-                    success = false;
-                } else if (glyph_data.size < read_index + 2 * sizeof(U8)) {
-                    error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph component arguments."));
-                    success = false;
-                }
+                component_glyph = ttf_get_glyph_at_depth(arena, font, component_glyph_index, depth + 1);
+                success = (component_glyph != 0);
+            }
+
+            if (success && (result_glyph->contour_count + component_glyph->contour_count > font->contour_capacity || result_glyph->point_count + component_glyph->point_count > font->point_capacity)) {
+                error_emit(str8_literal("ERROR(font/ttf): Glyph contains too many points."));
+                success = false;
             }
 
             if (success) {
                 if (flags & TTF_COMPOUND_GLYPH_FLAGS_ARGS_ARE_XY_VALUES) {
                     if (flags & TTF_COMPOUND_GLYPH_FLAGS_ARG_1_AND_2_ARE_WORDS) {
-                        e = s16_big_to_local_endian(*(TTF_FWord *) &glyph_data.data[read_index]);
-                        read_index += sizeof(S16);
-                        f = s16_big_to_local_endian(*(TTF_FWord *) &glyph_data.data[read_index]);
-                        read_index += sizeof(S16);
+                        e = ttf_read_s16(&reader);
+                        f = ttf_read_s16(&reader);
                     } else {
-                        e = *(S8 *) &glyph_data.data[read_index++];
-                        f = *(S8 *) &glyph_data.data[read_index++];
+                        e = ttf_read_s8(&reader);
+                        f = ttf_read_s8(&reader);
                     }
                 } else {
                     if (flags & TTF_COMPOUND_GLYPH_FLAGS_ARG_1_AND_2_ARE_WORDS) {
-                        compound_point_index = u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]);
-                        read_index += sizeof(U16);
-                        component_point_index = u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]);
-                        read_index += sizeof(U16);
+                        compound_point_index  = ttf_read_u16(&reader);
+                        component_point_index = ttf_read_u16(&reader);
                     } else {
-                        compound_point_index  = *(U8 *) &glyph_data.data[read_index++];
-                        component_point_index = *(U8 *) &glyph_data.data[read_index++];
+                        compound_point_index  = ttf_read_u8(&reader);
+                        component_point_index = ttf_read_u8(&reader);
                     }
                 }
+
+                if (reader.error) {
+                    error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph component arguments."));
+                    success = false;
+                }
             }
 
             // TODO: Verify that only one of the following flags is set.
             if (success) {
                 if (flags & TTF_COMPOUND_GLYPH_FLAGS_WE_HAVE_A_SCALE) {
-                    if (glyph_data.size >= read_index + sizeof(TTF_F2Dot14)) {
-                        a = d = ttf_f2dot14_to_f32(u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]));
-                        read_index += sizeof(TTF_F2Dot14);
-                    } else {
-                        error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph component transform."));
-                        success = false;
-                    }
+                    a = d = ttf_f2dot14_to_f32(ttf_read_u16(&reader));
                 } else if (flags & TTF_COMPOUND_GLYPH_FLAGS_WE_HAVE_AN_X_AND_Y_SCALE) {
-                    if (glyph_data.size >= read_index + 2 * sizeof(TTF_F2Dot14)) {
-                        a = ttf_f2dot14_to_f32(u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]));
-                        read_index += sizeof(TTF_F2Dot14);
-                        d = ttf_f2dot14_to_f32(u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]));
-                        read_index += sizeof(TTF_F2Dot14);
-                    } else {
-                        error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph component transform."));
-                        success = false;
-                    }
+                    a = ttf_f2dot14_to_f32(ttf_read_u16(&reader));
+                    d = ttf_f2dot14_to_f32(ttf_read_u16(&reader));
                 } else if (flags & TTF_COMPOUND_GLYPH_FLAGS_WE_HAVE_A_TWO_BY_TWO) {
-                    if (glyph_data.size >= read_index + 4 * sizeof(TTF_F2Dot14)) {
-                        a = ttf_f2dot14_to_f32(u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]));
-                        read_index += sizeof(TTF_F2Dot14);
-                        b = ttf_f2dot14_to_f32(u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]));
-                        read_index += sizeof(TTF_F2Dot14);
-                        c = ttf_f2dot14_to_f32(u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]));
-                        read_index += sizeof(TTF_F2Dot14);
-                        d = ttf_f2dot14_to_f32(u16_big_to_local_endian(*(U16 *) &glyph_data.data[read_index]));
-                        read_index += sizeof(TTF_F2Dot14);
-                    } else {
-                        error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph component transform."));
-                        success = false;
-                    }
+                    a = ttf_f2dot14_to_f32(ttf_read_u16(&reader));
+                    b = ttf_f2dot14_to_f32(ttf_read_u16(&reader));
+                    c = ttf_f2dot14_to_f32(ttf_read_u16(&reader));
+                    d = ttf_f2dot14_to_f32(ttf_read_u16(&reader));
+                }
+
+                if (reader.error) {
+                    error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph component transform."));
+                    success = false;
                 }
             }
 
-            if (success && !(flags & TTF_COMPOUND_GLYPH_FLAGS_ARGS_ARE_XY_VALUES) && !(compound_point_index < result_glyph->point_count && component_point_index < component_glyph.point_count)) {
+            if (success && !(flags & TTF_COMPOUND_GLYPH_FLAGS_ARGS_ARE_XY_VALUES) && !(compound_point_index < result_glyph->point_count && component_point_index < component_glyph->point_count)) {
                 error_emit(str8_literal("ERROR(font/ttf): Phantom points are not supported, glyph component alignemnt indicies are out of range.."));
                 success = false;
             }
 
             if (success) {
+                U32 first_point = result_glyph->point_count;
+                TTF_FWord *x_coordinates = &result_glyph->x_coordinates[first_point];
+                TTF_FWord *y_coordinates = &result_glyph->y_coordinates[first_point];
+
                 if (flags & TTF_COMPOUND_GLYPH_FLAGS_SCALED_COMPONENT_OFFSET) {
                     m = f32_sqrt(a * a + c * c);
                     n = f32_sqrt(b * b + d * d);
                 }
 
-                for (U32 i = 0; i < component_glyph.point_count; ++i) {
-                    TTF_FWord x = component_glyph.x_coordinates[i];
-                    TTF_FWord y = component_glyph.y_coordinates[i];
-                    component_glyph.x_coordinates[i] = a * x + c * y + m * e;
-                    component_glyph.y_coordinates[i] = b * x + d * y + n * f;
+                for (U32 i = 0; i < component_glyph->point_count; ++i) {
+                    TTF_FWord x = component_glyph->x_coordinates[i];
+                    TTF_FWord y = component_glyph->y_coordinates[i];
+                    x_coordinates[i] = a * x + c * y + m * e;
+                    y_coordinates[i] = b * x + d * y + n * f;
                 }
 
+                TTF_FWord offset_x = (TTF_FWord) (m * e);
+                TTF_FWord offset_y = (TTF_FWord) (n * f);
                 if (!(flags & TTF_COMPOUND_GLYPH_FLAGS_ARGS_ARE_XY_VALUES)) {
-                    U32 offset_x = result_glyph->x_coordinates[compound_point_index] - component_glyph.x_coordinates[component_point_index];
-                    U32 offset_y = result_glyph->y_coordinates[compound_point_index] - component_glyph.y_coordinates[component_point_index];
-                    for (U32 i = 0; i < component_glyph.point_count; ++i) {
-                        component_glyph.x_coordinates[i] += offset_x;
-                        component_glyph.y_coordinates[i] += offset_y;
+                    TTF_FWord align_x = result_glyph->x_coordinates[compound_point_index] - x_coordinates[component_point_index];
+                    TTF_FWord align_y = result_glyph->y_coordinates[compound_point_index] - y_coordinates[component_point_index];
+                    for (U32 i = 0; i < component_glyph->point_count; ++i) {
+                        x_coordinates[i] += align_x;
+                        y_coordinates[i] += align_y;
                     }
+                    offset_x += align_x;
+                    offset_y += align_y;
                 }
-            }
 
-            if (success) {
-                for (U32 i = 0; i < component_glyph.contour_count; ++i) {
-                    component_glyph.contour_end_points[i] += result_glyph->point_count;
+                memory_copy(&result_glyph->flags[first_point], component_glyph->flags, component_glyph->point_count * sizeof(U8));
+                for (U32 i = 0; i < component_glyph->contour_count; ++i) {
+                    result_glyph->contour_end_points[result_glyph->contour_count + i] = (U16) (component_glyph->contour_end_points[i] + first_point);
                 }
 
-                result_glyph->contour_count += component_glyph.contour_count;
-                result_glyph->point_count   += component_glyph.point_count;
+                TTF_GlyphComponent *component = &result_glyph->components[result_glyph->component_count++];
+                component->glyph_index   = component_glyph_index;
+                component->first_contour = result_glyph->contour_count;
+                component->contour_count = component_glyph->contour_count;
+                component->a             = a;
+                component->b             = b;
+                component->c             = c;
+                component->d             = d;
+                component->offset_x      = offset_x;
+                component->offset_y      = offset_y;
+                component->is_anchored   = !(flags & TTF_COMPOUND_GLYPH_FLAGS_ARGS_ARE_XY_VALUES);
+
+                result_glyph->contour_count += component_glyph->contour_count;
+                result_glyph->point_count   += component_glyph->point_count;
             }
 
             if (success) {
@@ -867,20 +1312,116 @@ internal B32 ttf_get_glyph_outlines(TTF_Font *font, U32 glyph_index, U32 contour
         }
     }
 
+    if (success && !font->is_default_instance && font->raw_glyph_variation_data) {
+        success = ttf_apply_glyph_variations(font, glyph_index, result_glyph);
+    }
+
     return success;
 }
 
+internal TTF_Glyph *ttf_copy_glyph(Arena *arena, TTF_Glyph *glyph) {
+    TTF_Glyph *result = arena_push_struct(arena, TTF_Glyph);
+    *result = *glyph;
+    result->contour_end_points = arena_push_array(arena, U16,                glyph->contour_count);
+    result->flags              = arena_push_array(arena, U8,                 glyph->point_count);
+    result->x_coordinates      = arena_push_array(arena, TTF_FWord,          glyph->point_count);
+    result->y_coordinates      = arena_push_array(arena, TTF_FWord,          glyph->point_count);
+    result->components         = arena_push_array(arena, TTF_GlyphComponent, glyph->component_count);
+    return result;
+}
+
+internal Void ttf_copy_glyph_data(TTF_Glyph *destination, TTF_Glyph *source) {
+    memory_copy(destination->contour_end_points, source->contour_end_points, source->contour_count   * sizeof(U16));
+    memory_copy(destination->flags,              source->flags,              source->point_count     * sizeof(U8));
+    memory_copy(destination->x_coordinates,      source->x_coordinates,      source->point_count     * sizeof(TTF_FWord));
+    memory_copy(destination->y_coordinates,      source->y_coordinates,      source->point_count     * sizeof(TTF_FWord));
+    memory_copy(destination->components,         source->components,         source->component_count * sizeof(TTF_GlyphComponent));
+}
+
+internal TTF_Glyph *ttf_get_glyph_at_depth(Arena *arena, TTF_Font *font, U32 glyph_index, U32 depth) {
+    if (depth > TTF_MAX_COMPONENT_DEPTH) {
+        error_emit(str8_literal("ERROR(font/ttf): Glyph components are nested too deeply."));
+        return 0;
+    }
+
+    // NOTE: Hold the cache entry while decoding so that a glyph is only
+    // decoded once. Only the outermost glyph may wait on other threads.
+    // Components never wait, as the thread holding them might be waiting on
+    // us, which can happen in fonts where components reference each other.
+    // A component that is in flight is decoded again instead.
+    Void *cached = 0;
+    Cache_Ticket ticket = { 0 };
+    B32 found = false;
+    if (depth == 0) {
+        found = cache_acquire(font->outline_cache, glyph_index, &cached, &ticket);
+    } else {
+        found = cache_try_acquire(font->outline_cache, glyph_index, &cached, &ticket);
+    }
+
+    if (found) {
+        return (TTF_Glyph *) cached;
+    }
+
+    TTF_Glyph *result = 0;
+    Arena_Temporary scratch = arena_get_scratch(&arena, 1);
+
+    TTF_Glyph glyph = { 0 };
+    glyph.contour_end_points = arena_push_array(scratch.arena, U16,                font->contour_capacity);
+    glyph.flags              = arena_push_array(scratch.arena, U8,                 font->point_capacity);
+    glyph.x_coordinates      = arena_push_array(scratch.arena, TTF_FWord,          font->point_capacity);
+    glyph.y_coordinates      = arena_push_array(scratch.arena, TTF_FWord,          font->point_capacity);
+    glyph.components         = arena_push_array(scratch.arena, TTF_GlyphComponent, font->component_capacity);
+
+    B32 success = ttf_decode_glyph(scratch.arena, font, glyph_index, depth, &glyph);
+
+    if (success && ticket.slot) {
+        while (atomic_u32_compare_exchange(&font->cache_lock, 0, 1) != 0) {
+            os_thread_yield();
+        }
+
+        result = ttf_copy_glyph(font->cache_arena, &glyph);
+
+        atomic_u32_store(&font->cache_lock, 0);
+
+        ttf_copy_glyph_data(result, &glyph);
+    } else if (success) {
+        // NOTE: Not cached, copying into the cache arena would only leak
+        // memory that is never reused.
+        result = ttf_copy_glyph(arena, &glyph);
+        ttf_copy_glyph_data(result, &glyph);
+    }
+
+    cache_publish(ticket, result);
+
+    arena_end_temporary(scratch);
+    return result;
+}
+
+internal TTF_Glyph *ttf_get_glyph(Arena *arena, TTF_Font *font, U32 glyph_index) {
+    TTF_Glyph *result = 0;
+    if (glyph_index < font->glyph_count && font->outline_format == TTF_OutlineFormat_Glyf) {
+        result = ttf_get_glyph_at_depth(arena, font, glyph_index, 0);
+    }
+    return result;
+}
+
 internal MSDF_Glyph ttf_expand_contours_to_msdf(Arena *arena, TTF_Font *font, U32 glyph_index) {
+    if (font->outline_format != TTF_OutlineFormat_Glyf) {
+        MSDF_Glyph result = { 0 };
+        if (glyph_index < font->glyph_count) {
+            result = cff_expand_contours_to_msdf(arena, &font->cff, glyph_index);
+        }
+        return result;
+    }
+
     MSDF_Glyph result = { 0 };
     Arena_Temporary scratch = arena_get_scratch(&arena, 1);
 
     TTF_Glyph glyph = { 0 };
-    glyph.contour_end_points = arena_push_array(scratch.arena, U16,       font->contour_capacity);
-    glyph.flags              = arena_push_array(scratch.arena, U8,        font->point_capacity);
-    glyph.x_coordinates      = arena_push_array(scratch.arena, TTF_FWord, font->point_capacity);
-    glyph.y_coordinates      = arena_push_array(scratch.arena, TTF_FWord, font->point_capacity);
-
-    ttf_get_glyph_outlines(font, glyph_index, font->contour_capacity, font->point_capacity, &glyph);
+    TTF_Glyph *decoded_glyph = ttf_get_glyph(scratch.arena, font, glyph_index);
+    if (decoded_glyph) {
+        glyph = *decoded_glyph;
+    }
 
     result.x_min = glyph.x_min;
     result.y_min = glyph.y_min;
@@ -890,8 +1431,8 @@ internal MSDF_Glyph ttf_expand_contours_to_msdf(Arena *arena, TTF_Font *font, U3
     for (U32 contour_index = 0, point_index = 0; contour_index < glyph.contour_count; ++contour_index) {
         MSDF_Contour *contour = arena_push_struct_zero(arena, MSDF_Contour);
 
-        U32 prev_index    = glyph.contour_end_points[contour_index] - 1;
         U32 current_index = glyph.contour_end_points[contour_index];
+        U32 prev_index    = (current_index > point_index ? current_index - 1 : current_index);
 
         TTF_FWord prev_x           = glyph.x_coordinates[prev_index];
         TTF_FWord prev_y           = glyph.y_coordinates[prev_index];
@@ -947,51 +1488,345 @@ internal MSDF_Glyph ttf_expand_contours_to_msdf(Arena *arena, TTF_Font *font, U3
 internal B32 ttf_parse_loca_table(Arena *arena, TTF_Font *ttf_font) {
     B32 success = true;
 
+    Arena_Temporary scratch = arena_get_scratch(&arena, 1);
+
     ttf_font->raw_glyph_data = arena_push_array_zero(arena, Str8, ttf_font->glyph_count);
 
-    Str8 loca_data = ttf_font->tables[TTF_Table_Loca];
     Str8 glyf_data = ttf_font->tables[TTF_Table_Glyf];
+    TTF_Reader reader = ttf_reader_from_str8(ttf_font->tables[TTF_Table_Loca]);
+
+    // NOTE: Convert all offsets up front so the loop below doesn't have to
+    // byteswap every entry twice.
+    U32 offset_count = (U32) ttf_font->glyph_count + 1;
+    U32 *offsets = arena_push_array(scratch.arena, U32, offset_count);
     if (ttf_font->is_long_loca_format) {
-        if (loca_data.size >= (ttf_font->glyph_count + 1) * sizeof(U32)) {
-            U32 *offsets = (U32 *) loca_data.data;
+        ttf_read_u32_array(&reader, offsets, offset_count);
+    } else {
+        U16 *short_offsets = arena_push_array(scratch.arena, U16, offset_count);
+        ttf_read_u16_array(&reader, short_offsets, offset_count);
+
+        for (U32 i = 0; i < offset_count && !reader.error; ++i) {
+            offsets[i] = 2 * (U32) short_offsets[i];
+        }
+    }
+
+    if (reader.error) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data for loca table."));
+        success = false;
+    }
 
-            for (U32 i = 0; i < ttf_font->glyph_count; ++i) {
-                U32 start = u32_big_to_local_endian(offsets[i + 0]);
-                U32 end   = u32_big_to_local_endian(offsets[i + 1]);
+    for (U32 i = 0; success && i < ttf_font->glyph_count; ++i) {
+        U32 start = offsets[i + 0];
+        U32 end   = offsets[i + 1];
 
-                if (start <= end && end <= glyf_data.size) {
-                    ttf_font->raw_glyph_data[i] = str8_substring(glyf_data, start, end - start);
-                } else {
-                    error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyf table."));
+        if (start <= end && end <= glyf_data.size) {
+            ttf_font->raw_glyph_data[i] = str8_substring(glyf_data, start, end - start);
+        } else {
+            error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyf table."));
+            success = false;
+        }
+    }
+
+    arena_end_temporary(scratch);
+    return success;
+}
+
+internal F32 ttf_fixed_to_f32(TTF_Fixed x) {
+    return (F32) (S32) x / 65536.0f;
+}
+
+internal B32 ttf_parse_fvar_table(Arena *arena, TTF_Font *font) {
+    B32 success = true;
+
+    font->is_default_instance = true;
+
+    // NOTE: Fonts without fvar have no variations.
+    if (!font->tables[TTF_Table_Fvar].data) {
+        return success;
+    }
+
+    TTF_Reader reader = ttf_reader_from_str8(font->tables[TTF_Table_Fvar]);
+
+    U16 major_version = ttf_read_u16(&reader);
+    ttf_reader_skip(&reader, sizeof(U16)); // NOTE: minor_version
+    U16 axes_offset   = ttf_read_u16(&reader);
+    ttf_reader_skip(&reader, sizeof(U16)); // NOTE: reserved
+    U16 axis_count    = ttf_read_u16(&reader);
+    U16 axis_size     = ttf_read_u16(&reader);
+
+    if (reader.error) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data in fvar table."));
+        success = false;
+    }
+
+    if (success && major_version != 1) {
+        error_emit(str8_literal("ERROR(font/ttf): Unsupported version of fvar table."));
+        success = false;
+    }
+
+    if (success && axis_size < 20) {
+        error_emit(str8_literal("ERROR(font/ttf): Variation axis records are too small."));
+        success = false;
+    }
+
+    if (success) {
+        font->axes                   = arena_push_array_zero(arena, TTF_VariationAxis, axis_count);
+        font->normalized_coordinates = arena_push_array_zero(arena, F32, axis_count);
+        font->axis_count             = axis_count;
+
+        for (U32 i = 0; success && i < axis_count; ++i) {
+            ttf_reader_seek(&reader, (U64) axes_offset + (U64) i * axis_size);
+
+            TTF_VariationAxis *axis = &font->axes[i];
+            axis->tag           = ttf_read_u32(&reader);
+            axis->min_value     = ttf_fixed_to_f32(ttf_read_u32(&reader));
+            axis->default_value = ttf_fixed_to_f32(ttf_read_u32(&reader));
+            axis->max_value     = ttf_fixed_to_f32(ttf_read_u32(&reader));
+
+            if (reader.error) {
+                error_emit(str8_literal("ERROR(font/ttf): Not enough data for variation axes."));
+                success = false;
+            } else if (!(axis->min_value <= axis->default_value && axis->default_value <= axis->max_value)) {
+                error_emit(str8_literal("ERROR(font/ttf): Variation axis default is outside of its range."));
+                success = false;
+            }
+        }
+    }
+
+    return success;
+}
+
+internal B32 ttf_parse_avar_table(Arena *arena, TTF_Font *font) {
+    B32 success = true;
+
+    if (!font->tables[TTF_Table_Avar].data || font->axis_count == 0) {
+        return success;
+    }
+
+    TTF_Reader reader = ttf_reader_from_str8(font->tables[TTF_Table_Avar]);
+
+    U16 major_version = ttf_read_u16(&reader);
+    ttf_reader_skip(&reader, 2 * sizeof(U16)); // NOTE: minor_version, reserved
+    U16 axis_count    = ttf_read_u16(&reader);
+
+    if (reader.error) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data in avar table."));
+        success = false;
+    }
+
+    // NOTE: Version 2 appends more data after the segment maps, which we
+    // ignore.
+    if (success && !(major_version == 1 || major_version == 2)) {
+        error_emit(str8_literal("ERROR(font/ttf): Unsupported version of avar table."));
+        success = false;
+    }
+
+    if (success && axis_count != font->axis_count) {
+        error_emit(str8_literal("ERROR(font/ttf): Axis count of avar table doesn't match fvar table."));
+        success = false;
+    }
+
+    if (success) {
+        font->axis_segment_maps = arena_push_array_zero(arena, TTF_AxisSegmentMap, axis_count);
+
+        for (U32 i = 0; success && i < axis_count; ++i) {
+            TTF_AxisSegmentMap *map = &font->axis_segment_maps[i];
+            map->count = ttf_read_u16(&reader);
+            map->from  = arena_push_array(arena, F32, map->count);
+            map->to    = arena_push_array(arena, F32, map->count);
+
+            for (U32 j = 0; j < map->count; ++j) {
+                map->from[j] = ttf_f2dot14_to_f32(ttf_read_u16(&reader));
+                map->to[j]   = ttf_f2dot14_to_f32(ttf_read_u16(&reader));
+
+                if (j > 0 && map->from[j] < map->from[j - 1]) {
                     success = false;
                 }
             }
+
+            if (reader.error) {
+                error_emit(str8_literal("ERROR(font/ttf): Not enough data for axis segment maps."));
+                success = false;
+            } else if (!success) {
+                error_emit(str8_literal("ERROR(font/ttf): Axis segment map is not increasing."));
+            }
+        }
+    }
+
+    return success;
+}
+
+internal B32 ttf_parse_gvar_table(Arena *arena, TTF_Font *font) {
+    B32 success = true;
+
+    Str8 gvar_data = font->tables[TTF_Table_Gvar];
+    if (!gvar_data.data) {
+        return success;
+    }
+
+    TTF_Reader reader = ttf_reader_from_str8(gvar_data);
+
+    U16 major_version         = ttf_read_u16(&reader);
+    ttf_reader_skip(&reader, sizeof(U16)); // NOTE: minor_version
+    U16 axis_count            = ttf_read_u16(&reader);
+    U16 shared_tuple_count    = ttf_read_u16(&reader);
+    U32 shared_tuples_offset  = ttf_read_u32(&reader);
+    U16 glyph_count           = ttf_read_u16(&reader);
+    U16 flags                 = ttf_read_u16(&reader);
+    U32 variation_data_offset = ttf_read_u32(&reader);
+
+    if (reader.error) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data in gvar table."));
+        success = false;
+    }
+
+    if (success && major_version != 1) {
+        error_emit(str8_literal("ERROR(font/ttf): Unsupported version of gvar table."));
+        success = false;
+    }
+
+    if (success && axis_count != font->axis_count) {
+        error_emit(str8_literal("ERROR(font/ttf): Axis count of gvar table doesn't match fvar table."));
+        success = false;
+    }
+
+    if (success && glyph_count != font->glyph_count) {
+        error_emit(str8_literal("ERROR(font/ttf): Glyph count of gvar table doesn't match maxp table."));
+        success = false;
+    }
+
+    U64 shared_tuples_size = (U64) shared_tuple_count * axis_count * sizeof(TTF_F2Dot14);
+    if (success && (U64) shared_tuples_offset + shared_tuples_size > gvar_data.size) {
+        error_emit(str8_literal("ERROR(font/ttf): Not enough data for shared tuples."));
+        success = false;
+    }
+
+    if (success) {
+        Arena_Temporary scratch = arena_get_scratch(&arena, 1);
+
+        U32 offset_count = (U32) glyph_count + 1;
+        U32 *offsets = arena_push_array(scratch.arena, U32, offset_count);
+        if (flags & TTF_GVAR_LONG_OFFSETS) {
+            ttf_read_u32_array(&reader, offsets, offset_count);
         } else {
-            error_emit(str8_literal("ERROR(font/ttf): Not enough data for long loca table."));
+            U16 *short_offsets = arena_push_array(scratch.arena, U16, offset_count);
+            ttf_read_u16_array(&reader, short_offsets, offset_count);
+
+            for (U32 i = 0; i < offset_count && !reader.error; ++i) {
+                offsets[i] = 2 * (U32) short_offsets[i];
+            }
+        }
+
+        if (reader.error) {
+            error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph variation offsets."));
             success = false;
         }
 
-    } else {
-        if (loca_data.size >= (ttf_font->glyph_count + 1) * sizeof(U16)) {
-            U16 *offsets = (U16 *) loca_data.data;
+        font->raw_glyph_variation_data = arena_push_array_zero(arena, Str8, glyph_count);
+        for (U32 i = 0; success && i < glyph_count; ++i) {
+            U64 start = (U64) variation_data_offset + offsets[i + 0];
+            U64 end   = (U64) variation_data_offset + offsets[i + 1];
+
+            if (start <= end && end <= gvar_data.size) {
+                font->raw_glyph_variation_data[i] = str8_substring(gvar_data, start, end - start);
+            } else {
+                error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyph variations."));
+                success = false;
+            }
+        }
 
-            for (U32 i = 0; i < ttf_font->glyph_count; ++i) {
-                U32 start = 2 * (U32) u16_big_to_local_endian(offsets[i + 0]);
-                U32 end   = 2 * (U32) u16_big_to_local_endian(offsets[i + 1]);
+        arena_end_temporary(scratch);
+    }
 
-                if (start <= end && end <= glyf_data.size) {
-                    ttf_font->raw_glyph_data[i] = str8_substring(glyf_data, start, end - start);
+    if (success) {
+        font->shared_tuples        = str8_substring(gvar_data, shared_tuples_offset, shared_tuples_size);
+        font->shared_tuple_count   = shared_tuple_count;
+        font->shared_tuple_scalars = arena_push_array_zero(arena, F32, shared_tuple_count);
+    }
+
+    return success;
+}
+
+internal B32 ttf_set_variation(Arena *arena, TTF_Font *font, TTF_VariationCoordinate *coordinates, U32 coordinate_count) {
+    B32 success = true;
+
+    Arena_Temporary scratch = arena_get_scratch(&arena, 1);
+
+    F32 *values = arena_push_array(scratch.arena, F32, font->axis_count);
+    for (U32 i = 0; i < font->axis_count; ++i) {
+        values[i] = font->axes[i].default_value;
+    }
+
+    for (U32 i = 0; success && i < coordinate_count; ++i) {
+        B32 found = false;
+        for (U32 j = 0; j < font->axis_count; ++j) {
+            if (font->axes[j].tag == coordinates[i].tag) {
+                values[j] = coordinates[i].value;
+                found     = true;
+            }
+        }
+
+        if (!found) {
+            error_emit(str8_literal("ERROR(font/ttf): The font has no such variation axis."));
+            success = false;
+        }
+    }
+
+    if (success) {
+        font->is_default_instance = true;
+
+        for (U32 i = 0; i < font->axis_count; ++i) {
+            TTF_VariationAxis *axis = &font->axes[i];
+            F32 value      = f32_min(f32_max(axis->min_value, values[i]), axis->max_value);
+            F32 normalized = 0.0f;
+            if (value < axis->default_value) {
+                normalized = (value - axis->default_value) / (axis->default_value - axis->min_value);
+            } else if (value > axis->default_value) {
+                normalized = (value - axis->default_value) / (axis->max_value - axis->default_value);
+            }
+
+            if (font->axis_segment_maps && font->axis_segment_maps[i].count) {
+                TTF_AxisSegmentMap *map = &font->axis_segment_maps[i];
+
+                F32 mapped = map->to[map->count - 1];
+                if (normalized <= map->from[0]) {
+                    mapped = map->to[0];
                 } else {
-                    error_emit(str8_literal("ERROR(font/ttf): Not enough data for glyf table."));
-                    success = false;
+                    for (U32 j = 1; j < map->count; ++j) {
+                        if (normalized < map->from[j]) {
+                            F32 t = (normalized - map->from[j - 1]) / (map->from[j] - map->from[j - 1]);
+                            mapped = f32_lerp(map->to[j - 1], map->to[j], t);
+                            break;
+                        }
+                    }
                 }
+                normalized = mapped;
+            }
+
+            // NOTE: Coordinates are stored as F2Dot14 by the spec, round to
+            // that so we match other implementations.
+            normalized = f32_round(f32_min(f32_max(-1.0f, normalized), 1.0f) * 16384.0f) / 16384.0f;
+
+            font->normalized_coordinates[i] = normalized;
+            if (normalized != 0.0f) {
+                font->is_default_instance = false;
             }
-        } else {
-            error_emit(str8_literal("ERROR(font/ttf): Not enough data for long loca table."));
-            success = false;
         }
+
+        U32 tuple_size = font->axis_count * sizeof(TTF_F2Dot14);
+        for (U32 i = 0; i < font->shared_tuple_count; ++i) {
+            Str8 peak = str8_substring(font->shared_tuples, i * tuple_size, tuple_size);
+            font->shared_tuple_scalars[i] = ttf_tuple_scalar(font, peak, (Str8) { 0 }, (Str8) { 0 });
+        }
+
+        // NOTE: Cached outlines belong to the previous instance. They are
+        // left in the cache arena so that glyphs handed out earlier stay
+        // valid.
+        font->outline_cache  = cache_create(arena, 2 * (U32) font->glyph_count);
+        font->prepared_cache = cache_create(arena, 2 * TTF_PREPARED_CACHE_SIZE_COUNT * (U32) font->glyph_count);
     }
 
+    arena_end_temporary(scratch);
     return success;
 }
 
@@ -1002,6 +1837,9 @@ internal B32 ttf_load(Arena *arena, Str8 font_path, TTF_Font *ttf_font) {
 
     if (success) {
         success = os_file_read(arena, font_path, &font_data);
+        if (!success) {
+            error_emit(str8_literal("ERROR(font/ttf): Could not read font file."));
+        }
     }
 
     if (success) {
@@ -1017,7 +1855,20 @@ internal B32 ttf_load(Arena *arena, Str8 font_path, TTF_Font *ttf_font) {
     }
 
     if (success) {
-        success = ttf_parse_loca_table(arena, ttf_font);
+        success = ttf_parse_fvar_table(arena, ttf_font);
+    }
+
+    if (success) {
+        success = ttf_parse_avar_table(arena, ttf_font);
+    }
+
+    if (success) {
+        if (ttf_font->outline_format == TTF_OutlineFormat_Glyf) {
+            success = ttf_parse_loca_table(arena, ttf_font) && ttf_parse_gvar_table(arena, ttf_font);
+        } else {
+            B32 is_cff2 = (ttf_font->outline_format == TTF_OutlineFormat_Cff2);
+            success = cff_parse(arena, ttf_font->tables[is_cff2 ? TTF_Table_Cff2 : TTF_Table_Cff], is_cff2, ttf_font->glyph_count, &ttf_font->cff);
+        }
     }
 
     if (success) {
@@ -1028,5 +1879,13 @@ internal B32 ttf_load(Arena *arena, Str8 font_path, TTF_Font *ttf_font) {
         success = ttf_choose_character_map(ttf_font);
     }
 
+    if (success) {
+        ttf_enumerate_codepoints(arena, ttf_font);
+
+        ttf_font->cache_arena    = arena_create();
+        ttf_font->outline_cache  = cache_create(arena, 2 * (U32) ttf_font->glyph_count);
+        ttf_font->prepared_cache = cache_create(arena, 2 * TTF_PREPARED_CACHE_SIZE_COUNT * (U32) ttf_font->glyph_count);
+    }
+
     return success;
 }
@@ -3,6 +3,7 @@
 
 #define TTF_SCALER_TYPE_TRUE 0x74727565
 #define TTF_SCALER_TYPE_1    0x00010000
+#define TTF_SCALER_TYPE_OTTO 0x4F54544F
 
 #define TTF_MAGIC_NUMBER 0x5F0F3CF5
 
@@ -27,6 +28,32 @@
 #define TTF_COMPOUND_GLYPH_FLAGS_SCALED_COMPONENT_OFFSET   0x0800
 #define TTF_COMPOUND_GLYPH_FLAGS_UNSCALED_COMPONENT_OFFSET 0x1000
 
+#define TTF_GVAR_LONG_OFFSETS 0x0001
+
+#define TTF_GLYPH_VARIATION_SHARED_POINT_NUMBERS 0x8000
+#define TTF_GLYPH_VARIATION_COUNT_MASK           0x0FFF
+
+#define TTF_TUPLE_EMBEDDED_PEAK_TUPLE   0x8000
+#define TTF_TUPLE_INTERMEDIATE_REGION   0x4000
+#define TTF_TUPLE_PRIVATE_POINT_NUMBERS 0x2000
+#define TTF_TUPLE_INDEX_MASK            0x0FFF
+
+// NOTE: The prepared cache has room for every glyph at this many power of 2
+// size classes and modes. Once it is full, glyphs are prepared again on every
+// use.
+#define TTF_PREPARED_CACHE_SIZE_COUNT 4
+
+#define TTF_POINTS_ARE_WORDS     0x80
+#define TTF_POINT_RUN_COUNT_MASK 0x7F
+
+#define TTF_DELTAS_ARE_ZERO      0x80
+#define TTF_DELTAS_ARE_WORDS     0x40
+#define TTF_DELTA_RUN_COUNT_MASK 0x3F
+
+// NOTE: Glyph variations also hold deltas for four phantom points after the
+// outline points, which move the metrics of the glyph.
+#define TTF_PHANTOM_POINT_COUNT 4
+
 #define TTF_MAKE_TAG(a, b, c, d) ((U32) a << 24 | (U32) b << 16 | (U32) c << 8 | (U32) d)
 #define TTF_MAKE_VERSION(major, minor) (((major) & 0xFFFF) << 16 | ((minor) & 0xFFFF))
 
@@ -45,7 +72,14 @@ typedef U64 TTF_LongDateTime;
     X(Hmtx, 'h', 'm', 't', 'x') \
     X(Loca, 'l', 'o', 'c', 'a') \
     X(Maxp, 'm', 'a', 'x', 'p') \
-
+    X(Cff,  'C', 'F', 'F', ' ') \
+    X(Cff2, 'C', 'F', 'F', '2') \
+    X(Fvar, 'f', 'v', 'a', 'r') \
+    X(Avar, 'a', 'v', 'a', 'r') \
+    X(Gvar, 'g', 'v', 'a', 'r') \
+
+// NOTE: Tables up to and including TTF_Table_MaxRequired are required, except
+// for glyf and loca in fonts with CFF outlines.
 #define X(name, ...) TTF_Table_##name,
 typedef enum {
     TTF_TABLES(X)
@@ -138,6 +172,17 @@ typedef struct {
     // U16 glyph_index_array[variable]; // UGH...
 } TTF_CmapFormat4;
 
+// NOTE: One segment of a format 4 subtable. id_range_offset_start is the
+// offset of the segment's id_range_offset entry, which its offset is relative
+// to.
+typedef struct {
+    U16 end;
+    U16 start;
+    U16 delta;
+    U16 id_range_offset;
+    U64 id_range_offset_start;
+} TTF_CmapFormat4Segment;
+
 typedef struct {
     U16 format;
     U16 length;
@@ -233,6 +278,31 @@ typedef struct {
     U16 max_component_depth;
 } TTF_MaxpTable;
 
+// NOTE: The largest codepoint in Unicode.
+#define TTF_MAX_CODEPOINT 0x10FFFF
+
+// NOTE: Maximum nesting of compound glyphs, as allowed by maxp.
+#define TTF_MAX_COMPONENT_DEPTH 16
+
+// NOTE: One component of a compound glyph. Its contours occupy
+// [first_contour, first_contour + contour_count) of the compound glyph after
+// being transformed by x' = a * x + c * y + offset_x and
+// y' = b * x + d * y + offset_y. Anchored components are positioned by
+// matching a point of the component to a point of the compound glyph instead
+// of by an offset, and variations don't move them.
+typedef struct {
+    U32 glyph_index;
+    U32 first_contour;
+    U32 contour_count;
+    F32 a;
+    F32 b;
+    F32 c;
+    F32 d;
+    TTF_FWord offset_x;
+    TTF_FWord offset_y;
+    B32 is_anchored;
+} TTF_GlyphComponent;
+
 typedef struct {
     TTF_FWord x_min;
     TTF_FWord y_min;
@@ -240,28 +310,94 @@ typedef struct {
     TTF_FWord y_max;
     U32 contour_count;
     U32 point_count;
+    U32 component_count;
     U16       *contour_end_points;
     U8        *flags;
     TTF_FWord *x_coordinates;
     TTF_FWord *y_coordinates;
+    TTF_GlyphComponent *components;
 } TTF_Glyph;
 
+// NOTE: Axis values are in user units, such as 400 for a regular weight.
+typedef struct {
+    U32 tag;
+    F32 min_value;
+    F32 default_value;
+    F32 max_value;
+} TTF_VariationAxis;
+
+// NOTE: Piecewise linear remapping of the normalized coordinates of one axis,
+// from avar. from is increasing.
+typedef struct {
+    U32  count;
+    F32 *from;
+    F32 *to;
+} TTF_AxisSegmentMap;
+
+typedef struct {
+    U32 tag;
+    F32 value;
+} TTF_VariationCoordinate;
+
+typedef enum {
+    TTF_OutlineFormat_Glyf,
+    TTF_OutlineFormat_Cff,
+    TTF_OutlineFormat_Cff2,
+} TTF_OutlineFormat;
+
 // Used ONLY for parsing
 typedef struct {
     Str8 tables[TTF_Table_COUNT];
 
+    // NOTE: Fonts with both glyf and CFF outlines use glyf.
+    TTF_OutlineFormat outline_format;
+    CFF_Font          cff;
+
     B32 is_long_loca_format;
     Str8 *raw_glyph_data;
 
     U16 glyph_count;
+    U16 advance_width_count;
 
     U32 contour_capacity;
     U32 point_capacity;
+    U32 component_capacity;
+
+    // NOTE: Variation axes from fvar and the current instance as normalized
+    // coordinates along them, in [-1, 1] with 0 being the default.
+    TTF_VariationAxis  *axes;
+    TTF_AxisSegmentMap *axis_segment_maps; // NOTE: 0 without avar.
+    F32                *normalized_coordinates;
+    U32                 axis_count;
+    B32                 is_default_instance;
+
+    // NOTE: Variation data from gvar, keyed by glyph index. The scalar of
+    // each shared tuple only depends on the instance, so they are computed
+    // once by ttf_set_variation instead of for every glyph.
+    Str8 *raw_glyph_variation_data;
+    Str8  shared_tuples;
+    U32   shared_tuple_count;
+    F32  *shared_tuple_scalars;
+
+    // NOTE: Decoded outlines, keyed by glyph index. They are shared between
+    // threads and live as long as the font, with compound glyphs already
+    // flattened into their components.
+    Cache *outline_cache;
+
+    // NOTE: Prepared MSDF geometry, keyed by size class, mode and glyph
+    // index. See msdf_get_prepared_glyph.
+    Cache *prepared_cache;
+
+    // NOTE: Backing memory for both caches, allocations must hold cache_lock.
+    Arena *cache_arena;
+    U32    cache_lock;
 
     U16 *ttf_to_internal_glyph_indicies; // NOTE: The stored indicies are 1-based.
     U16 *internal_to_ttf_glyph_indicies;
     U16 internal_glyph_count;
 
+    // NOTE: Every codepoint the character map maps to a valid glyph, in
+    // increasing order, along with the glyph it maps to.
     U32 codepoint_count;
     U32 *codepoints;
     U32 *glyph_indicies;
@@ -275,4 +411,17 @@ typedef struct {
 
 internal B32 ttf_load(Arena *arena, Str8 font_path, TTF_Font *ttf_font);
 
+// NOTE: Selects the instance of a variable font that outlines are generated
+// for. Axes that aren't listed use their default value, and values outside
+// of an axis are clamped. Glyph and prepared caches are replaced, so this
+// must not be called while other threads use the font. Only glyf outlines
+// are varied, CFF2 fonts always use their default instance.
+internal B32 ttf_set_variation(Arena *arena, TTF_Font *font, TTF_VariationCoordinate *coordinates, U32 coordinate_count);
+
+// NOTE: Returns the decoded outlines of a glyph, decoding them on first use.
+// The result is shared and must not be modified. Returns 0 if the glyph
+// couldn't be decoded or the font doesn't have glyf outlines. When the cache
+// is full the glyph is decoded into arena instead.
+internal TTF_Glyph *ttf_get_glyph(Arena *arena, TTF_Font *font, U32 glyph_index);
+
 #endif // TTF_H
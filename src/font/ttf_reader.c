@@ -0,0 +1,183 @@
+internal TTF_Reader ttf_reader_from_str8(Str8 data) {
+    TTF_Reader result = { 0 };
+    result.data = data.data;
+    result.size = data.size;
+    return result;
+}
+
+internal Void ttf_reader_seek(TTF_Reader *reader, U64 offset) {
+    if (offset <= reader->size) {
+        reader->offset = offset;
+    } else {
+        reader->offset = reader->size;
+        reader->error  = true;
+    }
+}
+
+internal Void ttf_reader_skip(TTF_Reader *reader, U64 size) {
+    if (size <= reader->size - reader->offset) {
+        reader->offset += size;
+    } else {
+        reader->offset = reader->size;
+        reader->error  = true;
+    }
+}
+
+internal U64 ttf_reader_remaining(TTF_Reader *reader) {
+    U64 result = reader->size - reader->offset;
+    return result;
+}
+
+// NOTE(simon): Returns a pointer to the next size bytes and advances past
+// them, or null if there aren't enough left.
+internal U8 *ttf_reader_take(TTF_Reader *reader, U64 size) {
+    U8 *result = 0;
+    if (size <= reader->size - reader->offset) {
+        result = &reader->data[reader->offset];
+        reader->offset += size;
+    } else {
+        reader->offset = reader->size;
+        reader->error  = true;
+    }
+    return result;
+}
+
+internal U8 ttf_read_u8(TTF_Reader *reader) {
+    U8 result = 0;
+    if (reader->offset < reader->size) {
+        result = reader->data[reader->offset++];
+    } else {
+        reader->error = true;
+    }
+    return result;
+}
+
+internal S8 ttf_read_s8(TTF_Reader *reader) {
+    S8 result = (S8) ttf_read_u8(reader);
+    return result;
+}
+
+internal U16 ttf_read_u16(TTF_Reader *reader) {
+    U16 result = 0;
+    U8 *data = ttf_reader_take(reader, sizeof(U16));
+    if (data) {
+        result = (U16) (data[0] << 8 | data[1]);
+    }
+    return result;
+}
+
+internal S16 ttf_read_s16(TTF_Reader *reader) {
+    S16 result = (S16) ttf_read_u16(reader);
+    return result;
+}
+
+internal U32 ttf_read_u32(TTF_Reader *reader) {
+    U32 result = 0;
+    U8 *data = ttf_reader_take(reader, sizeof(U32));
+    if (data) {
+        result = (U32) data[0] << 24 | (U32) data[1] << 16 | (U32) data[2] << 8 | (U32) data[3];
+    }
+    return result;
+}
+
+internal U64 ttf_read_u64(TTF_Reader *reader) {
+    U64 high = ttf_read_u32(reader);
+    U64 low  = ttf_read_u32(reader);
+    U64 result = high << 32 | low;
+    return result;
+}
+
+internal Str8 ttf_read_bytes(TTF_Reader *reader, U64 size) {
+    Str8 result = { 0 };
+    U8 *data = ttf_reader_take(reader, size);
+    if (data) {
+        result = str8(data, size);
+    }
+    return result;
+}
+
+internal Void ttf_read_u16_array(TTF_Reader *reader, U16 *result, U64 count) {
+    if (count <= ttf_reader_remaining(reader) / sizeof(U16)) {
+        U8 *data = ttf_reader_take(reader, count * sizeof(U16));
+        ttf_u16_array_from_big_endian(result, data, count);
+    } else {
+        reader->offset = reader->size;
+        reader->error  = true;
+    }
+}
+
+internal Void ttf_read_u32_array(TTF_Reader *reader, U32 *result, U64 count) {
+    if (count <= ttf_reader_remaining(reader) / sizeof(U32)) {
+        U8 *data = ttf_reader_take(reader, count * sizeof(U32));
+        ttf_u32_array_from_big_endian(result, data, count);
+    } else {
+        reader->offset = reader->size;
+        reader->error  = true;
+    }
+}
+
+internal U16 ttf_u16_at(Str8 data, U64 offset) {
+    U16 result = 0;
+    if (offset < data.size && sizeof(U16) <= data.size - offset) {
+        result = (U16) (data.data[offset + 0] << 8 | data.data[offset + 1]);
+    }
+    return result;
+}
+
+internal U32 ttf_u32_at(Str8 data, U64 offset) {
+    U32 result = 0;
+    if (offset < data.size && sizeof(U32) <= data.size - offset) {
+        U8 *bytes = &data.data[offset];
+        result = (U32) bytes[0] << 24 | (U32) bytes[1] << 16 | (U32) bytes[2] << 8 | (U32) bytes[3];
+    }
+    return result;
+}
+
+internal Void ttf_u16_array_from_big_endian(U16 *destination, U8 *source, U64 count) {
+    U64 i = 0;
+
+#if ARCH_X64 && defined(__SSSE3__)
+    __m128i swap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    for (; i + 8 <= count; i += 8) {
+        __m128i values = _mm_loadu_si128((__m128i *) &source[i * sizeof(U16)]);
+        _mm_storeu_si128((__m128i *) &destination[i], _mm_shuffle_epi8(values, swap));
+    }
+#elif ARCH_X64
+    for (; i + 8 <= count; i += 8) {
+        __m128i values = _mm_loadu_si128((__m128i *) &source[i * sizeof(U16)]);
+        values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+        _mm_storeu_si128((__m128i *) &destination[i], values);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        destination[i] = (U16) (source[2 * i + 0] << 8 | source[2 * i + 1]);
+    }
+}
+
+internal Void ttf_u32_array_from_big_endian(U32 *destination, U8 *source, U64 count) {
+    U64 i = 0;
+
+#if ARCH_X64 && defined(__SSSE3__)
+    __m128i swap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; i + 4 <= count; i += 4) {
+        __m128i values = _mm_loadu_si128((__m128i *) &source[i * sizeof(U32)]);
+        _mm_storeu_si128((__m128i *) &destination[i], _mm_shuffle_epi8(values, swap));
+    }
+#elif ARCH_X64
+    // NOTE(simon): Swap the two halves of every value, then the bytes within
+    // each half.
+    for (; i + 4 <= count; i += 4) {
+        __m128i values = _mm_loadu_si128((__m128i *) &source[i * sizeof(U32)]);
+        values = _mm_shufflelo_epi16(values, _MM_SHUFFLE(2, 3, 0, 1));
+        values = _mm_shufflehi_epi16(values, _MM_SHUFFLE(2, 3, 0, 1));
+        values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+        _mm_storeu_si128((__m128i *) &destination[i], values);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        U8 *bytes = &source[i * sizeof(U32)];
+        destination[i] = (U32) bytes[0] << 24 | (U32) bytes[1] << 16 | (U32) bytes[2] << 8 | (U32) bytes[3];
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef TTF_READER_H
+#define TTF_READER_H
+
+// NOTE(simon): Cursor over big-endian font data that never reads outside of
+// it. Reading past the end returns 0 and sets error, which stays set for all
+// following reads. This lets parsers read a whole structure and check for
+// truncation once afterwards instead of before every field. Nothing is
+// allocated and no unaligned loads are made.
+
+#if ARCH_X64
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#endif
+
+typedef struct {
+    U8 *data;
+    U64 size;
+    U64 offset;
+    B32 error;
+} TTF_Reader;
+
+internal TTF_Reader ttf_reader_from_str8(Str8 data);
+internal Void       ttf_reader_seek(TTF_Reader *reader, U64 offset);
+internal Void       ttf_reader_skip(TTF_Reader *reader, U64 size);
+internal U64        ttf_reader_remaining(TTF_Reader *reader);
+
+internal U8   ttf_read_u8(TTF_Reader *reader);
+internal S8   ttf_read_s8(TTF_Reader *reader);
+internal U16  ttf_read_u16(TTF_Reader *reader);
+internal S16  ttf_read_s16(TTF_Reader *reader);
+internal U32  ttf_read_u32(TTF_Reader *reader);
+internal U64  ttf_read_u64(TTF_Reader *reader);
+internal Str8 ttf_read_bytes(TTF_Reader *reader, U64 size);
+
+// NOTE(simon): Read count values and convert them to local endian in bulk. On
+// error nothing is written.
+internal Void ttf_read_u16_array(TTF_Reader *reader, U16 *result, U64 count);
+internal Void ttf_read_u32_array(TTF_Reader *reader, U32 *result, U64 count);
+
+// NOTE(simon): Random access for lookups into tables that have already been
+// validated. Reads outside of the data return 0.
+internal U16 ttf_u16_at(Str8 data, U64 offset);
+internal U32 ttf_u32_at(Str8 data, U64 offset);
+
+internal Void ttf_u16_array_from_big_endian(U16 *destination, U8 *source, U64 count);
+internal Void ttf_u32_array_from_big_endian(U32 *destination, U8 *source, U64 count);
+
+#endif // TTF_READER_H
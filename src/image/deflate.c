@@ -0,0 +1,212 @@
+internal Void deflate_flush_output(Deflate_Stream *stream) {
+    if (stream->output_size) {
+        if (stream->success) {
+            stream->success = stream->output(stream->user_data, stream->output_buffer, stream->output_size);
+        }
+        stream->output_size = 0;
+    }
+}
+
+internal Void deflate_put_bits(Deflate_Stream *stream, U32 bits, U32 count) {
+    stream->bit_buffer |= (U64) bits << stream->bit_count;
+    stream->bit_count  += count;
+
+    while (stream->bit_count >= 8) {
+        if (stream->output_size == DEFLATE_OUTPUT_SIZE) {
+            deflate_flush_output(stream);
+        }
+
+        stream->output_buffer[stream->output_size++] = (U8) stream->bit_buffer;
+        stream->bit_buffer >>= 8;
+        stream->bit_count   -= 8;
+    }
+}
+
+// NOTE(simon): Huffman codes are stored starting with the most significant
+// bit, while everything else is stored starting with the least significant.
+internal Void deflate_put_code(Deflate_Stream *stream, U32 code, U32 length) {
+    deflate_put_bits(stream, u32_reverse(code) >> (32 - length), length);
+}
+
+internal Void deflate_put_literal_length_symbol(Deflate_Stream *stream, U32 symbol) {
+    if (symbol < 144) {
+        deflate_put_code(stream, 0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        deflate_put_code(stream, 0x190 + symbol - 144, 9);
+    } else if (symbol < 280) {
+        deflate_put_code(stream, symbol - 256, 7);
+    } else {
+        deflate_put_code(stream, 0xC0 + symbol - 280, 8);
+    }
+}
+
+internal Void deflate_put_match(Deflate_Stream *stream, U32 length, U32 distance) {
+    // NOTE(simon): Length codes 257-284 cover 4 lengths per extra bit count.
+    if (length == DEFLATE_MAX_MATCH) {
+        deflate_put_literal_length_symbol(stream, 285);
+    } else {
+        U32 x = length - DEFLATE_MIN_MATCH;
+        if (x < 8) {
+            deflate_put_literal_length_symbol(stream, 257 + x);
+        } else {
+            U32 high_bit   = 31 - u32_leading_zeros(x);
+            U32 extra_bits = high_bit - 2;
+            deflate_put_literal_length_symbol(stream, 257 + 4 * (high_bit - 1) + ((x >> extra_bits) & 3));
+            deflate_put_bits(stream, x & ((1 << extra_bits) - 1), extra_bits);
+        }
+    }
+
+    // NOTE(simon): Distance codes cover 2 distances per extra bit count.
+    U32 x = distance - 1;
+    if (x < 4) {
+        deflate_put_code(stream, x, 5);
+    } else {
+        U32 high_bit   = 31 - u32_leading_zeros(x);
+        U32 extra_bits = high_bit - 1;
+        deflate_put_code(stream, 2 * high_bit + ((x >> extra_bits) & 1), 5);
+        deflate_put_bits(stream, x & ((1 << extra_bits) - 1), extra_bits);
+    }
+}
+
+internal U32 deflate_hash(U8 *data) {
+    U32 value = (U32) data[0] << 16 | (U32) data[1] << 8 | (U32) data[2];
+    return (value * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+}
+
+internal U32 deflate_match_length(U8 *a, U8 *b, U32 max_length) {
+    U32 length = 0;
+
+    while (length + 8 <= max_length) {
+        U64 a_bytes = 0;
+        U64 b_bytes = 0;
+        memory_copy(&a_bytes, &a[length], sizeof(a_bytes));
+        memory_copy(&b_bytes, &b[length], sizeof(b_bytes));
+        if (a_bytes != b_bytes) {
+            break;
+        }
+        length += 8;
+    }
+
+    while (length < max_length && a[length] == b[length]) {
+        ++length;
+    }
+
+    return length;
+}
+
+// NOTE(simon): Compresses input until there is less than minimum_lookahead
+// bytes left in the window.
+internal Void deflate_compress(Deflate_Stream *stream, U32 minimum_lookahead) {
+    while (stream->window_size - stream->window_position > minimum_lookahead) {
+        U32 position  = stream->window_position;
+        U32 lookahead = stream->window_size - position;
+        U8 *current   = &stream->window[position];
+
+        U32 match_length   = 0;
+        U32 match_distance = 0;
+        if (lookahead >= DEFLATE_MIN_MATCH) {
+            U32 absolute  = stream->window_base + position;
+            U32 hash      = deflate_hash(current);
+            U32 candidate = stream->head[hash];
+            stream->head[hash] = absolute + 1;
+
+            U32 distance = absolute + 1 - candidate;
+            if (candidate && distance <= DEFLATE_WINDOW_SIZE && distance <= position) {
+                match_length   = deflate_match_length(current, current - distance, u32_min(lookahead, DEFLATE_MAX_MATCH));
+                match_distance = distance;
+            }
+        }
+
+        if (match_length >= DEFLATE_MIN_MATCH) {
+            deflate_put_match(stream, match_length, match_distance);
+
+            // NOTE(simon): Insert the positions covered by the match so
+            // later input can reference them.
+            U32 end = position + match_length;
+            for (U32 i = position + 1; i < end && i + DEFLATE_MIN_MATCH <= stream->window_size; ++i) {
+                stream->head[deflate_hash(&stream->window[i])] = stream->window_base + i + 1;
+            }
+
+            stream->window_position = end;
+        } else {
+            deflate_put_literal_length_symbol(stream, *current);
+            stream->window_position = position + 1;
+        }
+    }
+}
+
+internal Void deflate_begin(Deflate_Stream *stream, Deflate_OutputFunction *output, Void *user_data) {
+    stream->output          = output;
+    stream->user_data       = user_data;
+    stream->success         = true;
+    stream->window_size     = 0;
+    stream->window_position = 0;
+    stream->window_base     = 0;
+    stream->bit_buffer      = 0;
+    stream->bit_count       = 0;
+    stream->output_size     = 0;
+    stream->adler_a         = 1;
+    stream->adler_b         = 0;
+    memory_zero(stream->head, sizeof(stream->head));
+
+    // NOTE(simon): zlib header for deflate with a 32K window and the fastest
+    // compression level, then the header of the only block which uses the
+    // fixed codes.
+    deflate_put_bits(stream, 0x78, 8);
+    deflate_put_bits(stream, 0x01, 8);
+    deflate_put_bits(stream, 1, 1);
+    deflate_put_bits(stream, 1, 2);
+}
+
+internal Void deflate_write(Deflate_Stream *stream, U8 *data, U64 size) {
+    // NOTE(simon): Adler-32, reduced modulo often enough to not overflow.
+    U8 *adler_ptr = data;
+    U8 *adler_opl = data + size;
+    while (adler_ptr < adler_opl) {
+        U8 *chunk_opl = adler_ptr + u64_min((U64) (adler_opl - adler_ptr), 5552);
+        for (; adler_ptr < chunk_opl; ++adler_ptr) {
+            stream->adler_a += *adler_ptr;
+            stream->adler_b += stream->adler_a;
+        }
+        stream->adler_a %= 65521;
+        stream->adler_b %= 65521;
+    }
+
+    U8 *ptr = data;
+    U8 *opl = data + size;
+    while (ptr < opl) {
+        if (stream->window_size == sizeof(stream->window)) {
+            // NOTE(simon): Slide the window. We always keep at least
+            // DEFLATE_MAX_MATCH bytes of lookahead, so the position is past the
+            // first half.
+            memory_move(stream->window, &stream->window[DEFLATE_WINDOW_SIZE], stream->window_size - DEFLATE_WINDOW_SIZE);
+            stream->window_size     -= DEFLATE_WINDOW_SIZE;
+            stream->window_position -= DEFLATE_WINDOW_SIZE;
+            stream->window_base     += DEFLATE_WINDOW_SIZE;
+        }
+
+        U32 copy_size = (U32) u64_min((U64) (opl - ptr), sizeof(stream->window) - stream->window_size);
+        memory_copy(&stream->window[stream->window_size], ptr, copy_size);
+        stream->window_size += copy_size;
+        ptr                 += copy_size;
+
+        deflate_compress(stream, DEFLATE_MAX_MATCH);
+    }
+}
+
+internal B32 deflate_end(Deflate_Stream *stream) {
+    deflate_compress(stream, 0);
+
+    // NOTE(simon): End of block, then pad to a byte boundary.
+    deflate_put_literal_length_symbol(stream, 256);
+    deflate_put_bits(stream, 0, (8 - (stream->bit_count & 7)) & 7);
+
+    U32 adler = stream->adler_b << 16 | stream->adler_a;
+    deflate_put_bits(stream, (adler >> 24) & 0xFF, 8);
+    deflate_put_bits(stream, (adler >> 16) & 0xFF, 8);
+    deflate_put_bits(stream, (adler >>  8) & 0xFF, 8);
+    deflate_put_bits(stream, (adler >>  0) & 0xFF, 8);
+
+    deflate_flush_output(stream);
+    return stream->success;
+}
@@ -0,0 +1,46 @@
+#ifndef DEFLATE_H
+#define DEFLATE_H
+
+// NOTE(simon): Streaming zlib encoder. Everything is emitted as a single block
+// with the fixed Huffman codes, and matches are found with a single probe of a
+// hash table. This trades some compression for speed and lets the stream live
+// in a fixed amount of memory.
+
+#define DEFLATE_WINDOW_SIZE kilobytes(32)
+#define DEFLATE_HASH_BITS   15
+#define DEFLATE_MIN_MATCH   3
+#define DEFLATE_MAX_MATCH   258
+#define DEFLATE_OUTPUT_SIZE kilobytes(64)
+
+typedef B32 Deflate_OutputFunction(Void *user_data, U8 *data, U64 size);
+
+typedef struct {
+    Deflate_OutputFunction *output;
+    Void                   *user_data;
+    B32                     success;
+
+    // NOTE(simon): Holds the previous DEFLATE_WINDOW_SIZE bytes of input for
+    // matching together with the input that hasn't been compressed yet.
+    U8  window[2 * DEFLATE_WINDOW_SIZE];
+    U32 window_size;
+    U32 window_position;
+    U32 window_base;
+
+    // NOTE(simon): Position + 1 of the latest input with a given hash. The
+    // positions wrap, but candidates are always verified against the window.
+    U32 head[1 << DEFLATE_HASH_BITS];
+
+    U64 bit_buffer;
+    U32 bit_count;
+    U32 output_size;
+    U8  output_buffer[DEFLATE_OUTPUT_SIZE];
+
+    U32 adler_a;
+    U32 adler_b;
+} Deflate_Stream;
+
+internal Void deflate_begin(Deflate_Stream *stream, Deflate_OutputFunction *output, Void *user_data);
+internal Void deflate_write(Deflate_Stream *stream, U8 *data, U64 size);
+internal B32  deflate_end(Deflate_Stream *stream);
+
+#endif // DEFLATE_H
@@ -0,0 +1,400 @@
+global U32 image_crc32_table[256] = {
+    0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
+    0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
+    0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+    0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
+    0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
+    0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+    0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+    0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
+    0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+    0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
+    0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
+    0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+    0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
+    0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+    0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+    0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
+    0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
+    0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+    0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
+    0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
+    0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+    0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
+    0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
+    0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+    0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
+    0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
+    0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+    0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+    0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
+    0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+    0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
+    0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
+};
+
+internal U32 image_channel_count_from_format(Image_Format format) {
+    U32 result = 0;
+    switch (format) {
+        case Image_Format_R8:    result = 1; break;
+        case Image_Format_RGB8:  result = 3; break;
+        case Image_Format_RGBA8: result = 4; break;
+        case Image_Format_COUNT: break;
+    }
+    return result;
+}
+
+internal U32 image_crc32_update(U32 crc, U8 *data, U64 size) {
+    for (U64 i = 0; i < size; ++i) {
+        crc = image_crc32_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+internal B32 image_file_sink_write(Void *user_data, U8 *data, U64 size) {
+    return os_file_write_block(*(OS_File *) user_data, data, size);
+}
+
+internal Image_Sink image_sink_from_file(OS_File *file) {
+    Image_Sink result = { 0 };
+    result.write     = image_file_sink_write;
+    result.user_data = file;
+    return result;
+}
+
+internal Void image_writer_flush(Image_Writer *writer) {
+    if (writer->size) {
+        if (writer->success) {
+            writer->success = writer->sink.write(writer->sink.user_data, writer->buffer, writer->size);
+        }
+        writer->size = 0;
+    }
+}
+
+internal Void image_writer_write(Image_Writer *writer, Void *data, U64 size) {
+    if (size == 0) {
+        return;
+    }
+
+    if (writer->size + size > IMAGE_WRITER_BUFFER_SIZE) {
+        image_writer_flush(writer);
+    }
+
+    if (size > IMAGE_WRITER_BUFFER_SIZE) {
+        if (writer->success) {
+            writer->success = writer->sink.write(writer->sink.user_data, (U8 *) data, size);
+        }
+    } else {
+        memory_copy(&writer->buffer[writer->size], data, size);
+        writer->size += (U32) size;
+    }
+}
+
+internal Void image_writer_u8(Image_Writer *writer, U8 value) {
+    image_writer_write(writer, &value, 1);
+}
+
+internal Void image_writer_u16_le(Image_Writer *writer, U16 value) {
+    U8 bytes[2] = { (U8) value, (U8) (value >> 8) };
+    image_writer_write(writer, bytes, sizeof(bytes));
+}
+
+internal Void image_writer_u32_le(Image_Writer *writer, U32 value) {
+    U8 bytes[4] = { (U8) value, (U8) (value >> 8), (U8) (value >> 16), (U8) (value >> 24) };
+    image_writer_write(writer, bytes, sizeof(bytes));
+}
+
+internal Void image_writer_u32_be(Image_Writer *writer, U32 value) {
+    U8 bytes[4] = { (U8) (value >> 24), (U8) (value >> 16), (U8) (value >> 8), (U8) value };
+    image_writer_write(writer, bytes, sizeof(bytes));
+}
+
+internal Image_Writer *image_writer_begin(Arena *arena, Image_Sink sink) {
+    Image_Writer *writer = arena_push_struct(arena, Image_Writer);
+    writer->sink    = sink;
+    writer->success = true;
+    writer->size    = 0;
+    return writer;
+}
+
+internal B32 image_writer_end(Image_Writer *writer) {
+    image_writer_flush(writer);
+    return writer->success;
+}
+
+// NOTE(simon): Converts a source row into the output format. BMP and TGA
+// store color as BGR.
+internal Void image_convert_row(Image_Source *source, U32 y, U8 *result, B32 swap_red_and_blue) {
+    U8 *pixel       = source->pixels + (S64) y * source->stride;
+    U32 pixel_size  = source->pixel_size;
+    U32 red_index   = (swap_red_and_blue ? 2 : 0);
+    U32 blue_index  = (swap_red_and_blue ? 0 : 2);
+
+    switch (source->format) {
+        case Image_Format_R8: {
+            for (U32 x = 0; x < source->width; ++x, pixel += pixel_size) {
+                result[x] = pixel[0];
+            }
+        } break;
+        case Image_Format_RGB8: {
+            for (U32 x = 0; x < source->width; ++x, pixel += pixel_size, result += 3) {
+                B32 has_color = pixel_size >= 3;
+                result[red_index]  = pixel[0];
+                result[1]          = pixel[has_color ? 1 : 0];
+                result[blue_index] = pixel[has_color ? 2 : 0];
+            }
+        } break;
+        case Image_Format_RGBA8: {
+            for (U32 x = 0; x < source->width; ++x, pixel += pixel_size, result += 4) {
+                B32 has_color = pixel_size >= 3;
+                result[red_index]  = pixel[0];
+                result[1]          = pixel[has_color ? 1 : 0];
+                result[blue_index] = pixel[has_color ? 2 : 0];
+                result[3]          = (pixel_size == 4 ? pixel[3] : pixel_size == 2 ? pixel[1] : 0xFF);
+            }
+        } break;
+        case Image_Format_COUNT: {
+        } break;
+    }
+}
+
+internal B32 image_validate_source(Image_Source *source) {
+    B32 success = true;
+
+    if (image_channel_count_from_format(source->format) == 0) {
+        error_emit(str8_literal("ERROR(image): Unknown image format."));
+        success = false;
+    } else if (source->width == 0 || source->height == 0 || source->pixel_size == 0 || source->pixel_size > 4) {
+        error_emit(str8_literal("ERROR(image): Invalid image dimensions."));
+        success = false;
+    } else if (source->width > 0x7FFFFFFF / 4 || source->height > 0x7FFFFFFF) {
+        error_emit(str8_literal("ERROR(image): Image is too large."));
+        success = false;
+    }
+
+    return success;
+}
+
+internal B32 image_write_bmp(Image_Sink sink, Image_Source *source) {
+    if (!image_validate_source(source)) {
+        return false;
+    }
+
+    Arena_Temporary scratch = arena_get_scratch(0, 0);
+    Image_Writer *writer = image_writer_begin(scratch.arena, sink);
+
+    U32 channel_count = image_channel_count_from_format(source->format);
+    U32 row_size      = source->width * channel_count;
+    U32 padded_size   = u32_round_up_to_power_of_2(row_size, 4);
+    U32 palette_size  = (channel_count == 1 ? 256 * 4 : 0);
+    U32 header_size   = 14 + 108 + palette_size;
+    U8 *row           = arena_push_array_zero(scratch.arena, U8, padded_size);
+
+    // NOTE(simon): File header.
+    image_writer_write(writer, "BM", 2);
+    image_writer_u32_le(writer, header_size + padded_size * source->height);
+    image_writer_u32_le(writer, 0);
+    image_writer_u32_le(writer, header_size);
+
+    // NOTE(simon): BITMAPV4HEADER, which can describe the alpha channel. The
+    // negative height stores the rows top-down.
+    image_writer_u32_le(writer, 108);
+    image_writer_u32_le(writer, source->width);
+    image_writer_u32_le(writer, (U32) -(S32) source->height);
+    image_writer_u16_le(writer, 1);
+    image_writer_u16_le(writer, (U16) (channel_count * 8));
+    image_writer_u32_le(writer, (channel_count == 4 ? 3 : 0)); // NOTE(simon): BI_BITFIELDS or BI_RGB
+    image_writer_u32_le(writer, padded_size * source->height);
+    image_writer_u32_le(writer, 2835);
+    image_writer_u32_le(writer, 2835);
+    image_writer_u32_le(writer, (channel_count == 1 ? 256 : 0));
+    image_writer_u32_le(writer, 0);
+    image_writer_u32_le(writer, (channel_count == 4 ? 0x00FF0000 : 0));
+    image_writer_u32_le(writer, (channel_count == 4 ? 0x0000FF00 : 0));
+    image_writer_u32_le(writer, (channel_count == 4 ? 0x000000FF : 0));
+    image_writer_u32_le(writer, (channel_count == 4 ? 0xFF000000 : 0));
+    image_writer_u32_le(writer, 0x73524742); // NOTE(simon): LCS_sRGB
+    for (U32 i = 0; i < 12; ++i) {
+        image_writer_u32_le(writer, 0);
+    }
+
+    // NOTE(simon): Single channel images use a grayscale palette.
+    if (channel_count == 1) {
+        for (U32 i = 0; i < 256; ++i) {
+            U8 entry[4] = { (U8) i, (U8) i, (U8) i, 0 };
+            image_writer_write(writer, entry, sizeof(entry));
+        }
+    }
+
+    for (U32 y = 0; y < source->height; ++y) {
+        image_convert_row(source, y, row, true);
+        image_writer_write(writer, row, padded_size);
+    }
+
+    B32 success = image_writer_end(writer);
+    if (!success) {
+        error_emit(str8_literal("ERROR(image/bmp): Could not write image."));
+    }
+
+    arena_end_temporary(scratch);
+    return success;
+}
+
+internal B32 image_write_tga(Image_Sink sink, Image_Source *source) {
+    if (!image_validate_source(source)) {
+        return false;
+    } else if (source->width > 0xFFFF || source->height > 0xFFFF) {
+        error_emit(str8_literal("ERROR(image/tga): Image is too large."));
+        return false;
+    }
+
+    Arena_Temporary scratch = arena_get_scratch(0, 0);
+    Image_Writer *writer = image_writer_begin(scratch.arena, sink);
+
+    U32 channel_count = image_channel_count_from_format(source->format);
+    U32 row_size      = source->width * channel_count;
+    U8 *row           = arena_push_array(scratch.arena, U8, row_size);
+
+    image_writer_u8(writer, 0);                                    // NOTE(simon): ID length
+    image_writer_u8(writer, 0);                                    // NOTE(simon): No color map
+    image_writer_u8(writer, (channel_count == 1 ? 3 : 2));         // NOTE(simon): Uncompressed grayscale or true-color
+    image_writer_write(writer, (U8[5]) { 0 }, 5);                  // NOTE(simon): Color map specification
+    image_writer_u16_le(writer, 0);
+    image_writer_u16_le(writer, 0);
+    image_writer_u16_le(writer, (U16) source->width);
+    image_writer_u16_le(writer, (U16) source->height);
+    image_writer_u8(writer, (U8) (channel_count * 8));
+    image_writer_u8(writer, (channel_count == 4 ? 8 : 0) | 0x20); // NOTE(simon): Alpha bits and top-left origin
+
+    for (U32 y = 0; y < source->height; ++y) {
+        image_convert_row(source, y, row, true);
+        image_writer_write(writer, row, row_size);
+    }
+
+    B32 success = image_writer_end(writer);
+    if (!success) {
+        error_emit(str8_literal("ERROR(image/tga): Could not write image."));
+    }
+
+    arena_end_temporary(scratch);
+    return success;
+}
+
+internal Void image_png_write_chunk(Image_Writer *writer, CStr type, U8 *data, U32 size) {
+    U32 crc = 0xFFFFFFFF;
+    crc = image_crc32_update(crc, (U8 *) type, 4);
+    crc = image_crc32_update(crc, data, size);
+
+    image_writer_u32_be(writer, size);
+    image_writer_write(writer, type, 4);
+    image_writer_write(writer, data, size);
+    image_writer_u32_be(writer, crc ^ 0xFFFFFFFF);
+}
+
+internal B32 image_png_write_idat(Void *user_data, U8 *data, U64 size) {
+    Image_Writer *writer = (Image_Writer *) user_data;
+    image_png_write_chunk(writer, "IDAT", data, (U32) size);
+    return writer->success;
+}
+
+internal U8 image_png_paeth(U8 a, U8 b, U8 c) {
+    S32 p  = (S32) a + (S32) b - (S32) c;
+    S32 pa = s32_abs(p - (S32) a);
+    S32 pb = s32_abs(p - (S32) b);
+    S32 pc = s32_abs(p - (S32) c);
+
+    U8 result = c;
+    if (pa <= pb && pa <= pc) {
+        result = a;
+    } else if (pb <= pc) {
+        result = b;
+    }
+    return result;
+}
+
+internal B32 image_write_png(Image_Sink sink, Image_Source *source) {
+    if (!image_validate_source(source)) {
+        return false;
+    }
+
+    Arena_Temporary scratch = arena_get_scratch(0, 0);
+    Image_Writer   *writer  = image_writer_begin(scratch.arena, sink);
+    Deflate_Stream *stream  = arena_push_struct(scratch.arena, Deflate_Stream);
+
+    U32 channel_count = image_channel_count_from_format(source->format);
+    U32 row_size      = source->width * channel_count;
+    U8 *previous_row  = arena_push_array_zero(scratch.arena, U8, row_size);
+    U8 *current_row   = arena_push_array(scratch.arena, U8, row_size);
+    U8 *filtered_row  = arena_push_array(scratch.arena, U8, row_size + 1);
+
+    U8 signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    image_writer_write(writer, signature, sizeof(signature));
+
+    local U8 color_types[] = {
+        [Image_Format_R8]    = 0,
+        [Image_Format_RGB8]  = 2,
+        [Image_Format_RGBA8] = 6,
+    };
+    U8 header[13] = {
+        (U8) (source->width  >> 24), (U8) (source->width  >> 16), (U8) (source->width  >> 8), (U8) source->width,
+        (U8) (source->height >> 24), (U8) (source->height >> 16), (U8) (source->height >> 8), (U8) source->height,
+        8, color_types[source->format], 0, 0, 0,
+    };
+    image_png_write_chunk(writer, "IHDR", header, sizeof(header));
+
+    // NOTE(simon): Every row uses the Paeth filter, which works well for the
+    // smooth gradients of distance fields.
+    deflate_begin(stream, image_png_write_idat, writer);
+    for (U32 y = 0; y < source->height; ++y) {
+        image_convert_row(source, y, current_row, false);
+
+        filtered_row[0] = 4;
+        for (U32 i = 0; i < channel_count; ++i) {
+            filtered_row[1 + i] = (U8) (current_row[i] - image_png_paeth(0, previous_row[i], 0));
+        }
+        for (U32 i = channel_count; i < row_size; ++i) {
+            U8 predictor = image_png_paeth(current_row[i - channel_count], previous_row[i], previous_row[i - channel_count]);
+            filtered_row[1 + i] = (U8) (current_row[i] - predictor);
+        }
+
+        deflate_write(stream, filtered_row, row_size + 1);
+        swap(previous_row, current_row, U8 *);
+    }
+    deflate_end(stream);
+
+    image_png_write_chunk(writer, "IEND", 0, 0);
+
+    B32 success = image_writer_end(writer);
+    if (!success) {
+        error_emit(str8_literal("ERROR(image/png): Could not write image."));
+    }
+
+    arena_end_temporary(scratch);
+    return success;
+}
+
+internal B32 image_write(Image_Sink sink, Image_FileFormat file_format, Image_Source *source) {
+    B32 success = false;
+    switch (file_format) {
+        case Image_FileFormat_BMP: success = image_write_bmp(sink, source); break;
+        case Image_FileFormat_TGA: success = image_write_tga(sink, source); break;
+        case Image_FileFormat_PNG: success = image_write_png(sink, source); break;
+        case Image_FileFormat_COUNT: {
+            error_emit(str8_literal("ERROR(image): Unknown file format."));
+        } break;
+    }
+    return success;
+}
+
+internal B32 image_write_to_file(Str8 file_name, Image_FileFormat file_format, Image_Source *source) {
+    OS_File file = { 0 };
+    if (!os_file_open_for_writing(file_name, &file)) {
+        error_emit(str8_literal("ERROR(image): Could not open file for writing."));
+        return false;
+    }
+
+    B32 success = image_write(image_sink_from_file(&file), file_format, source);
+    os_file_close(file);
+
+    return success;
+}
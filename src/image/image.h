@@ -0,0 +1,60 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#define IMAGE_WRITER_BUFFER_SIZE kilobytes(64)
+
+typedef enum {
+    Image_Format_R8,
+    Image_Format_RGB8,
+    Image_Format_RGBA8,
+    Image_Format_COUNT,
+} Image_Format;
+
+typedef enum {
+    Image_FileFormat_BMP,
+    Image_FileFormat_TGA,
+    Image_FileFormat_PNG,
+    Image_FileFormat_COUNT,
+} Image_FileFormat;
+
+// NOTE(simon): Pixels are read in place, one row at a time. Source channels
+// are in RGBA order and pixel_size is the number of bytes per pixel, so an
+// RGBA8 atlas can be written as R8 or RGB8 directly. Missing color channels
+// are replicated from the first channel and missing alpha is opaque. Use a
+// negative stride to write the rows bottom-up.
+typedef struct {
+    U8          *pixels;
+    U32          width;
+    U32          height;
+    S64          stride;
+    U32          pixel_size;
+    Image_Format format;
+} Image_Source;
+
+typedef B32 Image_SinkFunction(Void *user_data, U8 *data, U64 size);
+
+typedef struct {
+    Image_SinkFunction *write;
+    Void               *user_data;
+} Image_Sink;
+
+typedef struct {
+    Image_Sink sink;
+    B32        success;
+    U32        size;
+    U8         buffer[IMAGE_WRITER_BUFFER_SIZE];
+} Image_Writer;
+
+internal U32 image_channel_count_from_format(Image_Format format);
+
+internal Image_Sink image_sink_from_file(OS_File *file);
+
+// NOTE(simon): None of the writers allocate except for a fixed amount of
+// scratch memory, so they can be run from any number of threads at once.
+internal B32 image_write_bmp(Image_Sink sink, Image_Source *source);
+internal B32 image_write_tga(Image_Sink sink, Image_Source *source);
+internal B32 image_write_png(Image_Sink sink, Image_Source *source);
+internal B32 image_write(Image_Sink sink, Image_FileFormat file_format, Image_Source *source);
+internal B32 image_write_to_file(Str8 file_name, Image_FileFormat file_format, Image_Source *source);
+
+#endif // IMAGE_H
@@ -0,0 +1,2 @@
+#include "deflate.c"
+#include "image.c"
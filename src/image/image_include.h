@@ -0,0 +1,7 @@
+#ifndef IMAGE_INCLUDE_H
+#define IMAGE_INCLUDE_H
+
+#include "deflate.h"
+#include "image.h"
+
+#endif // IMAGE_INCLUDE_H
@@ -2,11 +2,13 @@
 #include "src/graphics/graphics_include.h"
 #include "src/render/render_include.h"
 #include "src/font/font_include.h"
+#include "src/image/image_include.h"
 
 #include "src/base/base_include.c"
 #include "src/graphics/graphics_include.c"
 #include "src/render/render_include.c"
 #include "src/font/font_include.c"
+#include "src/image/image_include.c"
 
 typedef struct {
     V2F32 min_pt;
@@ -21,12 +23,29 @@ typedef struct {
     Glyph glyphs[128];
 } Font;
 
+// NOTE(simon): A string that has been laid out once into glyph quads relative
+// to its origin. It is only rebuilt when one of its inputs change, otherwise
+// the quads are submitted to the renderer as-is.
+typedef struct {
+    Font *font;
+    Str8  string;
+    F32   point_size;
+    V4F32 color;
+    Render_RectangleFlags flags;
+
+    U64 string_capacity;
+    U32 rectangle_count;
+    U32 rectangle_capacity;
+    Render_Rectangle *rectangles;
+    V2F32 size;
+} TextRun;
+
 internal Void load_font(Render_Context *render, Str8 font_path, Font *result) {
     Arena_Temporary scratch = arena_get_scratch(0, 0);
     U32 glyph_size     = 32;
     U32 glyphs_per_row = 16;
     U32 atlas_size     = glyph_size * glyphs_per_row;
-    result->atlas = render_texture_create(render, v2u32(atlas_size, atlas_size), 0);
+    result->atlas = render_texture_create(render, v2u32(atlas_size, atlas_size), Render_TextureFormat_RGB8, 0);
 
     TTF_Font font = { 0 };
     if (ttf_load(scratch.arena, font_path, &font)) {
@@ -34,7 +53,7 @@ internal Void load_font(Render_Context *render, Str8 font_path, Font *result) {
         for (U32 codepoint = 0; codepoint < 128; ++codepoint) {
             Arena_Temporary glyph_scratch = arena_get_scratch(&scratch.arena, 1);
 
-            MSDF_RasterResult raster_result = msdf_generate(glyph_scratch.arena, &font, codepoint, glyph_size);
+            MSDF_RasterResult raster_result = msdf_generate(glyph_scratch.arena, &font, codepoint, glyph_size, .format = MSDF_Format_RGB8);
 
             V2U32 atlas_position = v2u32(
                 glyph_size * (codepoint % glyphs_per_row),
@@ -70,6 +89,311 @@ internal Void load_font(Render_Context *render, Str8 font_path, Font *result) {
     arena_end_temporary(scratch);
 }
 
+typedef struct {
+    TTF_Font    *font;
+    U32         *glyph_indicies;
+    U32          glyph_size;
+    U32          glyphs_per_row;
+    B32          narrow_band;
+    B32          adaptive;
+    B32          seeded_newton;
+    MSDF_Mode    mode;
+    MSDF_Format  format;
+    // NOTE(simon): Optional. Set when glyphs are baked one at a time, so
+    // that each of them is rasterized in parallel instead.
+    ThreadPool  *pool;
+
+    // NOTE(simon): Optional. When 0, glyphs are rasterized and then discarded.
+    U8 *atlas;
+    U64 atlas_stride;
+} BakeJob;
+
+internal Void bake_glyph(Void *data, U32 task_index) {
+    BakeJob *job = (BakeJob *) data;
+    Arena_Temporary scratch = arena_get_scratch(0, 0);
+
+    // NOTE(simon): Glyphs are written straight into their cell of the atlas.
+    U8 *cell = 0;
+    if (job->atlas) {
+        U64 row_size = job->glyph_size * msdf_pixel_size_from_format(job->format);
+        cell = &job->atlas[
+            (task_index / job->glyphs_per_row) * job->glyph_size * job->atlas_stride +
+            (task_index % job->glyphs_per_row) * row_size
+        ];
+    }
+
+    // NOTE(simon): Every glyph is only rasterized once, so there is nothing to
+    // gain from keeping the prepared geometry around.
+    MSDF_PreparedGlyph *glyph = msdf_prepare_glyph(scratch.arena, job->font, job->glyph_indicies[task_index], job->glyph_size, job->mode);
+    msdf_rasterize(
+        scratch.arena, glyph, job->glyph_size,
+        .mode = job->mode, .format = job->format,
+        .narrow_band = job->narrow_band, .adaptive = job->adaptive, .seeded_newton = job->seeded_newton,
+        .pool = job->pool, .destination = cell, .stride = job->atlas_stride
+    );
+
+    arena_end_temporary(scratch);
+}
+
+// NOTE(simon): Rasterizes every glyph that the font maps a codepoint in the
+// charset to, once per glyph, and optionally writes them to a PNG atlas in
+// codepoint order. A null charset bakes every mapped codepoint. SDF atlases
+// have a single channel instead of three.
+internal S32 bake_font(Arena *arena, Str8 font_path, Charset *charset, U32 glyph_size, B32 narrow_band, B32 adaptive, B32 seeded_newton, B32 sdf, Str8 output_path, TTF_VariationCoordinate *coordinates, U32 coordinate_count) {
+    U64 load_start = os_now_nanoseconds();
+
+    TTF_Font font = { 0 };
+    if (!ttf_load(arena, font_path, &font) || !ttf_set_variation(arena, &font, coordinates, coordinate_count)) {
+        os_console_print(error_get_error_message());
+        os_console_print(str8_literal("\n"));
+        return 1;
+    }
+
+    // NOTE(simon): Many fonts map several codepoints to the same glyph, only
+    // bake each glyph once.
+    B8  *is_queued       = arena_push_array_zero(arena, B8, font.glyph_count);
+    U32 *glyph_indicies  = arena_push_array(arena, U32, font.codepoint_count);
+    U32  glyph_count     = 0;
+    U32  codepoint_count = 0;
+    for (U32 i = 0; i < font.codepoint_count; ++i) {
+        if (charset && !charset_contains(charset, font.codepoints[i])) {
+            continue;
+        }
+
+        ++codepoint_count;
+        U32 glyph_index = font.glyph_indicies[i];
+        if (!is_queued[glyph_index]) {
+            is_queued[glyph_index]        = true;
+            glyph_indicies[glyph_count++] = glyph_index;
+        }
+    }
+
+    U64 load_end = os_now_nanoseconds();
+
+    BakeJob job = { 0 };
+    job.font           = &font;
+    job.glyph_indicies = glyph_indicies;
+    job.glyph_size     = glyph_size;
+    job.narrow_band    = narrow_band;
+    job.adaptive       = adaptive;
+    job.seeded_newton  = seeded_newton;
+    job.mode           = (sdf ? MSDF_Mode_SDF  : MSDF_Mode_MSDF);
+    job.format         = (sdf ? MSDF_Format_R8 : MSDF_Format_RGB8);
+    job.glyphs_per_row = u32_max(1, (U32) f32_ceil(f32_sqrt((F32) glyph_count)));
+
+    U32 atlas_width  = job.glyph_size * job.glyphs_per_row;
+    U32 atlas_height = job.glyph_size * ((glyph_count + job.glyphs_per_row - 1) / job.glyphs_per_row);
+    if (output_path.size) {
+        job.atlas_stride = (U64) atlas_width * msdf_pixel_size_from_format(job.format);
+        job.atlas        = arena_push_array_zero(arena, U8, job.atlas_stride * atlas_height);
+    }
+
+    ThreadPool *pool = thread_pool_create(arena, 0);
+
+    // NOTE(simon): With fewer glyphs than threads, some threads would sit
+    // idle, so split the rows of each glyph between them instead.
+    U64 bake_start = os_now_nanoseconds();
+    if (glyph_count < pool->thread_count + 1) {
+        job.pool = pool;
+        for (U32 i = 0; i < glyph_count; ++i) {
+            bake_glyph(&job, i);
+        }
+    } else {
+        thread_pool_run(pool, bake_glyph, &job, glyph_count);
+    }
+    U64 bake_end = os_now_nanoseconds();
+
+    F64 bake_seconds = (F64) (bake_end - bake_start) / 1e9;
+    os_console_print(str8_format(
+        arena, "Loaded %u codepoints mapping to %u glyphs in %.2f ms.\n",
+        codepoint_count, glyph_count, (F64) (load_end - load_start) / 1e6
+    ));
+    os_console_print(str8_format(
+        arena, "Baked %u glyphs at %u px on %u threads in %.3f s: %.1f glyphs/s, %.2f Mpixels/s.\n",
+        glyph_count, glyph_size, pool->thread_count + 1, bake_seconds,
+        (F64) glyph_count / bake_seconds, (F64) glyph_count * glyph_size * glyph_size / bake_seconds / 1e6
+    ));
+
+    thread_pool_destroy(pool);
+
+    S32 result = 0;
+    if (job.atlas) {
+        Image_Source source = { 0 };
+        source.pixels     = job.atlas;
+        source.width      = atlas_width;
+        source.height     = atlas_height;
+        source.stride     = (S64) job.atlas_stride;
+        source.pixel_size = msdf_pixel_size_from_format(job.format);
+        source.format     = (sdf ? Image_Format_R8 : Image_Format_RGB8);
+
+        if (!image_write_to_file(output_path, Image_FileFormat_PNG, &source)) {
+            os_console_print(error_get_error_message());
+            result = 1;
+        }
+    }
+
+    return result;
+}
+
+// NOTE(simon): Storage is taken from the arena and only grows, so pass an
+// arena that lives at least as long as the run.
+internal Void text_run_update(Arena *arena, TextRun *run, Font *font, Str8 string, F32 point_size, V4F32 color, Render_RectangleFlags flags) {
+    B32 is_dirty =
+        run->font != font || run->point_size != point_size ||
+        run->flags != flags || !str8_equal(run->string, string) ||
+        run->color.r != color.r || run->color.g != color.g || run->color.b != color.b || run->color.a != color.a;
+    if (!is_dirty) {
+        return;
+    }
+
+    // NOTE(simon): We never have more glyphs than bytes in the string.
+    if (string.size > run->string_capacity) {
+        run->string_capacity    = u64_ceil_to_power_of_2(string.size);
+        run->string.data        = arena_push_array(arena, U8, run->string_capacity);
+        run->rectangle_capacity = (U32) run->string_capacity;
+        run->rectangles         = arena_push_array(arena, Render_Rectangle, run->rectangle_capacity);
+    }
+
+    memory_copy(run->string.data, string.data, string.size);
+    run->string.size     = string.size;
+    run->font            = font;
+    run->point_size      = point_size;
+    run->color           = color;
+    run->flags           = flags;
+    run->rectangle_count = 0;
+
+    V2F32 text_point = v2f32(0.0f, 0.0f);
+    for (U8 *ptr = string.data, *opl = string.data + string.size; ptr < opl; ) {
+        StringDecode decode = string_decode_utf8(ptr, (U64) (opl - ptr));
+        ptr += decode.size;
+
+        if (decode.codepoint >= array_count(font->glyphs)) {
+            continue;
+        }
+
+        Glyph *glyph = &font->glyphs[decode.codepoint];
+
+        Render_Rectangle *rectangle = &run->rectangles[run->rectangle_count++];
+        rectangle->min    = v2f32_add(text_point, v2f32_scale(glyph->min_pt, point_size));
+        rectangle->max    = v2f32_add(text_point, v2f32_scale(glyph->max_pt, point_size));
+        rectangle->color  = color;
+        rectangle->uv_min = glyph->uv_min;
+        rectangle->uv_max = glyph->uv_max;
+        rectangle->flags  = flags;
+
+        text_point.x += glyph->advance_pt * point_size;
+    }
+
+    run->size = v2f32(text_point.x, point_size);
+}
+
+internal Void text_run_draw(Render_Context *render, TextRun *run, V2F32 position) {
+    if (run->rectangle_count) {
+        render_rectangles(render, run->font->atlas, run->rectangles, run->rectangle_count, position);
+    }
+}
+
+// NOTE(simon): msdf-gen --bake <font> [options]
+//     --size <pixels>      Size of each glyph, 32 by default.
+//     --output <file.png>  Write the glyphs to an atlas.
+//     --charset <set>      Only bake these codepoints, see charset_parse.
+//     --text <file>        Only bake the codepoints used in a UTF-8 file.
+//     --narrow-band        Only compute exact distances near the outlines.
+//     --adaptive           Interpolate blocks where the closest lines are fixed.
+//     --seeded-newton      Find closest points from those of the previous pixel.
+//     --sdf                Bake a single channel SDF instead of an MSDF.
+//     --variation <axis>=<value>,...
+//                          Bake an instance of a variable font, such as
+//                          wght=700,wdth=87.5. Values are in user units.
+// --charset and --text can be repeated, and the union of all of them is baked.
+internal S32 bake_main(Arena *arena, Str8Node *arguments) {
+    Str8     font_path     = { 0 };
+    Str8     output_path   = { 0 };
+    U64      glyph_size    = 32;
+    B32      narrow_band   = false;
+    B32      adaptive      = false;
+    B32      seeded_newton = false;
+    B32      sdf           = false;
+    Charset *charset       = 0;
+
+    // NOTE(simon): Axes can be repeated, the last value wins.
+    TTF_VariationCoordinate coordinates[64] = { 0 };
+    U32 coordinate_count = 0;
+
+    B32 success = arguments != 0;
+    for (Str8Node *node = arguments; success && node; node = node->next) {
+        Str8  argument = node->string;
+        Str8 *value    = (node->next ? &node->next->string : 0);
+
+        if (str8_equal(argument, str8_literal("--size")) && value) {
+            success = u64_from_str8(*value, &glyph_size) && 3 <= glyph_size && glyph_size <= 4096;
+            node = node->next;
+        } else if (str8_equal(argument, str8_literal("--output")) && value) {
+            output_path = *value;
+            node = node->next;
+        } else if ((str8_equal(argument, str8_literal("--charset")) || str8_equal(argument, str8_literal("--text"))) && value) {
+            if (!charset) {
+                charset = arena_push_struct_zero(arena, Charset);
+            }
+
+            B32 is_valid = false;
+            if (str8_equal(argument, str8_literal("--charset"))) {
+                is_valid = charset_parse(arena, charset, *value);
+            } else {
+                is_valid = charset_add_file(arena, charset, *value);
+            }
+
+            if (!is_valid) {
+                os_console_print(error_get_error_message());
+                os_console_print(str8_literal("\n"));
+                return 1;
+            }
+            node = node->next;
+        } else if (str8_equal(argument, str8_literal("--narrow-band"))) {
+            narrow_band = true;
+        } else if (str8_equal(argument, str8_literal("--adaptive"))) {
+            adaptive = true;
+        } else if (str8_equal(argument, str8_literal("--seeded-newton"))) {
+            seeded_newton = true;
+        } else if (str8_equal(argument, str8_literal("--sdf"))) {
+            sdf = true;
+        } else if (str8_equal(argument, str8_literal("--variation")) && value) {
+            Str8List settings = str8_split_by_codepoints(arena, *value, str8_literal(","));
+            for (Str8Node *setting = settings.first; success && setting; setting = setting->next) {
+                U64 equal_index = 0;
+                F64 axis_value  = 0.0;
+                success =
+                    coordinate_count < array_count(coordinates) &&
+                    str8_first_index_of(setting->string, '=', &equal_index) && 1 <= equal_index && equal_index <= 4 &&
+                    f64_from_str8(str8_skip(setting->string, equal_index + 1), &axis_value);
+
+                // NOTE(simon): Tags shorter than 4 characters are padded
+                // with spaces.
+                if (success) {
+                    U8 tag[4] = { ' ', ' ', ' ', ' ' };
+                    memory_copy(tag, setting->string.data, equal_index);
+
+                    TTF_VariationCoordinate *coordinate = &coordinates[coordinate_count++];
+                    coordinate->tag   = TTF_MAKE_TAG(tag[0], tag[1], tag[2], tag[3]);
+                    coordinate->value = (F32) axis_value;
+                }
+            }
+            node = node->next;
+        } else if (!font_path.size && !str8_equal(str8_prefix(argument, 2), str8_literal("--"))) {
+            font_path = argument;
+        } else {
+            success = false;
+        }
+    }
+
+    if (!success || !font_path.size) {
+        os_console_print(str8_literal("Usage: msdf-gen --bake <font> [--size <pixels>] [--narrow-band] [--adaptive] [--seeded-newton] [--sdf] [--output <file.png>] [--charset <set>]... [--text <file>]... [--variation <axis>=<value>,...]\n"));
+        return 1;
+    }
+
+    return bake_font(arena, font_path, charset, (U32) glyph_size, narrow_band, adaptive, seeded_newton, sdf, output_path, coordinates, coordinate_count);
+}
+
 internal S32 os_run(Str8List arguments) {
     if (!arguments.first->next) {
         os_console_print(str8_literal("You have to pass a file\n"));
@@ -78,6 +402,10 @@ internal S32 os_run(Str8List arguments) {
 
     Arena *arena = arena_create();
 
+    if (str8_equal(arguments.first->next->string, str8_literal("--bake"))) {
+        return bake_main(arena, arguments.first->next->next);
+    }
+
     render_init();
 
     Gfx_Context *gfx = gfx_create(arena, str8_literal("MSDF-gen"), 1280, 720);
@@ -100,6 +428,8 @@ internal S32 os_run(Str8List arguments) {
     Arena *current_arena  = arena_create();
     Arena *previous_arena = arena_create();
 
+    TextRun label = { 0 };
+
     while (running) {
         Gfx_EventList events = gfx_get_events(current_arena, gfx);
         V2F32 mouse = gfx_get_mouse_position(gfx);
@@ -138,26 +468,12 @@ internal S32 os_run(Str8List arguments) {
             .flags = (render_msdf ? Render_RectangleFlags_MSDF : Render_RectangleFlags_Texture)
         );
 
-        Str8 string = str8_literal("MSDF-based text rendering");
-        V2F32 text_point = offset;
-        F32 point_size = 50.0f / zoom;
-        for (U8 *ptr = string.data, *opl = string.data + string.size; ptr < opl; ) {
-            StringDecode decode = string_decode_utf8(ptr, (U64) (opl - ptr));
-            ptr += decode.size;
-
-            Glyph *glyph = &font.glyphs[decode.codepoint];
-
-            render_rectangle(
-                render,
-                v2f32_add(text_point, v2f32_scale(glyph->min_pt, point_size)), v2f32_add(text_point, v2f32_scale(glyph->max_pt, point_size)),
-                .uv_min = glyph->uv_min, .uv_max = glyph->uv_max,
-                .texture = font.atlas,
-                .color = v4f32(1.0f, 1.0f, 1.0f, 1.0f),
-                .flags = (render_msdf ? Render_RectangleFlags_MSDF : Render_RectangleFlags_Texture)
-            );
-
-            text_point.x += glyph->advance_pt * point_size;
-        }
+        text_run_update(
+            arena, &label, &font, str8_literal("MSDF-based text rendering"), 50.0f / zoom,
+            v4f32(1.0f, 1.0f, 1.0f, 1.0f),
+            (render_msdf ? Render_RectangleFlags_MSDF : Render_RectangleFlags_Texture)
+        );
+        text_run_draw(render, &label, offset);
 
         render_end(render);
 
@@ -13,13 +13,26 @@
 #define GL_FALSE                0
 #define GL_FLOAT                0x1406
 #define GL_FRAGMENT_SHADER      0x8B30
+#define GL_HALF_FLOAT           0x140B
 #define GL_INFO_LOG_LENGTH      0x8B84
 #define GL_INT                  0x1404
 #define GL_LINEAR               0x2601
 #define GL_LINK_STATUS          0x8B82
+#define GL_MAP_COHERENT_BIT     0x0080
+#define GL_MAP_PERSISTENT_BIT   0x0040
+#define GL_MAP_WRITE_BIT        0x0002
 #define GL_ONE_MINUS_SRC1_COLOR 0x88FA
 #define GL_ONE_MINUS_SRC_ALPHA  0x0303
+#define GL_PIXEL_UNPACK_BUFFER  0x88EC
+#define GL_R8                   0x8229
+#define GL_RED                  0x1903
+#define GL_RGB                  0x1907
+#define GL_RGB16                0x8054
+#define GL_RGB16F               0x881B
+#define GL_RGB8                 0x8051
 #define GL_RGBA                 0x1908
+#define GL_RGBA16               0x805B
+#define GL_RGBA16F              0x881A
 #define GL_RGBA8                0x8058
 #define GL_SCISSOR_TEST         0x0C11
 #define GL_SRC1_ALPHA           0x8589
@@ -31,10 +44,13 @@
 #define GL_TEXTURE_MIN_FILTER   0x2801
 #define GL_TEXTURE_WRAP_S       0x2802
 #define GL_TEXTURE_WRAP_T       0x2803
+#define GL_TIMEOUT_IGNORED      0xFFFFFFFFFFFFFFFFull
 #define GL_TRIANGLE_STRIP       0x0005
 #define GL_TRUE                 1
 #define GL_UNSIGNED_BYTE        0x1401
 #define GL_UNSIGNED_INT         0x1405
+#define GL_UNSIGNED_SHORT       0x1403
+#define GL_UNPACK_ALIGNMENT     0x0CF5
 #define GL_VERTEX_SHADER        0x8B31
 
 #define GL_DEBUG_SOURCE_API               0x8246
@@ -64,6 +80,9 @@
 #define GL_DEBUG_OUTPUT_SYNCHRONOUS       0x8242
 #define GL_FRAMEBUFFER_SRGB               0x8DB9
 
+#define GL_SYNC_FLUSH_COMMANDS_BIT        0x00000001
+#define GL_SYNC_GPU_COMMANDS_COMPLETE     0x9117
+
 typedef char         GLchar;
 typedef float        GLfloat;
 typedef int          GLint;
@@ -73,6 +92,8 @@ typedef unsigned int GLbitfield;
 typedef unsigned int GLboolean;
 typedef unsigned int GLenum;
 typedef unsigned int GLuint;
+typedef uint64_t     GLuint64;
+typedef struct __GLsync *GLsync;
 
 #if OS_WINDOWS && ARCH_X64
 typedef signed long long int GLsizeiptr;
@@ -87,13 +108,16 @@ typedef Void (*PFNGLCLEARCOLORPROC)(GLfloat red, GLfloat green, GLfloat blue, GL
 typedef Void (*PFNGLCLEARPROC)(GLbitfield mask);
 typedef Void (*PFNGLENABLEPROC)(GLenum cap);
 typedef Void (*PFNGLSCISSORPROC)(GLint x, GLint y, GLsizei width, GLsizei height);
+typedef Void (*PFNGLPIXELSTOREIPROC)(GLenum pname, GLint param);
 #endif
 
 typedef Void   (*PFNGLATTACHSHADERPROC)(GLuint program, GLuint shader);
+typedef Void   (*PFNGLBINDBUFFERPROC)(GLenum target, GLuint buffer);
 typedef Void   (*PFNGLBINDTEXTUREUNITPROC)(GLuint unit, GLuint texture);
 typedef Void   (*PFNGLBINDVERTEXARRAYPROC)(GLuint array);
 typedef Void   (*PFNGLBLENDFUNCPROC)(GLenum sfactor, GLenum dfactor);
 typedef Void   (*PFNGLBLENDFUNCSEPARATEPROC)(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+typedef GLenum (*PFNGLCLIENTWAITSYNCPROC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
 typedef Void   (*PFNGLCOMPILESHADERPROC)(GLuint shader);
 typedef Void   (*PFNGLCREATEBUFFERSPROC)(GLsizei n, GLuint *buffers);
 typedef GLuint (*PFNGLCREATEPROGRAMPROC)(Void);
@@ -102,19 +126,24 @@ typedef Void   (*PFNGLCREATETEXTURESPROC)(GLenum target, GLsizei n, GLuint *text
 typedef Void   (*PFNGLCREATEVERTEXARRAYSPROC)(GLsizei n, GLuint *arrays);
 typedef Void   (*PFNGLDELETEPROGRAMPROC)(GLuint program);
 typedef Void   (*PFNGLDELETESHADERPROC)(GLuint shader);
+typedef Void   (*PFNGLDELETESYNCPROC)(GLsync sync);
 typedef Void   (*PFNGLDELETETEXTURESPROC)(GLsizei n, const GLuint *textures);
 typedef Void   (*PFNGLDETACHSHADERPROC)(GLuint program, GLuint shader);
 typedef Void   (*PFNGLDRAWARRAYSINSTANCEDPROC)(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
 typedef Void   (*PFNGLENABLEVERTEXARRAYATTRIBPROC)(GLuint vaobj, GLuint index);
+typedef GLsync (*PFNGLFENCESYNCPROC)(GLenum condition, GLbitfield flags);
 typedef Void   (*PFNGLGETPROGRAMINFOLOGPROC)(GLuint program, GLsizei maxLength, GLsizei *length, GLchar *infoLog);
 typedef Void   (*PFNGLGETPROGRAMIVPROC)(GLuint program, GLenum pname, GLint *params);
 typedef Void   (*PFNGLGETSHADERINFOLOGPROC)(GLuint shader, GLsizei maxLength, GLsizei *length, GLchar *infoLog);
 typedef Void   (*PFNGLGETSHADERIVPROC)(GLuint shader, GLenum pname, GLint *params);
 typedef GLint  (*PFNGLGETUNIFORMLOCATIONPROC)(GLuint program, const GLchar *name);
 typedef Void   (*PFNGLLINKPROGRAMPROC)(GLuint program);
+typedef Void  *(*PFNGLMAPNAMEDBUFFERRANGEPROC)(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access);
 typedef Void   (*PFNGLNAMEDBUFFERDATAPROC)(GLuint buffer, GLsizeiptr size, const Void *data, GLenum usage);
+typedef Void   (*PFNGLNAMEDBUFFERSTORAGEPROC)(GLuint buffer, GLsizeiptr size, const Void *data, GLbitfield flags);
 typedef Void   (*PFNGLNAMEDBUFFERSUBDATAPROC)(GLuint buffer, GLintptr offset, GLsizeiptr size, const Void *data);
 typedef Void   (*PFNGLPROGRAMUNIFORM1IPROC)(GLuint program, GLint location, GLint v0);
+typedef Void   (*PFNGLPROGRAMUNIFORM2FPROC)(GLuint program, GLint location, GLfloat v0, GLfloat v1);
 typedef Void   (*PFNGLPROGRAMUNIFORMMATRIX4FVPROC)(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value);
 typedef Void   (*PFNGLSHADERSOURCEPROC)(GLuint shader, GLsizei count, const GLchar **string, const GLint *length);
 typedef Void   (*PFNGLTEXTUREPARAMETERIPROC)(GLuint texture, GLenum pname, GLint param);
@@ -136,13 +165,16 @@ X(PFNGLCLEARCOLORPROC,                glClearColor)                \
 X(PFNGLDISABLEPROC,                   glDisable)                   \
 X(PFNGLENABLEPROC,                    glEnable)                    \
 X(PFNGLBLENDFUNCPROC,                 glBlendFunc)                 \
+X(PFNGLPIXELSTOREIPROC,               glPixelStorei)               \
 X(PFNGLVIEWPORTPROC,                  glViewport)
 
 #define GL_FUNCTIONS(X)                                            \
 X(PFNGLATTACHSHADERPROC,              glAttachShader)              \
+X(PFNGLBINDBUFFERPROC,                glBindBuffer)                \
 X(PFNGLBINDTEXTUREUNITPROC,           glBindTextureUnit)           \
 X(PFNGLBINDVERTEXARRAYPROC,           glBindVertexArray)           \
 X(PFNGLBLENDFUNCSEPARATEPROC,         glBlendFuncSeparate)         \
+X(PFNGLCLIENTWAITSYNCPROC,            glClientWaitSync)            \
 X(PFNGLCOMPILESHADERPROC,             glCompileShader)             \
 X(PFNGLCREATEBUFFERSPROC,             glCreateBuffers)             \
 X(PFNGLCREATEPROGRAMPROC,             glCreateProgram)             \
@@ -151,19 +183,24 @@ X(PFNGLCREATETEXTURESPROC,            glCreateTextures)            \
 X(PFNGLCREATEVERTEXARRAYSPROC,        glCreateVertexArrays)        \
 X(PFNGLDELETEPROGRAMPROC,             glDeleteProgram)             \
 X(PFNGLDELETESHADERPROC,              glDeleteShader)              \
+X(PFNGLDELETESYNCPROC,                glDeleteSync)                \
 X(PFNGLDELETETEXTURESPROC,            glDeleteTextures)            \
 X(PFNGLDETACHSHADERPROC,              glDetachShader)              \
 X(PFNGLDRAWARRAYSINSTANCEDPROC,       glDrawArraysInstanced)       \
 X(PFNGLENABLEVERTEXARRAYATTRIBPROC,   glEnableVertexArrayAttrib)   \
+X(PFNGLFENCESYNCPROC,                 glFenceSync)                 \
 X(PFNGLGETPROGRAMINFOLOGPROC,         glGetProgramInfoLog)         \
 X(PFNGLGETPROGRAMIVPROC,              glGetProgramiv)              \
 X(PFNGLGETSHADERINFOLOGPROC,          glGetShaderInfoLog)          \
 X(PFNGLGETSHADERIVPROC,               glGetShaderiv)               \
 X(PFNGLGETUNIFORMLOCATIONPROC,        glGetUniformLocation)        \
 X(PFNGLLINKPROGRAMPROC,               glLinkProgram)               \
+X(PFNGLMAPNAMEDBUFFERRANGEPROC,       glMapNamedBufferRange)       \
 X(PFNGLNAMEDBUFFERDATAPROC,           glNamedBufferData)           \
+X(PFNGLNAMEDBUFFERSTORAGEPROC,        glNamedBufferStorage)        \
 X(PFNGLNAMEDBUFFERSUBDATAPROC,        glNamedBufferSubData)        \
 X(PFNGLPROGRAMUNIFORM1IPROC,          glProgramUniform1i)          \
+X(PFNGLPROGRAMUNIFORM2FPROC,          glProgramUniform2f)          \
 X(PFNGLPROGRAMUNIFORMMATRIX4FVPROC,   glProgramUniformMatrix4fv)   \
 X(PFNGLSHADERSOURCEPROC,              glShaderSource)              \
 X(PFNGLTEXTUREPARAMETERIPROC,         glTextureParameteri)         \
@@ -189,6 +226,7 @@ void glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
 void glClear(GLbitfield mask);
 void glScissor(GLint x, GLint y, GLsizei width, GLsizei height);
 void glBlendFunc(GLenum sfactor, GLenum dfactor);
+void glPixelStorei(GLenum pname, GLint param);
 #endif
 
 GL_FUNCTIONS(X)
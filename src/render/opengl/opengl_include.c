@@ -115,7 +115,11 @@ internal Void opengl_debug_output(
 internal Void render_rectangle_internal(Render_Context *gfx, Render_RectangleParams *parameters) {
     Render_Batch *batch = gfx->batches.last;
 
-    if (!batch || batch->size >= RENDER_BATCH_SIZE || (batch->texture_id && batch->texture_id != parameters->texture.u32[0])) {
+    if (
+        !batch || batch->size >= RENDER_BATCH_SIZE ||
+        (batch->texture_id && batch->texture_id != parameters->texture.u32[0]) ||
+        batch->offset.x != 0.0f || batch->offset.y != 0.0f
+    ) {
         batch = arena_push_struct_zero(gfx->arena, Render_Batch);
         dll_push_back(gfx->batches.first, gfx->batches.last, batch);
     }
@@ -133,6 +137,176 @@ internal Void render_rectangle_internal(Render_Context *gfx, Render_RectanglePar
     rect->flags  = parameters->flags;
 }
 
+internal Void render_rectangles(Render_Context *gfx, Render_Texture texture, Render_Rectangle *rectangles, U32 count, V2F32 offset) {
+    Render_Rectangle *ptr = rectangles;
+    Render_Rectangle *opl = rectangles + count;
+
+    while (ptr < opl) {
+        Render_Batch *batch = gfx->batches.last;
+
+        if (
+            !batch || batch->size >= RENDER_BATCH_SIZE ||
+            (batch->texture_id && batch->texture_id != texture.u32[0]) ||
+            batch->offset.x != offset.x || batch->offset.y != offset.y
+        ) {
+            batch = arena_push_struct_zero(gfx->arena, Render_Batch);
+            dll_push_back(gfx->batches.first, gfx->batches.last, batch);
+        }
+
+        batch->texture_id = texture.u32[0];
+        batch->offset     = offset;
+
+        U32 copy_count = u32_min((U32) (opl - ptr), RENDER_BATCH_SIZE - batch->size);
+        memory_copy(&batch->rectangles[batch->size], ptr, copy_count * sizeof(Render_Rectangle));
+        batch->size += copy_count;
+        ptr         += copy_count;
+    }
+}
+
+internal B32 opengl_upload_region_merge(Render_UploadRegion *region, GLuint texture_id, V2U32 position, V2U32 size) {
+    B32 result = false;
+
+    if (region && region->texture_id == texture_id) {
+        U32 region_right  = region->position.x + region->size.width;
+        U32 region_bottom = region->position.y + region->size.height;
+
+        // NOTE(simon): Regions must fit in an upload buffer to avoid the slow
+        // path, so stop growing them once they would no longer fit.
+        U64 pixel_size      = region->format.pixel_size;
+        U64 row_merge_bytes = (U64) (region->size.width + size.width) * region->size.height * pixel_size;
+        U64 col_merge_bytes = (U64) region->size.width * (region->size.height + size.height) * pixel_size;
+
+        if (row_merge_bytes <= RENDER_UPLOAD_BUFFER_SIZE && region->position.y == position.y && region->size.height == size.height) {
+            if (position.x == region_right) {
+                region->size.width += size.width;
+                result = true;
+            } else if (position.x + size.width == region->position.x) {
+                region->position.x  = position.x;
+                region->size.width += size.width;
+                result = true;
+            }
+        } else if (col_merge_bytes <= RENDER_UPLOAD_BUFFER_SIZE && region->position.x == position.x && region->size.width == size.width) {
+            if (position.y == region_bottom) {
+                region->size.height += size.height;
+                result = true;
+            } else if (position.y + size.height == region->position.y) {
+                region->position.y   = position.y;
+                region->size.height += size.height;
+                result = true;
+            }
+        }
+    }
+
+    return result;
+}
+
+internal Void opengl_upload_region_copy(Render_UploadRegion *region, U8 *destination) {
+    U64 pixel_size       = region->format.pixel_size;
+    U64 region_row_bytes = region->size.width * pixel_size;
+
+    for (Render_Upload *upload = region->first_upload; upload; upload = upload->next) {
+        U64 row_bytes = upload->size.width * pixel_size;
+        U8 *source    = upload->data;
+        U8 *target    = destination + (upload->position.y - region->position.y) * region_row_bytes + (upload->position.x - region->position.x) * pixel_size;
+
+        for (U32 y = 0; y < upload->size.height; ++y) {
+            memory_copy(target, source, row_bytes);
+            source += row_bytes;
+            target += region_row_bytes;
+        }
+    }
+}
+
+internal Void opengl_flush_uploads(Render_Context *gfx) {
+    if (!gfx->uploads.first) {
+        return;
+    }
+
+    OpenGL_UploadBuffer *buffer = &gfx->upload_buffers[gfx->upload_buffer_index];
+    if (buffer->fence) {
+        glClientWaitSync(buffer->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(buffer->fence);
+        buffer->fence = 0;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->id);
+
+    // NOTE(simon): Regions are uploaded in order until one doesn't fit in what
+    // is left of the buffer. It and everything after it waits for the next
+    // frame, so that overlapping updates still land in the order they were
+    // made.
+    U64 offset = 0;
+    Render_UploadRegion *region = gfx->uploads.first;
+    for (; region; region = region->next) {
+        U64 region_bytes  = (U64) region->size.width * region->size.height * region->format.pixel_size;
+        U64 region_offset = u64_round_up_to_power_of_2(offset, 16);
+
+        if (region_offset + region_bytes <= RENDER_UPLOAD_BUFFER_SIZE) {
+            opengl_upload_region_copy(region, &buffer->memory[region_offset]);
+            glTextureSubImage2D(
+                region->texture_id,
+                0,
+                (GLint) region->position.x, (GLint) region->position.y,
+                (GLsizei) region->size.width, (GLsizei) region->size.height,
+                region->format.format, region->format.type,
+                pointer_from_integer(region_offset)
+            );
+            offset = region_offset + region_bytes;
+        } else if (region_bytes > RENDER_UPLOAD_BUFFER_SIZE) {
+            // NOTE(simon): Regions only grow this large from a single update
+            // that is larger than a whole buffer, which has to be uploaded
+            // directly from client memory.
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            for (Render_Upload *upload = region->first_upload; upload; upload = upload->next) {
+                glTextureSubImage2D(
+                    region->texture_id,
+                    0,
+                    (GLint) upload->position.x, (GLint) upload->position.y,
+                    (GLsizei) upload->size.width, (GLsizei) upload->size.height,
+                    region->format.format, region->format.type,
+                    upload->data
+                );
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->id);
+        } else {
+            break;
+        }
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (offset) {
+        buffer->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        gfx->upload_buffer_index = (gfx->upload_buffer_index + 1) % RENDER_UPLOAD_BUFFER_COUNT;
+    }
+
+    // NOTE(simon): Move the regions that are left to the spare arena, each
+    // collapsed into a single update, and swap the arenas.
+    Render_UploadRegionList remaining = { 0 };
+    for (Render_UploadRegion *next = 0; region; region = next) {
+        next = region->next;
+
+        Render_UploadRegion *moved = arena_push_struct_zero(gfx->upload_spare_arena, Render_UploadRegion);
+        Render_Upload       *upload = arena_push_struct_zero(gfx->upload_spare_arena, Render_Upload);
+        U64 region_bytes = (U64) region->size.width * region->size.height * region->format.pixel_size;
+        upload->position = region->position;
+        upload->size     = region->size;
+        upload->data     = arena_push_array(gfx->upload_spare_arena, U8, region_bytes);
+        opengl_upload_region_copy(region, upload->data);
+
+        moved->texture_id = region->texture_id;
+        moved->format     = region->format;
+        moved->position   = region->position;
+        moved->size       = region->size;
+        sll_queue_push(moved->first_upload, moved->last_upload, upload);
+        dll_push_back(remaining.first, remaining.last, moved);
+    }
+
+    arena_reset(gfx->upload_arena);
+    swap(gfx->upload_arena, gfx->upload_spare_arena, Arena *);
+    gfx->uploads = remaining;
+}
+
 internal Void render_begin(Render_Context *gfx, V2U32 resolution) {
     gfx->frame_restore = arena_begin_temporary(gfx->arena);
 
@@ -143,12 +317,15 @@ internal Void render_begin(Render_Context *gfx, V2U32 resolution) {
 }
 
 internal Void render_end(Render_Context *gfx) {
+    opengl_flush_uploads(gfx);
+
     glProgramUniform1i(gfx->program, gfx->uniform_sampler_location, 0);
 
     glClear(GL_COLOR_BUFFER_BIT);
 
     for (Render_Batch *batch = gfx->batches.first; batch; batch = batch->next) {
         glBindTextureUnit(0, batch->texture_id);
+        glProgramUniform2f(gfx->program, gfx->uniform_offset_location, batch->offset.x, batch->offset.y);
         glNamedBufferSubData(gfx->vbo, 0, batch->size * sizeof(Render_Rectangle), batch->rectangles);
         glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei) batch->size);
     }
@@ -160,26 +337,53 @@ internal Void render_end(Render_Context *gfx) {
     gfx_swap_buffers(gfx->gfx);
 }
 
-internal Render_Texture render_texture_create(Render_Context *gfx, V2U32 size, U8 *data) {
+internal OpenGL_TextureFormat opengl_texture_format_from_render_format(Render_TextureFormat format) {
+    local OpenGL_TextureFormat formats[] = {
+        [Render_TextureFormat_RGBA8]   = { GL_RGBA8,   GL_RGBA, GL_UNSIGNED_BYTE,  4 },
+        [Render_TextureFormat_RGB8]    = { GL_RGB8,    GL_RGB,  GL_UNSIGNED_BYTE,  3 },
+        [Render_TextureFormat_RGB16]   = { GL_RGB16,   GL_RGB,  GL_UNSIGNED_SHORT, 6 },
+        [Render_TextureFormat_RGB16F]  = { GL_RGB16F,  GL_RGB,  GL_HALF_FLOAT,     6 },
+        [Render_TextureFormat_RGBA16]  = { GL_RGBA16,  GL_RGBA, GL_UNSIGNED_SHORT, 8 },
+        [Render_TextureFormat_RGBA16F] = { GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT,     8 },
+        [Render_TextureFormat_R8]      = { GL_R8,      GL_RED,  GL_UNSIGNED_BYTE,  1 },
+    };
+
+    OpenGL_TextureFormat result = formats[Render_TextureFormat_RGBA8];
+    if (format < array_count(formats)) {
+        result = formats[format];
+    }
+    return result;
+}
+
+internal Render_Texture render_texture_create(Render_Context *gfx, V2U32 size, Render_TextureFormat format, U8 *data) {
     Render_Texture result = { 0 };
+    OpenGL_TextureFormat gl_format = opengl_texture_format_from_render_format(format);
 
     glCreateTextures(GL_TEXTURE_2D, 1, &result.u32[0]);
     result.u32[1] = size.width;
     result.u32[2] = size.height;
+    result.u32[3] = format;
 
-    glTextureStorage2D(result.u32[0], 1, GL_RGBA8, (GLsizei) size.width, (GLsizei) size.height);
+    glTextureStorage2D(result.u32[0], 1, gl_format.internal_format, (GLsizei) size.width, (GLsizei) size.height);
     glTextureParameteri(result.u32[0], GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTextureParameteri(result.u32[0], GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTextureParameteri(result.u32[0], GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTextureParameteri(result.u32[0], GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     if (data) {
-        glTextureSubImage2D(result.u32[0], 0, 0, 0, (GLsizei) size.width, (GLsizei) size.height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        glTextureSubImage2D(result.u32[0], 0, 0, 0, (GLsizei) size.width, (GLsizei) size.height, gl_format.format, gl_format.type, data);
     }
 
     return result;
 }
 
 internal Void render_texture_destroy(Render_Context *gfx, Render_Texture texture) {
+    for (Render_UploadRegion *region = gfx->uploads.first, *next = 0; region; region = next) {
+        next = region->next;
+        if (region->texture_id == texture.u32[0]) {
+            dll_remove(gfx->uploads.first, gfx->uploads.last, region);
+        }
+    }
+
     glDeleteTextures(1, &texture.u32[0]);
 }
 
@@ -191,14 +395,29 @@ internal V2U32 render_size_from_texture(Render_Texture texture) {
 }
 
 internal Void render_texture_update(Render_Context *gfx, Render_Texture texture, V2U32 position, V2U32 size, U8 *data) {
-    glTextureSubImage2D(
-        texture.u32[0],
-        0,
-        (GLint) position.x, (GLint) position.y,
-        (GLsizei) size.width, (GLsizei) size.height,
-        GL_RGBA, GL_UNSIGNED_BYTE,
-        data
-    );
+    OpenGL_TextureFormat gl_format = opengl_texture_format_from_render_format((Render_TextureFormat) texture.u32[3]);
+
+    // NOTE(simon): The caller is free to reuse its memory once we return, so
+    // keep a copy until the upload happens.
+    Render_Upload *upload = arena_push_struct_zero(gfx->upload_arena, Render_Upload);
+    U64 data_size = (U64) size.width * size.height * gl_format.pixel_size;
+    upload->position = position;
+    upload->size     = size;
+    upload->data     = arena_push_array(gfx->upload_arena, U8, data_size);
+    memory_copy(upload->data, data, data_size);
+
+    // NOTE(simon): Atlases are filled in order, so only the most recent region
+    // is checked for adjacency.
+    Render_UploadRegion *region = gfx->uploads.last;
+    if (!opengl_upload_region_merge(region, texture.u32[0], position, size)) {
+        region = arena_push_struct_zero(gfx->upload_arena, Render_UploadRegion);
+        region->texture_id = texture.u32[0];
+        region->format     = gl_format;
+        region->position   = position;
+        region->size       = size;
+        dll_push_back(gfx->uploads.first, gfx->uploads.last, region);
+    }
+    sll_queue_push(region->first_upload, region->last_upload, upload);
 }
 
 internal Render_Context *render_create(Gfx_Context *gfx) {
@@ -206,12 +425,17 @@ internal Render_Context *render_create(Gfx_Context *gfx) {
     Render_Context *result = arena_push_struct_zero(arena, Render_Context);
     result->arena = arena;
     result->gfx = gfx;
+    result->upload_arena       = arena_create();
+    result->upload_spare_arena = arena_create();
     opengl_backend_init(gfx);
 
     glDebugMessageCallback(&opengl_debug_output, NULL);
     glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
     glEnable(GL_FRAMEBUFFER_SRGB);
 
+    // NOTE(simon): Rows of RGB textures are not 4 byte aligned.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
     GLuint shaders[] = {
         opengl_create_shader(str8_literal("src/render/opengl/shader.vert"), GL_VERTEX_SHADER),
         opengl_create_shader(str8_literal("src/render/opengl/shader.frag"), GL_FRAGMENT_SHADER),
@@ -219,11 +443,20 @@ internal Render_Context *render_create(Gfx_Context *gfx) {
     result->program = opengl_create_program(shaders, array_count(shaders));
 
     result->uniform_projection_location = glGetUniformLocation(result->program, "uniform_projection");
+    result->uniform_offset_location     = glGetUniformLocation(result->program, "uniform_offset");
     result->uniform_sampler_location    = glGetUniformLocation(result->program, "uniform_sampler");
 
     glCreateBuffers(1, &result->vbo);
     glNamedBufferData(result->vbo, RENDER_BATCH_SIZE * sizeof(Render_Rectangle), 0, GL_DYNAMIC_DRAW);
 
+    GLbitfield upload_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    for (U32 i = 0; i < RENDER_UPLOAD_BUFFER_COUNT; ++i) {
+        OpenGL_UploadBuffer *buffer = &result->upload_buffers[i];
+        glCreateBuffers(1, &buffer->id);
+        glNamedBufferStorage(buffer->id, RENDER_UPLOAD_BUFFER_SIZE, 0, upload_flags);
+        buffer->memory = (U8 *) glMapNamedBufferRange(buffer->id, 0, RENDER_UPLOAD_BUFFER_SIZE, upload_flags);
+    }
+
     glCreateVertexArrays(1, &result->vao);
 
     opengl_vertex_array_instance_attribute_float(result->vao,   0, 2, GL_FLOAT,        GL_FALSE, member_offset(Render_Rectangle, min),    0);
@@ -9,27 +9,64 @@
 
 #define RENDER_BATCH_SIZE 1024
 
-typedef enum {
-    Render_RectangleFlags_Texture = 1 << 0,
-    Render_RectangleFlags_MSDF    = 1 << 1,
-} Render_RectangleFlags;
-
-typedef struct Render_Rectangle Render_Rectangle;
-struct Render_Rectangle {
-    V2F32 min;
-    V2F32 max;
-    V4F32 color;
-    V2F32 uv_min;
-    V2F32 uv_max;
-    U32   flags;
+// NOTE(simon): Texture updates are queued and uploaded together at the end of
+// the frame from one of several persistently mapped pixel buffers. A buffer
+// is only written again once the GPU has signaled that it is done reading
+// from it, so the CPU never waits on the upload it just made. Updates that
+// don't fit in this frame's buffer wait for the next frame's.
+#define RENDER_UPLOAD_BUFFER_COUNT 3
+#define RENDER_UPLOAD_BUFFER_SIZE  megabytes(4)
+
+typedef struct {
+    GLenum internal_format;
+    GLenum format;
+    GLenum type;
+    U32    pixel_size;
+} OpenGL_TextureFormat;
+
+typedef struct Render_Upload Render_Upload;
+struct Render_Upload {
+    Render_Upload *next;
+    V2U32 position;
+    V2U32 size;
+    U8   *data; // NOTE(simon): A copy with tightly packed rows.
+};
+
+// NOTE(simon): A rectangle of a texture that is covered by one or more
+// adjacent updates, which is uploaded with a single call.
+typedef struct Render_UploadRegion Render_UploadRegion;
+struct Render_UploadRegion {
+    Render_UploadRegion *next;
+    Render_UploadRegion *previous;
+
+    GLuint               texture_id;
+    OpenGL_TextureFormat format;
+    V2U32                position;
+    V2U32                size;
+
+    Render_Upload *first_upload;
+    Render_Upload *last_upload;
+};
+
+typedef struct Render_UploadRegionList Render_UploadRegionList;
+struct Render_UploadRegionList {
+    Render_UploadRegion *first;
+    Render_UploadRegion *last;
 };
 
+typedef struct {
+    GLuint  id;
+    U8     *memory;
+    GLsync  fence;
+} OpenGL_UploadBuffer;
+
 typedef struct Render_Batch Render_Batch;
 struct Render_Batch {
     Render_Batch *next;
     Render_Batch *previous;
 
     GLuint texture_id;
+    V2F32  offset;
     U32 size;
     Render_Rectangle rectangles[RENDER_BATCH_SIZE];
 };
@@ -41,15 +78,24 @@ struct Render_BatchList {
 };
 
 struct Render_Context {
-    Arena           *arena;
-    Arena_Temporary  frame_restore;
-    Render_BatchList batches;
-    GLuint           program;
-    GLuint           vao;
-    GLuint           vbo;
-    GLint            uniform_projection_location;
-    GLint            uniform_sampler_location;
-    Gfx_Context     *gfx;
+    Arena                  *arena;
+    Arena_Temporary         frame_restore;
+    Render_BatchList        batches;
+    GLuint                  program;
+    GLuint                  vao;
+    GLuint                  vbo;
+    GLint                   uniform_projection_location;
+    GLint                   uniform_offset_location;
+    GLint                   uniform_sampler_location;
+    Gfx_Context            *gfx;
+
+    // NOTE(simon): Queued texture updates. Regions left over after an upload
+    // are moved to the spare arena, which then takes the place of the other.
+    Arena                  *upload_arena;
+    Arena                  *upload_spare_arena;
+    Render_UploadRegionList uploads;
+    OpenGL_UploadBuffer     upload_buffers[RENDER_UPLOAD_BUFFER_COUNT];
+    U32                     upload_buffer_index;
 };
 
 #endif // OPENGL_INCLUDE_H
@@ -2,6 +2,7 @@
 
 #define Render_RectangleFlags_Texture (1 << 0)
 #define Render_RectangleFlags_MSDF    (1 << 1)
+#define Render_RectangleFlags_SDF     (1 << 2)
 
 in      vec4 vert_color;
 in      vec2 vert_uv;
@@ -10,6 +11,7 @@ in flat uint vert_flags;
 out vec4 frag_color;
 
 uniform mat4      uniform_projection;
+uniform vec2      uniform_offset;
 uniform sampler2D uniform_sampler;
 
 float median_of_3(float a, float b, float c) {
@@ -26,6 +28,10 @@ void main() {
         vec4 msdf_sample = texture(uniform_sampler, vert_uv);
         float distance = median_of_3(msdf_sample.r, msdf_sample.g, msdf_sample.b) - 0.5;
 
+        alpha = clamp(distance / fwidth(distance) + 0.5, 0.0, 1.0);
+    } else if ((vert_flags & Render_RectangleFlags_SDF) != 0) {
+        float distance = texture(uniform_sampler, vert_uv).r - 0.5;
+
         alpha = clamp(distance / fwidth(distance) + 0.5, 0.0, 1.0);
     }
 
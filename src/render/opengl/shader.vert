@@ -12,6 +12,7 @@ out      vec2 vert_uv;
 out flat uint vert_flags;
 
 uniform mat4      uniform_projection;
+uniform vec2      uniform_offset;
 uniform sampler2D uniform_sampler;
 
 const vec2 verticies[] = {
@@ -24,7 +25,7 @@ const vec2 verticies[] = {
 void main() {
     vec2 center       = 0.5 * (instance_max + instance_min);
     vec2 half_size    = 0.5 * (instance_max - instance_min);
-    vec2 position     = center + half_size * verticies[gl_VertexID];
+    vec2 position     = uniform_offset + center + half_size * verticies[gl_VertexID];
     vec2 uv_center    = 0.5 * (instance_uv_max + instance_uv_min);
     vec2 uv_half_size = 0.5 * (instance_uv_max - instance_uv_min);
     vec2 uv           = uv_center + uv_half_size * verticies[gl_VertexID];
@@ -0,0 +1,24 @@
+#ifndef RENDER_CORE_H
+#define RENDER_CORE_H
+
+// NOTE(simon): Types shared by all renderer backends.
+
+typedef enum {
+    Render_RectangleFlags_Texture = 1 << 0,
+    Render_RectangleFlags_MSDF    = 1 << 1,
+    // NOTE(simon): A single channel distance field in red, such as one
+    // generated with MSDF_Mode_SDF.
+    Render_RectangleFlags_SDF     = 1 << 2,
+} Render_RectangleFlags;
+
+typedef struct Render_Rectangle Render_Rectangle;
+struct Render_Rectangle {
+    V2F32 min;
+    V2F32 max;
+    V4F32 color;
+    V2F32 uv_min;
+    V2F32 uv_max;
+    U32   flags;
+};
+
+#endif // RENDER_CORE_H
@@ -1 +1,2 @@
 #include "opengl/opengl_include.c"
+#include "software/software_include.c"
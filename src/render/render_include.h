@@ -1,10 +1,23 @@
 #ifndef RENDER_INCLUDE_H
 #define RENDER_INCLUDE_H
 
+#include "render_core.h"
 #include "opengl/opengl_include.h"
+#include "software/software_include.h"
 
 typedef struct Render_Context Render_Context;
 
+typedef enum {
+    Render_TextureFormat_RGBA8,
+    Render_TextureFormat_RGB8,
+    Render_TextureFormat_RGB16,
+    Render_TextureFormat_RGB16F,
+    Render_TextureFormat_RGBA16,
+    Render_TextureFormat_RGBA16F,
+    Render_TextureFormat_R8,
+    Render_TextureFormat_COUNT,
+} Render_TextureFormat;
+
 typedef union Render_Texture Render_Texture;
 union Render_Texture {
     U32 u32[4];
@@ -16,7 +29,7 @@ internal Render_Context *render_create(Gfx_Context *gfx);
 internal Void render_begin(Render_Context *gfx, V2U32 resolution);
 internal Void render_end(Render_Context *gfx);
 
-internal Render_Texture render_texture_create(Render_Context *gfx, V2U32 size, U8 *data);
+internal Render_Texture render_texture_create(Render_Context *gfx, V2U32 size, Render_TextureFormat format, U8 *data);
 internal Void           render_texture_destroy(Render_Context *gfx, Render_Texture texture);
 internal Void           render_texture_update(Render_Context *gfx, Render_Texture texture, V2U32 position, V2U32 size, U8 *data);
 internal V2U32          render_size_from_texture(Render_Texture texture);
@@ -34,4 +47,9 @@ struct Render_RectangleParams {
 #define render_rectangle(gfx, minimum, maximum, ...) render_rectangle_internal(gfx, &(Render_RectangleParams) { .min = minimum, .max = maximum, .color = v4f32(1.0f, 1.0f, 1.0f, 1.0f), __VA_ARGS__ })
 internal Void render_rectangle_internal(Render_Context *gfx, Render_RectangleParams *parameters);
 
+// NOTE(simon): Submits an array of prebuilt rectangles with a single block
+// copy. The offset is applied when drawing, so the rectangles can be kept
+// around and submitted as-is every frame.
+internal Void render_rectangles(Render_Context *gfx, Render_Texture texture, Render_Rectangle *rectangles, U32 count, V2F32 offset);
+
 #endif // RENDER_INCLUDE_H
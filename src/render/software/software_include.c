@@ -0,0 +1,239 @@
+global F32 software_srgb_to_linear_table[256];
+global U8  software_linear_to_srgb_table[SOFTWARE_LINEAR_TO_SRGB_TABLE_SIZE];
+global B32 software_tables_initialized;
+
+internal Void software_initialize_tables(Void) {
+    if (software_tables_initialized) {
+        return;
+    }
+
+    for (U32 i = 0; i < array_count(software_srgb_to_linear_table); ++i) {
+        F32 srgb = (F32) i / 255.0f;
+        software_srgb_to_linear_table[i] = (srgb <= 0.04045f ? srgb / 12.92f : f32_pow((srgb + 0.055f) / 1.055f, 2.4f));
+    }
+
+    for (U32 i = 0; i < array_count(software_linear_to_srgb_table); ++i) {
+        F32 linear = (F32) i / (F32) (SOFTWARE_LINEAR_TO_SRGB_TABLE_SIZE - 1);
+        F32 srgb   = (linear <= 0.0031308f ? linear * 12.92f : 1.055f * f32_pow(linear, 1.0f / 2.4f) - 0.055f);
+        software_linear_to_srgb_table[i] = (U8) f32_round_to_u32(f32_min(f32_max(srgb, 0.0f), 1.0f) * 255.0f);
+    }
+
+    software_tables_initialized = true;
+}
+
+internal F32 software_clamp_01(F32 x) {
+    return f32_min(f32_max(x, 0.0f), 1.0f);
+}
+
+internal U8 software_srgb_from_linear(F32 linear) {
+    U32 index = (U32) (software_clamp_01(linear) * (F32) (SOFTWARE_LINEAR_TO_SRGB_TABLE_SIZE - 1) + 0.5f);
+    return software_linear_to_srgb_table[index];
+}
+
+internal F32 software_median_of_3(F32 a, F32 b, F32 c) {
+    return f32_max(f32_min(a, b), f32_min(f32_max(a, b), c));
+}
+
+internal Software_Image software_image_create(Arena *arena, V2U32 size) {
+    Software_Image result = { 0 };
+    result.width  = size.width;
+    result.height = size.height;
+    result.pixels = arena_push_array_zero(arena, U8, (U64) size.width * size.height * 4);
+    return result;
+}
+
+internal Void software_image_clear(Software_Image *image, V4F32 color) {
+    software_initialize_tables();
+
+    U8 clear[4] = {
+        software_srgb_from_linear(color.x),
+        software_srgb_from_linear(color.y),
+        software_srgb_from_linear(color.z),
+        (U8) f32_round_to_u32(software_clamp_01(color.w) * 255.0f),
+    };
+
+    U8 *ptr = image->pixels;
+    U8 *opl = image->pixels + (U64) image->width * image->height * 4;
+    for (; ptr < opl; ptr += 4) {
+        memory_copy(ptr, clear, sizeof(clear));
+    }
+}
+
+// NOTE(simon): Matches GL_LINEAR filtering with GL_CLAMP_TO_EDGE.
+internal V4F32 software_sample_bilinear(Software_Texture *texture, F32 u, F32 v) {
+    F32 x = u * (F32) texture->width  - 0.5f;
+    F32 y = v * (F32) texture->height - 0.5f;
+    F32 x_floor = f32_floor(x);
+    F32 y_floor = f32_floor(y);
+    F32 x_fraction = x - x_floor;
+    F32 y_fraction = y - y_floor;
+
+    S32 x_last = (S32) texture->width  - 1;
+    S32 y_last = (S32) texture->height - 1;
+    S32 x0 = s32_min(s32_max((S32) x_floor,     0), x_last);
+    S32 x1 = s32_min(s32_max((S32) x_floor + 1, 0), x_last);
+    S32 y0 = s32_min(s32_max((S32) y_floor,     0), y_last);
+    S32 y1 = s32_min(s32_max((S32) y_floor + 1, 0), y_last);
+
+    U8 *row0 = texture->data + (U64) y0 * texture->width * 4;
+    U8 *row1 = texture->data + (U64) y1 * texture->width * 4;
+
+    V4F32 result = { 0 };
+#if ARCH_X64
+    S32 texel00 = 0, texel10 = 0, texel01 = 0, texel11 = 0;
+    memory_copy(&texel00, &row0[x0 * 4], sizeof(texel00));
+    memory_copy(&texel10, &row0[x1 * 4], sizeof(texel10));
+    memory_copy(&texel01, &row1[x0 * 4], sizeof(texel01));
+    memory_copy(&texel11, &row1[x1 * 4], sizeof(texel11));
+
+    // NOTE(simon): Widen both texels of a row to 16 bits, then each texel to
+    // 32 bits and floats.
+    __m128i zero   = _mm_setzero_si128();
+    __m128i top    = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(texel00), _mm_cvtsi32_si128(texel10)), zero);
+    __m128i bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(texel01), _mm_cvtsi32_si128(texel11)), zero);
+
+    __m128 a = _mm_cvtepi32_ps(_mm_unpacklo_epi16(top,    zero));
+    __m128 b = _mm_cvtepi32_ps(_mm_unpackhi_epi16(top,    zero));
+    __m128 c = _mm_cvtepi32_ps(_mm_unpacklo_epi16(bottom, zero));
+    __m128 d = _mm_cvtepi32_ps(_mm_unpackhi_epi16(bottom, zero));
+
+    __m128 tx = _mm_set1_ps(x_fraction);
+    __m128 ty = _mm_set1_ps(y_fraction);
+    __m128 ab = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), tx));
+    __m128 cd = _mm_add_ps(c, _mm_mul_ps(_mm_sub_ps(d, c), tx));
+    __m128 abcd = _mm_add_ps(ab, _mm_mul_ps(_mm_sub_ps(cd, ab), ty));
+
+    _mm_storeu_ps(&result.x, _mm_mul_ps(abcd, _mm_set1_ps(1.0f / 255.0f)));
+#else
+    F32 *components = &result.x;
+    for (U32 i = 0; i < 4; ++i) {
+        F32 ab = f32_lerp((F32) row0[x0 * 4 + i], (F32) row0[x1 * 4 + i], x_fraction);
+        F32 cd = f32_lerp((F32) row1[x0 * 4 + i], (F32) row1[x1 * 4 + i], x_fraction);
+        components[i] = f32_lerp(ab, cd, y_fraction) * (1.0f / 255.0f);
+    }
+#endif
+
+    return result;
+}
+
+internal Void software_blend_pixel(U8 *pixel, V4F32 color) {
+    F32 alpha   = software_clamp_01(color.w);
+    F32 inverse = 1.0f - alpha;
+
+    F32 red   = software_clamp_01(color.x) * alpha + software_srgb_to_linear_table[pixel[0]] * inverse;
+    F32 green = software_clamp_01(color.y) * alpha + software_srgb_to_linear_table[pixel[1]] * inverse;
+    F32 blue  = software_clamp_01(color.z) * alpha + software_srgb_to_linear_table[pixel[2]] * inverse;
+    F32 destination_alpha = alpha * alpha + ((F32) pixel[3] / 255.0f) * inverse;
+
+    pixel[0] = software_srgb_from_linear(red);
+    pixel[1] = software_srgb_from_linear(green);
+    pixel[2] = software_srgb_from_linear(blue);
+    pixel[3] = (U8) f32_round_to_u32(destination_alpha * 255.0f);
+}
+
+// NOTE(simon): MSDF takes the median of the color channels, and SDF only
+// uses red.
+internal Void software_distance_row(Software_Texture *texture, U32 flags, F32 *distances, U32 count, F32 u, F32 u_step, F32 v) {
+    for (U32 i = 0; i < count; ++i) {
+        V4F32 sample = software_sample_bilinear(texture, u + (F32) i * u_step, v);
+        if (flags & Render_RectangleFlags_MSDF) {
+            distances[i] = software_median_of_3(sample.x, sample.y, sample.z) - 0.5f;
+        } else {
+            distances[i] = sample.x - 0.5f;
+        }
+    }
+}
+
+internal Void software_render_band(Void *data, U32 band_index) {
+    Software_RenderTask *task    = (Software_RenderTask *) data;
+    Software_Image      *image   = task->image;
+    Software_Texture    *texture = &task->texture;
+
+    S32 band_min = (S32) (band_index * SOFTWARE_BAND_HEIGHT);
+    S32 band_max = s32_min(band_min + SOFTWARE_BAND_HEIGHT, (S32) image->height);
+
+    for (U32 rectangle_index = 0; rectangle_index < task->rectangle_count; ++rectangle_index) {
+        Render_Rectangle *rectangle = &task->rectangles[rectangle_index];
+        V2F32 min = v2f32_add(rectangle->min, task->offset);
+        V2F32 max = v2f32_add(rectangle->max, task->offset);
+
+        if (max.x <= min.x || max.y <= min.y) {
+            continue;
+        }
+
+        // NOTE(simon): Pixels are covered when their center is inside the
+        // rectangle.
+        S32 x_min = s32_max((S32) f32_ceil(min.x - 0.5f), 0);
+        S32 x_max = s32_min((S32) f32_ceil(max.x - 0.5f), (S32) image->width);
+        S32 y_min = s32_max((S32) f32_ceil(min.y - 0.5f), band_min);
+        S32 y_max = s32_min((S32) f32_ceil(max.y - 0.5f), band_max);
+        if (x_min >= x_max || y_min >= y_max) {
+            continue;
+        }
+
+        F32 u_step  = (rectangle->uv_max.x - rectangle->uv_min.x) / (max.x - min.x);
+        F32 v_step  = (rectangle->uv_max.y - rectangle->uv_min.y) / (max.y - min.y);
+        F32 u_start = rectangle->uv_min.x + ((F32) x_min + 0.5f - min.x) * u_step;
+        F32 v_start = rectangle->uv_min.y + ((F32) y_min + 0.5f - min.y) * v_step;
+        U32 width   = (U32) (x_max - x_min);
+        V4F32 color = rectangle->color;
+
+        if (rectangle->flags & Render_RectangleFlags_Texture) {
+            for (S32 y = y_min; y < y_max; ++y) {
+                U8 *pixel = image->pixels + ((U64) y * image->width + (U64) x_min) * 4;
+                F32 v = v_start + (F32) (y - y_min) * v_step;
+
+                for (U32 i = 0; i < width; ++i, pixel += 4) {
+                    V4F32 sample = software_sample_bilinear(texture, u_start + (F32) i * u_step, v);
+                    software_blend_pixel(pixel, v4f32(sample.x * color.x, sample.y * color.y, sample.z * color.z, color.w));
+                }
+            }
+        } else if (rectangle->flags & (Render_RectangleFlags_MSDF | Render_RectangleFlags_SDF)) {
+            // NOTE(simon): fwidth is emulated with forward differences, so we
+            // need the distance one pixel to the right and one row above.
+            // Keep two rows of distances and slide them upwards.
+            Arena_Temporary scratch = arena_get_scratch(0, 0);
+            F32 *current = arena_push_array(scratch.arena, F32, width + 1);
+            F32 *next    = arena_push_array(scratch.arena, F32, width + 1);
+
+            software_distance_row(texture, rectangle->flags, current, width + 1, u_start, u_step, v_start);
+            for (S32 y = y_min; y < y_max; ++y) {
+                U8 *pixel = image->pixels + ((U64) y * image->width + (U64) x_min) * 4;
+                F32 v = v_start + (F32) (y + 1 - y_min) * v_step;
+                software_distance_row(texture, rectangle->flags, next, width + 1, u_start, u_step, v);
+
+                for (U32 i = 0; i < width; ++i, pixel += 4) {
+                    F32 distance = current[i];
+                    F32 width_of_distance = f32_abs(current[i + 1] - distance) + f32_abs(next[i] - distance);
+                    F32 alpha = software_clamp_01(distance / f32_max(width_of_distance, 1e-30f) + 0.5f);
+                    software_blend_pixel(pixel, v4f32(color.x, color.y, color.z, color.w * alpha));
+                }
+
+                swap(current, next, F32 *);
+            }
+
+            arena_end_temporary(scratch);
+        } else {
+            for (S32 y = y_min; y < y_max; ++y) {
+                U8 *pixel = image->pixels + ((U64) y * image->width + (U64) x_min) * 4;
+                for (U32 i = 0; i < width; ++i, pixel += 4) {
+                    software_blend_pixel(pixel, color);
+                }
+            }
+        }
+    }
+}
+
+internal Void software_render_rectangles(ThreadPool *pool, Software_Image *image, Software_Texture texture, Render_Rectangle *rectangles, U32 count, V2F32 offset) {
+    software_initialize_tables();
+
+    Software_RenderTask task = { 0 };
+    task.image           = image;
+    task.texture         = texture;
+    task.rectangles      = rectangles;
+    task.rectangle_count = count;
+    task.offset          = offset;
+
+    U32 band_count = (image->height + SOFTWARE_BAND_HEIGHT - 1) / SOFTWARE_BAND_HEIGHT;
+    thread_pool_run(pool, software_render_band, &task, band_count);
+}
@@ -0,0 +1,52 @@
+#ifndef SOFTWARE_INCLUDE_H
+#define SOFTWARE_INCLUDE_H
+
+// NOTE(simon): CPU reference implementation of shader.vert and shader.frag
+// that renders into images in memory. It only depends on base and
+// render_core.h so that it can be used without a window or a GL context.
+
+#if ARCH_X64
+#include <emmintrin.h>
+#endif
+
+// NOTE(simon): Rows are split into bands of this height that are rendered in
+// parallel. Bands don't overlap, so rectangles are still blended in order.
+#define SOFTWARE_BAND_HEIGHT 16
+
+#define SOFTWARE_LINEAR_TO_SRGB_TABLE_SIZE 16384
+
+typedef struct {
+    U32 width;
+    U32 height;
+    U8 *data; // NOTE(simon): RGBA8, tightly packed. SDFs are read from red.
+} Software_Texture;
+
+// NOTE(simon): RGBA8 with sRGB encoded color, which matches the GL
+// framebuffer with GL_FRAMEBUFFER_SRGB enabled. Row 0 is the bottom row, the
+// same as for glReadPixels.
+typedef struct {
+    U32 width;
+    U32 height;
+    U8 *pixels;
+} Software_Image;
+
+typedef struct {
+    Software_Image   *image;
+    Software_Texture  texture;
+    Render_Rectangle *rectangles;
+    U32               rectangle_count;
+    V2F32             offset;
+} Software_RenderTask;
+
+internal Software_Image software_image_create(Arena *arena, V2U32 size);
+internal Void           software_image_clear(Software_Image *image, V4F32 color);
+
+internal V4F32 software_sample_bilinear(Software_Texture *texture, F32 u, F32 v);
+
+internal Void software_render_band(Void *data, U32 band_index);
+
+// NOTE(simon): Draws rectangles the same way as render_rectangles. Passing a
+// null pool renders on the calling thread.
+internal Void software_render_rectangles(ThreadPool *pool, Software_Image *image, Software_Texture texture, Render_Rectangle *rectangles, U32 count, V2F32 offset);
+
+#endif // SOFTWARE_INCLUDE_H